@@ -17,6 +17,7 @@
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/PlatformEnvironment.h>
 #include <openrct2/audio/AudioContext.h>
+#include <openrct2/audio/AudioMixer.h>
 #include <openrct2/cmdline/CommandLine.hpp>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ui/UiContext.h>
@@ -41,6 +42,7 @@ int main(int argc, const char** argv)
 {
     std::unique_ptr<IContext> context;
     int32_t rc = EXIT_SUCCESS;
+    gMixerBenchmark = AudioMixer::RunBenchmark;
     int runGame = cmdline_run(argv, argc);
     core_init();
     RegisterBitmapReader();
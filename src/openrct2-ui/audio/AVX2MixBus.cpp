@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MixBus.h"
+
+#include <openrct2/core/Guard.hpp>
+
+#ifdef __AVX2__
+
+#    include <immintrin.h>
+
+namespace OpenRCT2::Audio
+{
+    void MixAccumulateS16AVX2(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain)
+    {
+        const __m256 panBase = _mm256_setr_ps(
+            gain.PanLeft, gain.PanRight, gain.PanLeft, gain.PanRight, gain.PanLeft, gain.PanRight, gain.PanLeft, gain.PanRight);
+        const __m256 panStep = _mm256_setr_ps(
+            gain.PanLeftStep, gain.PanRightStep, gain.PanLeftStep, gain.PanRightStep, gain.PanLeftStep, gain.PanRightStep,
+            gain.PanLeftStep, gain.PanRightStep);
+        const __m256 volumeBase = _mm256_set1_ps(gain.Volume);
+        const __m256 volumeStep = _mm256_set1_ps(gain.VolumeStep);
+        const __m256 frameInc = _mm256_set1_ps(4.0f);
+        const __m256 indexInc = _mm256_set1_ps(8.0f);
+        __m256 frame = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+        __m256 index = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i samples16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m256 samples = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples16));
+            const __m256 pan = _mm256_add_ps(panBase, _mm256_mul_ps(frame, panStep));
+            const __m256 volume = _mm256_add_ps(volumeBase, _mm256_mul_ps(index, volumeStep));
+            const __m256 mixed = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(samples, _mm256_mul_ps(pan, volume)));
+            _mm256_storeu_ps(dst + i, mixed);
+            frame = _mm256_add_ps(frame, frameInc);
+            index = _mm256_add_ps(index, indexInc);
+        }
+        for (; i < count; i++)
+        {
+            dst[i] += static_cast<float>(src[i]) * MixGainAt(gain, i);
+        }
+    }
+
+    void MixStoreS16AVX2(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count)
+    {
+        const __m256 lo = _mm256_set1_ps(-32768.0f);
+        const __m256 hi = _mm256_set1_ps(32767.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), lo), hi);
+            const __m256i converted = _mm256_cvttps_epi32(clamped);
+            const __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(converted), _mm256_extracti128_si256(converted, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+        MixStoreS16Scalar(dst + i, src + i, count - i);
+    }
+} // namespace OpenRCT2::Audio
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with AVX2 enabled, when targeting x86!
+#    endif
+
+namespace OpenRCT2::Audio
+{
+    void MixAccumulateS16AVX2(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain)
+    {
+        openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+    }
+
+    void MixStoreS16AVX2(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count)
+    {
+        openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+    }
+} // namespace OpenRCT2::Audio
+
+#endif // __AVX2__
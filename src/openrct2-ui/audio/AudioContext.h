@@ -14,6 +14,7 @@
 #include <openrct2/audio/AudioSource.h>
 #include <openrct2/common.h>
 #include <string>
+#include <vector>
 
 struct SDL_RWops;
 using SpeexResamplerState = struct SpeexResamplerState_;
@@ -64,6 +65,9 @@ namespace OpenRCT2::Audio
     {
         IAudioSource* CreateMemoryFromCSS1(const std::string& path, size_t index, const AudioFormat* targetFormat = nullptr);
         IAudioSource* CreateMemoryFromWAV(const std::string& path, const AudioFormat* targetFormat = nullptr);
+        IAudioSource* CreateMemoryFromPCM(std::vector<uint8_t>&& data, const AudioFormat& format);
+        IAudioSource* CreateMappedFromCSS1(const std::string& path, size_t index, const AudioFormat* targetFormat);
+        IAudioSource* CreateMappedFromWAV(const std::string& path, const AudioFormat* targetFormat);
         IAudioSource* CreateStreamFromWAV(const std::string& path);
         IAudioSource* CreateStreamFromWAV(SDL_RWops* rw);
     } // namespace AudioSource
@@ -76,7 +80,8 @@ namespace OpenRCT2::Audio
     namespace AudioMixer
     {
         IAudioMixer* Create();
-    }
+        int32_t RunBenchmark(int32_t numChannels, int32_t iterations);
+    } // namespace AudioMixer
 
     std::unique_ptr<IAudioContext> CreateAudioContext();
 
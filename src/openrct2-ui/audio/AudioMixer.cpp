@@ -9,9 +9,12 @@
 
 #include "AudioContext.h"
 #include "AudioFormat.h"
+#include "MixBus.h"
 
 #include <SDL.h>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iterator>
 #include <list>
 #include <openrct2/Context.h>
@@ -22,6 +25,7 @@
 #include <openrct2/audio/audio.h>
 #include <openrct2/common.h>
 #include <openrct2/config/Config.h>
+#include <openrct2/core/Console.hpp>
 #include <speex/speex_resampler.h>
 #include <vector>
 
@@ -47,6 +51,8 @@ namespace OpenRCT2::Audio
         std::vector<uint8_t> _channelBuffer;
         std::vector<uint8_t> _convertBuffer;
         std::vector<uint8_t> _effectBuffer;
+        std::vector<float> _mixBuffer;
+        const MixKernels* _mixKernels = &GetMixKernels();
 
     public:
         AudioMixerImpl()
@@ -63,25 +69,7 @@ namespace OpenRCT2::Audio
         void Init(const char* device) override
         {
             Close();
-
-            SDL_AudioSpec want = {};
-            want.freq = 22050;
-            want.format = AUDIO_S16SYS;
-            want.channels = 2;
-            want.samples = 2048;
-            want.callback = [](void* arg, uint8_t* dst, int32_t length) -> void {
-                auto mixer = static_cast<AudioMixerImpl*>(arg);
-                mixer->GetNextAudioChunk(dst, static_cast<size_t>(length));
-            };
-            want.userdata = this;
-
-            SDL_AudioSpec have;
-            _deviceId = SDL_OpenAudioDevice(device, 0, &want, &have, 0);
-            _format.format = have.format;
-            _format.channels = have.channels;
-            _format.freq = have.freq;
-
-            LoadAllSounds();
+            OpenDevice(device);
 
             SDL_PauseAudioDevice(_deviceId, 0);
         }
@@ -122,6 +110,8 @@ namespace OpenRCT2::Audio
             _convertBuffer.shrink_to_fit();
             _effectBuffer.clear();
             _effectBuffer.shrink_to_fit();
+            _mixBuffer.clear();
+            _mixBuffer.shrink_to_fit();
         }
 
         void Lock() override
@@ -165,7 +155,7 @@ namespace OpenRCT2::Audio
                 if (source == nullptr)
                 {
                     const utf8* path = context_get_path_legacy(static_cast<int32_t>(pathId));
-                    source = AudioSource::CreateMemoryFromWAV(path, &_format);
+                    source = AudioSource::CreateMappedFromWAV(path, &_format);
                     if (source == nullptr)
                     {
                         source = _nullSource;
@@ -184,7 +174,20 @@ namespace OpenRCT2::Audio
 
         IAudioSource* GetSoundSource(SoundId id) override
         {
-            return _css1Sources[static_cast<uint32_t>(id)];
+            // Sounds are mapped from css1.dat when they are first played rather than all being loaded up front
+            auto index = static_cast<uint32_t>(id);
+            IAudioSource* source = _css1Sources[index];
+            if (source == nullptr)
+            {
+                const utf8* css1Path = context_get_path_legacy(PATH_ID_CSS1);
+                source = AudioSource::CreateMappedFromCSS1(css1Path, index, &_format);
+                if (source == nullptr)
+                {
+                    source = _nullSource;
+                }
+                _css1Sources[index] = source;
+            }
+            return source;
         }
 
         IAudioSource* GetMusicSource(int32_t id) override
@@ -192,29 +195,145 @@ namespace OpenRCT2::Audio
             return _musicSources[id];
         }
 
+        /**
+         * Mixes a number of looping channels playing a synthetic tone through every available set of mix kernels,
+         * using the dummy SDL audio driver so no audio device or game data is required.
+         */
+        static int32_t RunBenchmark(int32_t numChannels, int32_t iterations)
+        {
+            if (SDL_AudioInit("dummy") != 0)
+            {
+                Console::Error::WriteLine("Unable to initialise the dummy audio driver: %s", SDL_GetError());
+                return -1;
+            }
+
+            auto savedConfig = gConfigSound;
+            gConfigSound.master_sound_enabled = true;
+            gConfigSound.sound_enabled = true;
+            gConfigSound.master_volume = 100;
+            gConfigSound.sound_volume = 100;
+            gConfigSound.ride_music_volume = 100;
+
+            int32_t result = 0;
+            {
+                AudioMixerImpl mixer;
+                mixer.OpenDevice(nullptr);
+                if (mixer._deviceId == 0)
+                {
+                    Console::Error::WriteLine("Unable to open the dummy audio device: %s", SDL_GetError());
+                    result = -1;
+                }
+                else
+                {
+                    mixer.RunBenchmarkIterations(numChannels, iterations);
+                }
+            }
+
+            gConfigSound = savedConfig;
+            SDL_AudioQuit();
+            return result;
+        }
+
     private:
-        void LoadAllSounds()
+        void RunBenchmarkIterations(int32_t numChannels, int32_t iterations)
         {
-            const utf8* css1Path = context_get_path_legacy(PATH_ID_CSS1);
-            for (size_t i = 0; i < std::size(_css1Sources); i++)
+            constexpr size_t ChunkFrames = 2048;
+            constexpr double SourceSeconds = 2.0;
+
+            // A few seconds of a plain tone is enough, the channels loop over it
+            auto byteRate = static_cast<size_t>(_format.GetByteRate());
+            std::vector<uint8_t> pcm(static_cast<size_t>(_format.freq * SourceSeconds) * byteRate);
+            auto samples = reinterpret_cast<int16_t*>(pcm.data());
+            for (size_t i = 0; i < pcm.size() / sizeof(int16_t); i++)
             {
-                auto source = AudioSource::CreateMemoryFromCSS1(css1Path, i, &_format);
-                if (source == nullptr)
+                samples[i] = static_cast<int16_t>(std::sin(static_cast<double>(i) * 0.05) * 8000.0);
+            }
+            IAudioSource* source = AudioSource::CreateMemoryFromPCM(std::move(pcm), _format);
+
+            for (int32_t i = 0; i < numChannels; i++)
+            {
+                auto channel = Play(source, MIXER_LOOP_INFINITE, false, false);
+                channel->SetGroup(i % 2 == 0 ? MIXER_GROUP_SOUND : MIXER_GROUP_RIDE_MUSIC);
+                channel->SetPan(static_cast<float>(i % 9) / 8.0f);
+
+                // Like vehicle sounds, some channels play at a different rate and go through the resampler
+                if (i % 4 == 3)
                 {
-                    source = _nullSource;
+                    channel->SetRate(1.25);
                 }
-                _css1Sources[i] = source;
             }
+
+            std::vector<uint8_t> output(ChunkFrames * byteRate);
+            auto chunkSeconds = static_cast<double>(ChunkFrames) / _format.freq;
+            Console::WriteLine("Mixing %d channels, %d chunks of %zu frames", numChannels, iterations, ChunkFrames);
+            for (const auto& kernels : GetAvailableMixKernels())
+            {
+                _mixKernels = &kernels;
+
+                auto startTime = std::chrono::high_resolution_clock::now();
+                for (int32_t i = 0; i < iterations; i++)
+                {
+                    // Change the volume every chunk so the volume fades are included
+                    for (auto channel : _channels)
+                    {
+                        channel->SetVolume(i % 2 == 0 ? MIXER_VOLUME_MAX : MIXER_VOLUME_MAX / 2);
+                    }
+                    GetNextAudioChunk(output.data(), output.size());
+                }
+                auto endTime = std::chrono::high_resolution_clock::now();
+
+                std::chrono::duration<double> duration = endTime - startTime;
+                auto perChunk = duration.count() / std::max(iterations, 1);
+                Console::WriteLine(
+                    "%-8s %10.3f ms total, %8.3f us per chunk, %8.1fx real time", kernels.Name, duration.count() * 1000.0,
+                    perChunk * 1000000.0, perChunk > 0 ? chunkSeconds / perChunk : 0.0);
+            }
+            _mixKernels = &GetMixKernels();
+
+            Lock();
+            for (IAudioChannel* channel : _channels)
+            {
+                delete channel;
+            }
+            _channels.clear();
+            Unlock();
+            delete source;
+        }
+
+        /**
+         * Opens the audio device without starting playback. SDL converts to the device format for us as we do not
+         * allow any changes, so the mix bus can always produce signed 16-bit stereo.
+         */
+        void OpenDevice(const char* device)
+        {
+            SDL_AudioSpec want = {};
+            want.freq = 22050;
+            want.format = AUDIO_S16SYS;
+            want.channels = 2;
+            want.samples = 2048;
+            want.callback = [](void* arg, uint8_t* dst, int32_t length) -> void {
+                auto mixer = static_cast<AudioMixerImpl*>(arg);
+                mixer->GetNextAudioChunk(dst, static_cast<size_t>(length));
+            };
+            want.userdata = this;
+
+            SDL_AudioSpec have;
+            _deviceId = SDL_OpenAudioDevice(device, 0, &want, &have, 0);
+            _format.format = have.format;
+            _format.channels = have.channels;
+            _format.freq = have.freq;
         }
 
         void GetNextAudioChunk(uint8_t* dst, size_t length)
         {
             UpdateAdjustedSound();
 
-            // Zero the output buffer
-            std::fill_n(dst, length, 0);
+            // Zero the mix bus, all channels are accumulated on to it before a single conversion to the output buffer
+            size_t numSamples = length / sizeof(int16_t);
+            _mixBuffer.assign(numSamples, 0.0f);
 
-            // Mix channels onto output buffer
+            // Mix channels onto the mix bus
+            bool mixed = false;
             auto it = _channels.begin();
             while (it != _channels.end())
             {
@@ -223,7 +342,7 @@ namespace OpenRCT2::Audio
                 if ((group != MIXER_GROUP_SOUND || gConfigSound.sound_enabled) && gConfigSound.master_sound_enabled
                     && gConfigSound.master_volume != 0)
                 {
-                    MixChannel(channel, dst, length);
+                    mixed |= MixChannel(channel, length);
                 }
                 if ((channel->IsDone() && channel->DeleteOnDone()) || channel->IsStopping())
                 {
@@ -235,6 +354,16 @@ namespace OpenRCT2::Audio
                     it++;
                 }
             }
+
+            // Clip and convert the mix bus on to the output buffer
+            if (mixed)
+            {
+                _mixKernels->StoreS16(reinterpret_cast<int16_t*>(dst), _mixBuffer.data(), numSamples);
+            }
+            else
+            {
+                std::fill_n(dst, length, 0);
+            }
         }
 
         void UpdateAdjustedSound()
@@ -252,15 +381,15 @@ namespace OpenRCT2::Audio
             }
         }
 
-        void MixChannel(ISDLAudioChannel* channel, uint8_t* data, size_t length)
+        /**
+         * Reads the next block of the channel and accumulates it on to the mix bus.
+         * Returns false if nothing could be mixed.
+         */
+        bool MixChannel(ISDLAudioChannel* channel, size_t length)
         {
             int32_t byteRate = _format.GetByteRate();
             auto numSamples = static_cast<int32_t>(length / byteRate);
-            double rate = 1;
-            if (_format.format == AUDIO_S16SYS)
-            {
-                rate = channel->GetRate();
-            }
+            double rate = channel->GetRate();
 
             bool mustConvert = false;
             SDL_AudioCVT cvt;
@@ -268,13 +397,14 @@ namespace OpenRCT2::Audio
             AudioFormat streamformat = channel->GetFormat();
             if (streamformat != _format)
             {
+                // Memory sources are converted when they are loaded, only streamed sources end up here
                 if (SDL_BuildAudioCVT(
                         &cvt, streamformat.format, streamformat.channels, streamformat.freq, _format.format, _format.channels,
                         _format.freq)
                     == -1)
                 {
                     // Unable to convert channel data
-                    return;
+                    return false;
                 }
                 mustConvert = true;
             }
@@ -297,7 +427,7 @@ namespace OpenRCT2::Audio
                 }
                 else
                 {
-                    return;
+                    return false;
                 }
             }
             else
@@ -322,16 +452,14 @@ namespace OpenRCT2::Audio
                 buffer = _effectBuffer.data();
             }
 
-            // Apply panning and volume
-            ApplyPan(channel, buffer, bufferLen, byteRate);
-            int32_t mixVolume = ApplyVolume(channel, buffer, bufferLen);
-
-            // Finally mix on to destination buffer
-            size_t dstLength = std::min(length, bufferLen);
-            SDL_MixAudioFormat(
-                data, static_cast<const uint8_t*>(buffer), _format.format, static_cast<uint32_t>(dstLength), mixVolume);
+            // Finally accumulate on to the mix bus with panning and volume applied
+            MixGain gain = GetMixGain(channel, bufferLen);
+            size_t mixLength = std::min(length, bufferLen);
+            _mixKernels->AccumulateS16(
+                _mixBuffer.data(), static_cast<const int16_t*>(buffer), mixLength / sizeof(int16_t), gain);
 
             channel->UpdateOldVolume();
+            return true;
         }
 
         /**
@@ -362,23 +490,47 @@ namespace OpenRCT2::Audio
             return outLen * byteRate;
         }
 
-        void ApplyPan(const IAudioChannel* channel, void* buffer, size_t len, size_t sampleSize)
+        /**
+         * Gets the pan and volume ramps for a block of the given length in bytes, the pan ramps from the old to the new
+         * channel pan and the volume fades from the old to the new volume to minimise clicks from sudden changes.
+         */
+        MixGain GetMixGain(const IAudioChannel* channel, size_t len) const
         {
-            if (channel->GetPan() != 0.5f && _format.channels == 2)
+            MixGain gain;
+
+            auto numFrames = static_cast<int32_t>(len / _format.GetByteRate());
+            if (channel->GetPan() != 0.5f && _format.channels == 2 && numFrames != 0)
             {
-                switch (_format.format)
-                {
-                    case AUDIO_S16SYS:
-                        EffectPanS16(channel, static_cast<int16_t*>(buffer), static_cast<int32_t>(len / sampleSize));
-                        break;
-                    case AUDIO_U8:
-                        EffectPanU8(channel, static_cast<uint8_t*>(buffer), static_cast<int32_t>(len / sampleSize));
-                        break;
-                }
+                const float dt = 1.0f / static_cast<float>(numFrames * 2.0f);
+                gain.PanLeft = channel->GetOldVolumeL();
+                gain.PanRight = channel->GetOldVolumeR();
+                gain.PanLeftStep = dt * (channel->GetVolumeL() - channel->GetOldVolumeL());
+                gain.PanRightStep = dt * (channel->GetVolumeR() - channel->GetOldVolumeR());
             }
+
+            float volumeAdjust = GetVolumeAdjust(channel);
+            int32_t startVolume = channel->GetOldVolume() * volumeAdjust;
+            int32_t endVolume = channel->GetVolume() * volumeAdjust;
+            if (channel->IsStopping())
+            {
+                endVolume = 0;
+            }
+
+            auto fadeLength = static_cast<int32_t>(len) / _format.BytesPerSample();
+            if (startVolume != endVolume && fadeLength != 0)
+            {
+                gain.Volume = static_cast<float>(startVolume) / MIXER_VOLUME_MAX;
+                gain.VolumeStep = static_cast<float>(endVolume - startVolume) / MIXER_VOLUME_MAX / fadeLength;
+            }
+            else
+            {
+                int32_t mixVolume = channel->GetVolume() * volumeAdjust;
+                gain.Volume = static_cast<float>(mixVolume) / MIXER_VOLUME_MAX;
+            }
+            return gain;
         }
 
-        int32_t ApplyVolume(const IAudioChannel* channel, void* buffer, size_t len)
+        float GetVolumeAdjust(const IAudioChannel* channel) const
         {
             float volumeAdjust = _volume;
             volumeAdjust *= gConfigSound.master_sound_enabled ? (static_cast<float>(gConfigSound.master_volume) / 100.0f)
@@ -399,91 +551,7 @@ namespace OpenRCT2::Audio
                     volumeAdjust *= _adjustMusicVolume;
                     break;
             }
-
-            int32_t startVolume = channel->GetOldVolume() * volumeAdjust;
-            int32_t endVolume = channel->GetVolume() * volumeAdjust;
-            if (channel->IsStopping())
-            {
-                endVolume = 0;
-            }
-
-            int32_t mixVolume = channel->GetVolume() * volumeAdjust;
-            if (startVolume != endVolume)
-            {
-                // Set to max since we are adjusting the volume ourselves
-                mixVolume = MIXER_VOLUME_MAX;
-
-                // Fade between volume levels to smooth out sound and minimize clicks from sudden volume changes
-                int32_t fadeLength = static_cast<int32_t>(len) / _format.BytesPerSample();
-                switch (_format.format)
-                {
-                    case AUDIO_S16SYS:
-                        EffectFadeS16(static_cast<int16_t*>(buffer), fadeLength, startVolume, endVolume);
-                        break;
-                    case AUDIO_U8:
-                        EffectFadeU8(static_cast<uint8_t*>(buffer), fadeLength, startVolume, endVolume);
-                        break;
-                }
-            }
-            return mixVolume;
-        }
-
-        static void EffectPanS16(const IAudioChannel* channel, int16_t* data, int32_t length)
-        {
-            const float dt = 1.0f / static_cast<float>(length * 2.0f);
-            float volumeL = channel->GetOldVolumeL();
-            float volumeR = channel->GetOldVolumeR();
-            const float d_left = dt * (channel->GetVolumeL() - channel->GetOldVolumeL());
-            const float d_right = dt * (channel->GetVolumeR() - channel->GetOldVolumeR());
-
-            for (int32_t i = 0; i < length * 2; i += 2)
-            {
-                data[i + 0] = static_cast<int16_t>(volumeL * static_cast<float>(data[i + 0]));
-                data[i + 1] = static_cast<int16_t>(volumeR * static_cast<float>(data[i + 1]));
-                volumeL += d_left;
-                volumeR += d_right;
-            }
-        }
-
-        static void EffectPanU8(const IAudioChannel* channel, uint8_t* data, int32_t length)
-        {
-            float volumeL = channel->GetVolumeL();
-            float volumeR = channel->GetVolumeR();
-            float oldVolumeL = channel->GetOldVolumeL();
-            float oldVolumeR = channel->GetOldVolumeR();
-
-            for (int32_t i = 0; i < length * 2; i += 2)
-            {
-                float t = static_cast<float>(i) / static_cast<float>(length * 2.0f);
-                data[i] = static_cast<uint8_t>(data[i] * ((1.0 - t) * oldVolumeL + t * volumeL));
-                data[i + 1] = static_cast<uint8_t>(data[i + 1] * ((1.0 - t) * oldVolumeR + t * volumeR));
-            }
-        }
-
-        static void EffectFadeS16(int16_t* data, int32_t length, int32_t startvolume, int32_t endvolume)
-        {
-            static_assert(SDL_MIX_MAXVOLUME == MIXER_VOLUME_MAX, "Max volume differs between OpenRCT2 and SDL2");
-
-            float startvolume_f = static_cast<float>(startvolume) / SDL_MIX_MAXVOLUME;
-            float endvolume_f = static_cast<float>(endvolume) / SDL_MIX_MAXVOLUME;
-            for (int32_t i = 0; i < length; i++)
-            {
-                float t = static_cast<float>(i) / length;
-                data[i] = static_cast<int16_t>(data[i] * ((1.0f - t) * startvolume_f + t * endvolume_f));
-            }
-        }
-
-        static void EffectFadeU8(uint8_t* data, int32_t length, int32_t startvolume, int32_t endvolume)
-        {
-            static_assert(SDL_MIX_MAXVOLUME == MIXER_VOLUME_MAX, "Max volume differs between OpenRCT2 and SDL2");
-
-            float startvolume_f = static_cast<float>(startvolume) / SDL_MIX_MAXVOLUME;
-            float endvolume_f = static_cast<float>(endvolume) / SDL_MIX_MAXVOLUME;
-            for (int32_t i = 0; i < length; i++)
-            {
-                float t = static_cast<float>(i) / length;
-                data[i] = static_cast<uint8_t>(data[i] * ((1.0f - t) * startvolume_f + t * endvolume_f));
-            }
+            return volumeAdjust;
         }
 
         bool Convert(SDL_AudioCVT* cvt, const void* src, size_t len)
@@ -512,4 +580,9 @@ namespace OpenRCT2::Audio
     {
         return new AudioMixerImpl();
     }
+
+    int32_t AudioMixer::RunBenchmark(int32_t numChannels, int32_t iterations)
+    {
+        return AudioMixerImpl::RunBenchmark(numChannels, iterations);
+    }
 } // namespace OpenRCT2::Audio
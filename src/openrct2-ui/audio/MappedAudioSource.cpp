@@ -0,0 +1,428 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "AudioContext.h"
+#include "AudioFormat.h"
+
+#include <SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <openrct2/audio/AudioSource.h>
+#include <openrct2/common.h>
+#include <openrct2/core/IStream.hpp>
+#include <openrct2/core/MemoryMappedFile.h>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenRCT2::Audio
+{
+    // Number of frames decoded at a time, roughly a third of a second at 22050 Hz
+    constexpr size_t MAPPED_AUDIO_BLOCK_FRAMES = 8192;
+
+    // Upper bound for the decoded blocks of all mapped sources together
+    constexpr size_t MAPPED_AUDIO_CACHE_CAPACITY = 4 * 1024 * 1024;
+
+    /**
+     * Decoded blocks of all mapped audio sources. When the capacity is exceeded the least recently used blocks are
+     * dropped, they are decoded again from the mapped file when they are next read.
+     */
+    class AudioBlockCache
+    {
+    private:
+        struct Block
+        {
+            uint64_t Key;
+            std::vector<uint8_t> Data;
+        };
+
+        std::mutex _mutex;
+        std::list<Block> _blocks;
+        std::unordered_map<uint64_t, std::list<Block>::iterator> _blockMap;
+        size_t _size = 0;
+
+    public:
+        /**
+         * Copies up to len bytes from the given block, starting at offset, decoding the block first if it is not cached.
+         * Returns the number of bytes copied.
+         */
+        template<typename TDecodeFunc>
+        size_t Read(uint32_t sourceId, size_t blockIndex, size_t offset, void* dst, size_t len, TDecodeFunc decode)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            auto key = (static_cast<uint64_t>(sourceId) << 32) | static_cast<uint32_t>(blockIndex);
+            auto it = _blockMap.find(key);
+            if (it != _blockMap.end())
+            {
+                // Move to the front of the list as the most recently used block
+                _blocks.splice(_blocks.begin(), _blocks, it->second);
+            }
+            else
+            {
+                Block block = { key, {} };
+                decode(blockIndex, block.Data);
+                _size += block.Data.size();
+                _blocks.push_front(std::move(block));
+                _blockMap[key] = _blocks.begin();
+                Trim();
+            }
+
+            const auto& data = _blocks.front().Data;
+            size_t bytesToCopy = 0;
+            if (offset < data.size())
+            {
+                bytesToCopy = std::min(len, data.size() - offset);
+                std::copy_n(data.data() + offset, bytesToCopy, static_cast<uint8_t*>(dst));
+            }
+            return bytesToCopy;
+        }
+
+        void Evict(uint32_t sourceId)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            for (auto it = _blocks.begin(); it != _blocks.end();)
+            {
+                if ((it->Key >> 32) == sourceId)
+                {
+                    _size -= it->Data.size();
+                    _blockMap.erase(it->Key);
+                    it = _blocks.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+    private:
+        void Trim()
+        {
+            // Always keep the block that was just decoded
+            while (_size > MAPPED_AUDIO_CACHE_CAPACITY && _blocks.size() > 1)
+            {
+                auto& block = _blocks.back();
+                _size -= block.Data.size();
+                _blockMap.erase(block.Key);
+                _blocks.pop_back();
+            }
+        }
+    };
+
+    static AudioBlockCache& GetAudioBlockCache()
+    {
+        static AudioBlockCache cache;
+        return cache;
+    }
+
+    /**
+     * Maps the given file, sharing the mapping with all other sources that still use the same file.
+     */
+    static std::shared_ptr<MemoryMappedFile> OpenMappedFile(const std::string& path)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::weak_ptr<MemoryMappedFile>> files;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto file = files[path].lock();
+        if (file == nullptr)
+        {
+            try
+            {
+                file = std::make_shared<MemoryMappedFile>(path);
+                files[path] = file;
+            }
+            catch (const IOException&)
+            {
+                log_verbose("Unable to map %s", path.c_str());
+            }
+        }
+        return file;
+    }
+
+    /**
+     * An audio source where raw PCM data is read from a memory mapped file and converted to the
+     * target format a block at a time when it is first played.
+     */
+    class MappedAudioSource final : public ISDLAudioSource
+    {
+    private:
+        std::shared_ptr<MemoryMappedFile> _file;
+        const uint8_t* _pcm = nullptr;
+        size_t _pcmLength = 0;
+        AudioFormat _pcmFormat = {};
+        AudioFormat _format = {};
+        uint64_t _length = 0;
+        uint32_t _id = 0;
+
+    public:
+        MappedAudioSource()
+        {
+            static std::atomic<uint32_t> nextId = 1;
+            _id = nextId++;
+        }
+
+        ~MappedAudioSource() override
+        {
+            GetAudioBlockCache().Evict(_id);
+        }
+
+        [[nodiscard]] uint64_t GetLength() const override
+        {
+            return _length;
+        }
+
+        [[nodiscard]] AudioFormat GetFormat() const override
+        {
+            return _format;
+        }
+
+        size_t Read(void* dst, uint64_t offset, size_t len) override
+        {
+            // No conversion needed, read straight from the mapped file
+            if (_pcmFormat == _format)
+            {
+                size_t bytesToRead = 0;
+                if (offset < _length)
+                {
+                    bytesToRead = static_cast<size_t>(std::min<uint64_t>(len, _length - offset));
+                    std::copy_n(_pcm + offset, bytesToRead, static_cast<uint8_t*>(dst));
+                }
+                return bytesToRead;
+            }
+
+            auto& cache = GetAudioBlockCache();
+            auto blockLength = MAPPED_AUDIO_BLOCK_FRAMES * _format.GetByteRate();
+            auto decode = [this](size_t blockIndex, std::vector<uint8_t>& data) { DecodeBlock(blockIndex, data); };
+
+            size_t bytesRead = 0;
+            while (bytesRead < len && offset < _length)
+            {
+                auto blockIndex = static_cast<size_t>(offset / blockLength);
+                auto blockOffset = static_cast<size_t>(offset % blockLength);
+                size_t blockBytesRead = cache.Read(
+                    _id, blockIndex, blockOffset, static_cast<uint8_t*>(dst) + bytesRead, len - bytesRead, decode);
+                if (blockBytesRead == 0)
+                {
+                    break;
+                }
+                bytesRead += blockBytesRead;
+                offset += blockBytesRead;
+            }
+            return bytesRead;
+        }
+
+        bool LoadCSS1(const std::shared_ptr<MemoryMappedFile>& file, size_t index, const AudioFormat& targetFormat)
+        {
+            auto data = file->GetData();
+            auto dataLength = file->GetLength();
+
+            uint32_t numSounds;
+            if (dataLength < sizeof(numSounds))
+            {
+                return false;
+            }
+            std::memcpy(&numSounds, data, sizeof(numSounds));
+            if (index >= numSounds)
+            {
+                return false;
+            }
+
+            uint32_t pcmOffset;
+            size_t pcmOffsetPosition = sizeof(numSounds) + index * sizeof(pcmOffset);
+            if (pcmOffsetPosition + sizeof(pcmOffset) > dataLength)
+            {
+                return false;
+            }
+            std::memcpy(&pcmOffset, data + pcmOffsetPosition, sizeof(pcmOffset));
+
+            uint32_t pcmSize;
+            WaveFormatEx waveFormat{};
+            size_t headerLength = sizeof(pcmSize) + sizeof(waveFormat);
+            if (static_cast<size_t>(pcmOffset) + headerLength > dataLength)
+            {
+                return false;
+            }
+            std::memcpy(&pcmSize, data + pcmOffset, sizeof(pcmSize));
+            std::memcpy(&waveFormat, data + pcmOffset + sizeof(pcmSize), sizeof(waveFormat));
+
+            AudioFormat format;
+            format.freq = waveFormat.frequency;
+            format.format = AUDIO_S16LSB;
+            format.channels = waveFormat.channels;
+
+            size_t pcmBegin = pcmOffset + headerLength;
+            return Load(file, pcmBegin, std::min<size_t>(pcmSize, dataLength - pcmBegin), format, targetFormat);
+        }
+
+        bool LoadWAV(const std::shared_ptr<MemoryMappedFile>& file, const AudioFormat& targetFormat)
+        {
+            const uint32_t DATA = 0x61746164;
+            const uint32_t FMT = 0x20746D66;
+            const uint32_t RIFF = 0x46464952;
+            const uint32_t WAVE = 0x45564157;
+            const uint16_t pcmformat = 0x0001;
+
+            auto data = file->GetData();
+            auto dataLength = file->GetLength();
+            if (dataLength < 12 || ReadLE32(data) != RIFF || ReadLE32(data + 8) != WAVE)
+            {
+                log_verbose("Not a WAV file");
+                return false;
+            }
+
+            // Walk the chunks looking for the format and the data
+            WaveFormat waveFormat{};
+            bool hasFormat = false;
+            size_t position = 12;
+            while (position + 8 <= dataLength)
+            {
+                uint32_t chunkId = ReadLE32(data + position);
+                uint32_t chunkSize = ReadLE32(data + position + 4);
+                position += 8;
+                if (chunkId == FMT)
+                {
+                    if (chunkSize < sizeof(waveFormat) || position + sizeof(waveFormat) > dataLength)
+                    {
+                        break;
+                    }
+                    std::memcpy(&waveFormat, data + position, sizeof(waveFormat));
+                    hasFormat = true;
+                }
+                else if (chunkId == DATA)
+                {
+                    if (!hasFormat || waveFormat.encoding != pcmformat)
+                    {
+                        log_verbose("Not in proper format");
+                        return false;
+                    }
+
+                    AudioFormat format;
+                    format.freq = waveFormat.frequency;
+                    format.channels = waveFormat.channels;
+                    switch (waveFormat.bitspersample)
+                    {
+                        case 8:
+                            format.format = AUDIO_U8;
+                            break;
+                        case 16:
+                            format.format = AUDIO_S16LSB;
+                            break;
+                        default:
+                            log_verbose("Invalid bits per sample");
+                            return false;
+                    }
+                    return Load(file, position, std::min<size_t>(chunkSize, dataLength - position), format, targetFormat);
+                }
+
+                // Chunks are word aligned
+                position += chunkSize + (chunkSize & 1);
+            }
+            log_verbose("Could not find DATA chunk");
+            return false;
+        }
+
+    private:
+        static uint32_t ReadLE32(const uint8_t* src)
+        {
+            uint32_t value;
+            std::memcpy(&value, src, sizeof(value));
+            return SDL_SwapLE32(value);
+        }
+
+        bool Load(
+            const std::shared_ptr<MemoryMappedFile>& file, size_t pcmBegin, size_t pcmLength, const AudioFormat& format,
+            const AudioFormat& targetFormat)
+        {
+            // Blocks are converted independently which only works without resampling, leave those to the memory source
+            if (format.freq != targetFormat.freq || format.channels <= 0 || targetFormat.channels <= 0)
+            {
+                return false;
+            }
+
+            _file = file;
+            _pcm = file->GetData() + pcmBegin;
+            _pcmFormat = format;
+            _format = targetFormat;
+
+            auto numFrames = pcmLength / _pcmFormat.GetByteRate();
+            _pcmLength = numFrames * _pcmFormat.GetByteRate();
+            _length = static_cast<uint64_t>(numFrames) * _format.GetByteRate();
+            return true;
+        }
+
+        void DecodeBlock(size_t blockIndex, std::vector<uint8_t>& data) const
+        {
+            size_t srcBlockLength = MAPPED_AUDIO_BLOCK_FRAMES * _pcmFormat.GetByteRate();
+            size_t srcOffset = blockIndex * srcBlockLength;
+            if (srcOffset >= _pcmLength)
+            {
+                return;
+            }
+            size_t srcLength = std::min(srcBlockLength, _pcmLength - srcOffset);
+
+            SDL_AudioCVT cvt;
+            if (SDL_BuildAudioCVT(
+                    &cvt, _pcmFormat.format, _pcmFormat.channels, _pcmFormat.freq, _format.format, _format.channels,
+                    _format.freq)
+                < 0)
+            {
+                return;
+            }
+
+            data.resize(srcLength * cvt.len_mult);
+            std::copy_n(_pcm + srcOffset, srcLength, data.data());
+            cvt.len = static_cast<int32_t>(srcLength);
+            cvt.buf = data.data();
+            if (SDL_ConvertAudio(&cvt) >= 0)
+            {
+                data.resize(cvt.len_cvt);
+                data.shrink_to_fit();
+            }
+            else
+            {
+                data.clear();
+            }
+        }
+    };
+
+    IAudioSource* AudioSource::CreateMappedFromCSS1(const std::string& path, size_t index, const AudioFormat* targetFormat)
+    {
+        auto file = OpenMappedFile(path);
+        if (file != nullptr && targetFormat != nullptr)
+        {
+            auto source = new MappedAudioSource();
+            if (source->LoadCSS1(file, index, *targetFormat))
+            {
+                return source;
+            }
+            delete source;
+        }
+        return CreateMemoryFromCSS1(path, index, targetFormat);
+    }
+
+    IAudioSource* AudioSource::CreateMappedFromWAV(const std::string& path, const AudioFormat* targetFormat)
+    {
+        auto file = OpenMappedFile(path);
+        if (file != nullptr && targetFormat != nullptr)
+        {
+            auto source = new MappedAudioSource();
+            if (source->LoadWAV(file, *targetFormat))
+            {
+                return source;
+            }
+            delete source;
+        }
+        return CreateMemoryFromWAV(path, targetFormat);
+    }
+} // namespace OpenRCT2::Audio
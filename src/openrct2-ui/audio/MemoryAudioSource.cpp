@@ -151,6 +151,15 @@ namespace OpenRCT2::Audio
             return result;
         }
 
+        void LoadPCM(std::vector<uint8_t>&& data, const AudioFormat& format)
+        {
+            Unload();
+
+            _data = std::move(data);
+            _length = _data.size();
+            _format = format;
+        }
+
         bool Convert(const AudioFormat* format)
         {
             if (*format != _format)
@@ -237,4 +246,11 @@ namespace OpenRCT2::Audio
         }
         return source;
     }
+
+    IAudioSource* AudioSource::CreateMemoryFromPCM(std::vector<uint8_t>&& data, const AudioFormat& format)
+    {
+        auto source = new MemoryAudioSource();
+        source->LoadPCM(std::move(data), format);
+        return source;
+    }
 } // namespace OpenRCT2::Audio
@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MixBus.h"
+
+#include <algorithm>
+#include <openrct2/util/Util.h>
+
+namespace OpenRCT2::Audio
+{
+    void MixAccumulateS16Scalar(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            dst[i] += static_cast<float>(src[i]) * MixGainAt(gain, i);
+        }
+    }
+
+    void MixStoreS16Scalar(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            dst[i] = static_cast<int16_t>(std::clamp(src[i], -32768.0f, 32767.0f));
+        }
+    }
+
+    static constexpr MixKernels MixKernelsScalar = { "scalar", MixAccumulateS16Scalar, MixStoreS16Scalar };
+    static constexpr MixKernels MixKernelsSSE41 = { "sse4.1", MixAccumulateS16SSE41, MixStoreS16SSE41 };
+    static constexpr MixKernels MixKernelsAVX2 = { "avx2", MixAccumulateS16AVX2, MixStoreS16AVX2 };
+
+    const MixKernels& GetMixKernels()
+    {
+        static const MixKernels& kernels = []() -> const MixKernels& {
+            if (avx2_available())
+            {
+                log_verbose("registering AVX2 mix kernels");
+                return MixKernelsAVX2;
+            }
+            else if (sse41_available())
+            {
+                log_verbose("registering SSE4.1 mix kernels");
+                return MixKernelsSSE41;
+            }
+            log_verbose("registering scalar mix kernels");
+            return MixKernelsScalar;
+        }();
+        return kernels;
+    }
+
+    std::vector<MixKernels> GetAvailableMixKernels()
+    {
+        std::vector<MixKernels> result = { MixKernelsScalar };
+        if (sse41_available())
+        {
+            result.push_back(MixKernelsSSE41);
+        }
+        if (avx2_available())
+        {
+            result.push_back(MixKernelsAVX2);
+        }
+        return result;
+    }
+} // namespace OpenRCT2::Audio
@@ -0,0 +1,70 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <openrct2/common.h>
+#include <vector>
+
+namespace OpenRCT2::Audio
+{
+    /**
+     * Gain applied to an interleaved stereo (or mono) block while it is accumulated onto the mix bus.
+     * The pan gains ramp per frame and the volume ramps per sample, both linearly from the given start.
+     */
+    struct MixGain
+    {
+        float PanLeft = 1.0f;
+        float PanRight = 1.0f;
+        float PanLeftStep = 0.0f;
+        float PanRightStep = 0.0f;
+        float Volume = 1.0f;
+        float VolumeStep = 0.0f;
+    };
+
+    /**
+     * Returns the gain for the sample at the given interleaved index. Kernels evaluate the ramps from the
+     * index rather than accumulating the steps so that every kernel produces the same result.
+     */
+    inline float MixGainAt(const MixGain& gain, size_t index)
+    {
+        const auto frame = static_cast<float>(index >> 1);
+        const float pan = (index & 1) ? gain.PanRight + frame * gain.PanRightStep : gain.PanLeft + frame * gain.PanLeftStep;
+        const float volume = gain.Volume + static_cast<float>(index) * gain.VolumeStep;
+        return pan * volume;
+    }
+
+    using MixAccumulateS16Func = void (*)(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain);
+    using MixStoreS16Func = void (*)(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count);
+
+    struct MixKernels
+    {
+        const char* Name;
+        MixAccumulateS16Func AccumulateS16;
+        MixStoreS16Func StoreS16;
+    };
+
+    void MixAccumulateS16Scalar(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain);
+    void MixAccumulateS16SSE41(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain);
+    void MixAccumulateS16AVX2(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain);
+
+    void MixStoreS16Scalar(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count);
+    void MixStoreS16SSE41(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count);
+    void MixStoreS16AVX2(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count);
+
+    /**
+     * Gets the fastest set of mix kernels supported by the running CPU.
+     */
+    const MixKernels& GetMixKernels();
+
+    /**
+     * Gets the scalar mix kernels, followed by every SIMD set supported by the running CPU.
+     */
+    std::vector<MixKernels> GetAvailableMixKernels();
+} // namespace OpenRCT2::Audio
@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MixBus.h"
+
+#include <openrct2/core/Guard.hpp>
+
+#ifdef __SSE4_1__
+
+#    include <immintrin.h>
+
+namespace OpenRCT2::Audio
+{
+    void MixAccumulateS16SSE41(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain)
+    {
+        const __m128 panBase = _mm_setr_ps(gain.PanLeft, gain.PanRight, gain.PanLeft, gain.PanRight);
+        const __m128 panStep = _mm_setr_ps(gain.PanLeftStep, gain.PanRightStep, gain.PanLeftStep, gain.PanRightStep);
+        const __m128 volumeBase = _mm_set1_ps(gain.Volume);
+        const __m128 volumeStep = _mm_set1_ps(gain.VolumeStep);
+        const __m128 frameInc = _mm_set1_ps(2.0f);
+        const __m128 indexInc = _mm_set1_ps(4.0f);
+        __m128 frame = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+        __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i samples16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+            const __m128 samples = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(samples16));
+            const __m128 pan = _mm_add_ps(panBase, _mm_mul_ps(frame, panStep));
+            const __m128 volume = _mm_add_ps(volumeBase, _mm_mul_ps(index, volumeStep));
+            const __m128 mixed = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(samples, _mm_mul_ps(pan, volume)));
+            _mm_storeu_ps(dst + i, mixed);
+            frame = _mm_add_ps(frame, frameInc);
+            index = _mm_add_ps(index, indexInc);
+        }
+        for (; i < count; i++)
+        {
+            dst[i] += static_cast<float>(src[i]) * MixGainAt(gain, i);
+        }
+    }
+
+    void MixStoreS16SSE41(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count)
+    {
+        const __m128 lo = _mm_set1_ps(-32768.0f);
+        const __m128 hi = _mm_set1_ps(32767.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lo), hi);
+            const __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lo), hi);
+            const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+        MixStoreS16Scalar(dst + i, src + i, count - i);
+    }
+} // namespace OpenRCT2::Audio
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with SSE4.1 enabled, when targeting x86!
+#    endif
+
+namespace OpenRCT2::Audio
+{
+    void MixAccumulateS16SSE41(float* RESTRICT dst, const int16_t* RESTRICT src, size_t count, const MixGain& gain)
+    {
+        openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    }
+
+    void MixStoreS16SSE41(int16_t* RESTRICT dst, const float* RESTRICT src, size_t count)
+    {
+        openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    }
+} // namespace OpenRCT2::Audio
+
+#endif // __SSE4_1__
@@ -47,6 +47,7 @@
 #include "localisation/LocalisationService.h"
 #include "network/DiscordService.h"
 #include "network/network.h"
+#include "object/ObjectCache.h"
 #include "object/ObjectManager.h"
 #include "object/ObjectRepository.h"
 #include "paint/Painter.h"
@@ -66,11 +67,18 @@
 #include "world/Park.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <exception>
+#include <future>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Audio;
@@ -82,9 +90,130 @@ using namespace OpenRCT2::Ui;
 
 namespace OpenRCT2
 {
+    /**
+     * Records when each phase of starting the game began and ended, so that a timeline can be printed when the game is
+     * started with --startup-profile. Phases may be measured from any thread.
+     */
+    class StartupProfile
+    {
+    private:
+        using Clock = std::chrono::high_resolution_clock;
+
+        struct Phase
+        {
+            std::string Name;
+            std::thread::id ThreadId;
+            Clock::time_point Start;
+            Clock::time_point End;
+        };
+
+        const Clock::time_point _origin = Clock::now();
+        const std::thread::id _mainThreadId = std::this_thread::get_id();
+        std::mutex _mutex;
+        std::vector<Phase> _phases;
+
+    public:
+        class Scope
+        {
+        private:
+            StartupProfile& _profile;
+            std::string _name;
+            Clock::time_point _start = Clock::now();
+            bool _ended = false;
+
+        public:
+            Scope(StartupProfile& profile, std::string name)
+                : _profile(profile)
+                , _name(std::move(name))
+            {
+            }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            ~Scope()
+            {
+                End();
+            }
+
+            /**
+             * Ends the phase before the scope is destroyed.
+             */
+            void End()
+            {
+                if (!_ended)
+                {
+                    _ended = true;
+                    _profile.Add(std::move(_name), _start, Clock::now());
+                }
+            }
+        };
+
+        /**
+         * Measures the phase with the given name until the returned scope is destroyed.
+         */
+        [[nodiscard]] Scope Measure(std::string name)
+        {
+            return Scope(*this, std::move(name));
+        }
+
+        void Print()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto phases = _phases;
+            std::stable_sort(
+                phases.begin(), phases.end(), [](const Phase& a, const Phase& b) { return a.Start < b.Start; });
+
+            auto toMs = [this](Clock::time_point t) {
+                return std::chrono::duration<double, std::milli>(t - _origin).count();
+            };
+
+            Console::WriteLine("Startup profile:");
+            Console::WriteLine("%10s %10s %10s  %-6s  %s", "start ms", "end ms", "time ms", "thread", "phase");
+            for (const auto& phase : phases)
+            {
+                auto start = toMs(phase.Start);
+                auto end = toMs(phase.End);
+                Console::WriteLine(
+                    "%10.1f %10.1f %10.1f  %-6s  %s", start, end, end - start,
+                    phase.ThreadId == _mainThreadId ? "main" : "worker", phase.Name.c_str());
+            }
+            Console::WriteLine("%10s %10.1f %10s  %-6s  %s", "", toMs(Clock::now()), "", "", "ready");
+        }
+
+    private:
+        void Add(std::string name, Clock::time_point start, Clock::time_point end)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _phases.push_back({ std::move(name), std::this_thread::get_id(), start, end });
+        }
+    };
+
     class Context final : public IContext
     {
     private:
+        /**
+         * A park that has been read from its file but has not replaced the current park yet.
+         */
+        struct StagedPark
+        {
+            std::string Path;
+            FILE_TYPE Type{};
+            std::unique_ptr<IParkImporter> Importer;
+            std::vector<rct_object_entry> RequiredObjects;
+            PreparedObjectMap PreparedObjects;
+        };
+
+        struct PendingParkLoad
+        {
+            std::string Path;
+            std::function<void(bool)> Callback;
+            std::future<std::unique_ptr<StagedPark>> Result;
+            std::atomic<ParkLoadStage> Stage{ ParkLoadStage::Reading };
+            std::atomic<size_t> ObjectsRead{};
+            std::atomic<size_t> ObjectCount{};
+            std::atomic<bool> Cancelled{};
+        };
+
         // Dependencies
         std::shared_ptr<IPlatformEnvironment> const _env;
         std::shared_ptr<IAudioContext> const _audioContext;
@@ -114,6 +243,8 @@ namespace OpenRCT2
         std::unique_ptr<IDrawingEngine> _drawingEngine;
         std::unique_ptr<Painter> _painter;
 
+        std::unique_ptr<PendingParkLoad> _parkLoad;
+        StartupProfile _startupProfile;
         bool _initialised = false;
         bool _isWindowMinimised = false;
         uint32_t _lastTick = 0;
@@ -155,6 +286,7 @@ namespace OpenRCT2
             // NOTE: We must shutdown all systems here before Instance is set back to null.
             //       If objects use GetContext() in their destructor things won't go well.
 
+            CancelParkLoad();
             GameActions::ClearQueue();
             network_close();
             window_close_all();
@@ -166,6 +298,7 @@ namespace OpenRCT2
                 _objectManager->UnloadAll();
             }
 
+            scrolling_text_dispose();
             gfx_object_check_all_images_freed();
             gfx_unload_g2();
             gfx_unload_g1();
@@ -332,7 +465,10 @@ namespace OpenRCT2
             }
             _initialised = true;
 
-            crash_init();
+            {
+                auto scope = _startupProfile.Measure("crash reporting");
+                crash_init();
+            }
 
             if (gConfigGeneral.last_run_version != nullptr && String::Equals(gConfigGeneral.last_run_version, OPENRCT2_VERSION))
             {
@@ -353,6 +489,7 @@ namespace OpenRCT2
 
             if (!gOpenRCT2Headless)
             {
+                auto scope = _startupProfile.Measure("find RCT2 path");
                 auto rct2InstallPath = GetOrPromptRCT2Path();
                 if (rct2InstallPath.empty())
                 {
@@ -374,21 +511,24 @@ namespace OpenRCT2
             }
 #endif
 
-            try
-            {
-                _localisationService->OpenLanguage(gConfigGeneral.language, *_objectManager);
-            }
-            catch (const std::exception& e)
             {
-                log_error("Failed to open configured language: %s", e.what());
+                auto scope = _startupProfile.Measure("open language");
                 try
                 {
-                    _localisationService->OpenLanguage(LANGUAGE_ENGLISH_UK, *_objectManager);
+                    _localisationService->OpenLanguage(gConfigGeneral.language, *_objectManager);
                 }
-                catch (const std::exception&)
+                catch (const std::exception& e)
                 {
-                    log_fatal("Failed to open fallback language: %s", e.what());
-                    return false;
+                    log_error("Failed to open configured language: %s", e.what());
+                    try
+                    {
+                        _localisationService->OpenLanguage(LANGUAGE_ENGLISH_UK, *_objectManager);
+                    }
+                    catch (const std::exception&)
+                    {
+                        log_fatal("Failed to open fallback language: %s", e.what());
+                        return false;
+                    }
                 }
             }
 
@@ -420,26 +560,29 @@ namespace OpenRCT2
 
             if (!gOpenRCT2Headless)
             {
+                auto scope = _startupProfile.Measure("create window");
                 _uiContext->CreateWindow();
             }
 
             EnsureUserContentDirectoriesExist();
 
+            // The repository scans do not depend on each other or on the base graphics, apart from the track design scan
+            // which looks up objects in the object repository and may load them, including images from g1 and csg. Run the
+            // independent scans in the background while the main thread loads the audio and the base graphics.
             // TODO Ideally we want to delay this until we show the title so that we can
             //      still open the game window and draw a progress screen for the creation
             //      of the object cache.
-            _objectRepository->LoadOrConstruct(_localisationService->GetCurrentLanguage());
-
-            // TODO Like objects, this can take a while if there are a lot of track designs
-            //      its also really something really we might want to do in the background
-            //      as its not required until the player wants to place a new ride.
-            _trackDesignRepository->Scan(_localisationService->GetCurrentLanguage());
-
-            _scenarioRepository->Scan(_localisationService->GetCurrentLanguage());
-            TitleSequenceManager::Scan();
+            auto language = _localisationService->GetCurrentLanguage();
+            auto objectScan = StartStartupTask(
+                "object repository", [this, language]() { _objectRepository->LoadOrConstruct(language); });
+            auto scenarioScan = StartStartupTask(
+                "scenario repository", [this, language]() { _scenarioRepository->Scan(language); });
+            auto titleSequenceScan = StartStartupTask("title sequences", []() { TitleSequenceManager::Scan(); });
+            auto objectCachePrune = StartStartupTask("object cache", []() { ObjectCache::Prune(); });
 
             if (!gOpenRCT2Headless)
             {
+                auto scope = _startupProfile.Measure("audio");
                 audio_init();
                 audio_populate_devices();
                 audio_init_ride_sounds_and_info();
@@ -448,19 +591,44 @@ namespace OpenRCT2
 
             network_set_env(_env);
             chat_init();
-            CopyOriginalUserFilesOver();
+            {
+                auto scope = _startupProfile.Measure("copy original user files");
+                CopyOriginalUserFilesOver();
+            }
 
+            bool graphicsLoaded = true;
             if (!gOpenRCT2NoGraphics)
             {
-                if (!LoadBaseGraphics())
+                auto scope = _startupProfile.Measure("base graphics");
+                graphicsLoaded = LoadBaseGraphics();
+#ifdef __ENABLE_LIGHTFX__
+                if (graphicsLoaded)
                 {
-                    return false;
+                    lightfx_init();
                 }
-#ifdef __ENABLE_LIGHTFX__
-                lightfx_init();
 #endif
             }
 
+            // Wait for all scans even if the graphics failed to load so that no scan outlives the context. The object
+            // cache must be pruned before the track design scan, which can load object images through it.
+            objectScan.get();
+            objectCachePrune.get();
+            if (graphicsLoaded)
+            {
+                // TODO Like objects, this can take a while if there are a lot of track designs
+                //      its also really something really we might want to do in the background
+                //      as its not required until the player wants to place a new ride.
+                auto scope = _startupProfile.Measure("track design repository");
+                _trackDesignRepository->Scan(language);
+            }
+            scenarioScan.get();
+            titleSequenceScan.get();
+            if (!graphicsLoaded)
+            {
+                return false;
+            }
+
+            auto scope = _startupProfile.Measure("game state");
             gScenarioTicks = 0;
             input_reset_place_obj_modifier();
             viewport_init_all();
@@ -473,6 +641,17 @@ namespace OpenRCT2
             return true;
         }
 
+        /**
+         * Runs the given startup phase on a new thread, measuring it in the startup profile.
+         */
+        template<typename TFunc> std::future<void> StartStartupTask(const char* name, TFunc func)
+        {
+            return std::async(std::launch::async, [this, name, func]() {
+                auto scope = _startupProfile.Measure(name);
+                func();
+            });
+        }
+
         void InitialiseDrawingEngine() final override
         {
             assert(_drawingEngine == nullptr);
@@ -572,81 +751,198 @@ namespace OpenRCT2
 
         bool LoadParkFromStream(IStream* stream, const std::string& path, bool loadTitleScreenFirstOnFail) final override
         {
-            try
+            CancelParkLoad();
+            return TryLoadPark(
+                [this, stream, &path]() { return ReadPark(stream, path, false); }, path, loadTitleScreenFirstOnFail);
+        }
+
+        bool LoadParkFromFileAsync(const std::string& path, std::function<void(bool)> callback) final override
+        {
+            if (_parkLoad != nullptr)
             {
-                ClassifiedFileInfo info;
-                if (!TryClassifyFile(stream, &info))
+                return false;
+            }
+
+            log_verbose("Context::LoadParkFromFileAsync(%s)", path.c_str());
+            _parkLoad = std::make_unique<PendingParkLoad>();
+            _parkLoad->Path = path;
+            _parkLoad->Callback = std::move(callback);
+            _parkLoad->Result = std::async(std::launch::async, [this, path, &load = *_parkLoad]() {
+                std::vector<uint8_t> data;
+                if (String::Equals(Path::GetExtension(path), ".sea", true))
                 {
-                    throw std::runtime_error("Unable to detect file type");
+                    data = DecryptSea(fs::u8path(path));
                 }
-
-                if (info.Type != FILE_TYPE::SAVED_GAME && info.Type != FILE_TYPE::SCENARIO)
+                else
                 {
-                    throw std::runtime_error("Invalid file type.");
+                    data = File::ReadAllBytes(path);
                 }
 
-                std::unique_ptr<IParkImporter> parkImporter;
-                if (info.Version <= FILE_TYPE_S4_CUTOFF)
+                auto ms = MemoryStream(data.data(), data.size(), MEMORY_ACCESS::READ);
+                auto park = ReadPark(&ms, path, true);
+                load.Stage = ParkLoadStage::ReadingObjects;
+                PrepareParkObjects(*park, load);
+                load.Stage = ParkLoadStage::Ready;
+                return park;
+            });
+            return true;
+        }
+
+        std::optional<ParkLoadProgress> GetParkLoadProgress() const final override
+        {
+            if (_parkLoad == nullptr)
+            {
+                return std::nullopt;
+            }
+            return ParkLoadProgress{ _parkLoad->Stage, _parkLoad->ObjectsRead, _parkLoad->ObjectCount };
+        }
+
+    private:
+        /**
+         * Reads and decompresses the park and finds the objects it uses. This does not change the game state, so it can
+         * run off the main thread if the packed objects are deferred, which keeps the object repository unchanged too.
+         */
+        std::unique_ptr<StagedPark> ReadPark(IStream* stream, const std::string& path, bool deferPackedObjects)
+        {
+            ClassifiedFileInfo info;
+            if (!TryClassifyFile(stream, &info))
+            {
+                throw std::runtime_error("Unable to detect file type");
+            }
+
+            if (info.Type != FILE_TYPE::SAVED_GAME && info.Type != FILE_TYPE::SCENARIO)
+            {
+                throw std::runtime_error("Invalid file type.");
+            }
+
+            auto park = std::make_unique<StagedPark>();
+            park->Path = path;
+            park->Type = info.Type;
+            if (info.Version <= FILE_TYPE_S4_CUTOFF)
+            {
+                // Save is an S4 (RCT1 format)
+                park->Importer = ParkImporter::CreateS4();
+            }
+            else
+            {
+                // Save is an S6 (RCT2 format)
+                park->Importer = ParkImporter::CreateS6(*_objectRepository);
+            }
+            if (deferPackedObjects)
+            {
+                park->Importer->DeferPackedObjects();
+            }
+
+            // The importer keeps a pointer to the path, which lives as long as the staged park
+            auto result = park->Importer->LoadFromStream(stream, info.Type == FILE_TYPE::SCENARIO, false, park->Path.c_str());
+            park->RequiredObjects = std::move(result.RequiredObjects);
+            return park;
+        }
+
+        /**
+         * Reads the objects of a staged park that are in the repository, so that loading them later only has to
+         * register them and allocate their images.
+         */
+        void PrepareParkObjects(StagedPark& park, PendingParkLoad& load)
+        {
+            // Objects can be added to the repository while these are read, which moves its items. Only copies of what
+            // is needed to read the objects are kept, rather than pointers to the items.
+            std::vector<ObjectRepositoryItem> items;
+            std::unordered_set<rct_object_entry, ObjectEntryHash, ObjectEntryEqual> foundEntries;
+            for (const auto& entry : park.RequiredObjects)
+            {
+                if (!object_entry_is_empty(&entry))
                 {
-                    // Save is an S4 (RCT1 format)
-                    parkImporter = ParkImporter::CreateS4();
+                    auto ori = _objectRepository->FindObject(&entry);
+                    if (ori != nullptr && foundEntries.insert(ori->ObjectEntry).second)
+                    {
+                        auto& item = items.emplace_back();
+                        item.ObjectEntry = ori->ObjectEntry;
+                        item.Path = ori->Path;
+                    }
                 }
-                else
+            }
+
+            load.ObjectCount = items.size();
+            for (const auto& item : items)
+            {
+                if (load.Cancelled)
                 {
-                    // Save is an S6 (RCT2 format)
-                    parkImporter = ParkImporter::CreateS6(*_objectRepository);
+                    break;
                 }
 
-                auto result = parkImporter->LoadFromStream(stream, info.Type == FILE_TYPE::SCENARIO, false, path.c_str());
-                _objectManager->LoadObjects(result.RequiredObjects.data(), result.RequiredObjects.size());
-                parkImporter->Import();
-                gScenarioSavePath = path;
-                gCurrentLoadedPath = path;
-                gFirstTimeSaving = true;
-                game_fix_save_vars();
-                AutoCreateMapAnimations();
-                sprite_position_tween_reset();
-                gScreenAge = 0;
-                gLastAutoSaveUpdate = AUTOSAVE_PAUSE;
+                auto object = std::unique_ptr<Object>(_objectRepository->LoadObject(&item));
+                if (object != nullptr)
+                {
+                    park.PreparedObjects.emplace(item.ObjectEntry, std::move(object));
+                }
+                load.ObjectsRead++;
+            }
+        }
 
-                bool sendMap = false;
-                if (info.Type == FILE_TYPE::SAVED_GAME)
+        /**
+         * Replaces the current park with the staged park. This must happen on the main thread between ticks.
+         */
+        void ApplyPark(StagedPark& park)
+        {
+            park.Importer->ExportPackedObjects();
+            _objectManager->LoadPreparedObjects(park.RequiredObjects.data(), park.RequiredObjects.size(), park.PreparedObjects);
+            park.Importer->Import();
+            gScenarioSavePath = park.Path;
+            gCurrentLoadedPath = park.Path;
+            gFirstTimeSaving = true;
+            game_fix_save_vars();
+            AutoCreateMapAnimations();
+            sprite_position_tween_reset();
+            gScreenAge = 0;
+            gLastAutoSaveUpdate = AUTOSAVE_PAUSE;
+
+            bool sendMap = false;
+            if (park.Type == FILE_TYPE::SAVED_GAME)
+            {
+                if (network_get_mode() == NETWORK_MODE_CLIENT)
                 {
-                    if (network_get_mode() == NETWORK_MODE_CLIENT)
-                    {
-                        network_close();
-                    }
-                    game_load_init();
-                    if (network_get_mode() == NETWORK_MODE_SERVER)
-                    {
-                        sendMap = true;
-                    }
+                    network_close();
                 }
-                else
+                game_load_init();
+                if (network_get_mode() == NETWORK_MODE_SERVER)
                 {
-                    scenario_begin();
-                    if (network_get_mode() == NETWORK_MODE_SERVER)
-                    {
-                        sendMap = true;
-                    }
-                    if (network_get_mode() == NETWORK_MODE_CLIENT)
-                    {
-                        network_close();
-                    }
+                    sendMap = true;
                 }
-                // This ensures that the newly loaded save reflects the user's
-                // 'show real names of guests' option, now that it's a global setting
-                peep_update_names(gConfigGeneral.show_real_names_of_guests);
-                if (sendMap)
+            }
+            else
+            {
+                scenario_begin();
+                if (network_get_mode() == NETWORK_MODE_SERVER)
                 {
-                    network_send_map();
+                    sendMap = true;
                 }
-#ifdef USE_BREAKPAD
-                if (network_get_mode() == NETWORK_MODE_NONE)
+                if (network_get_mode() == NETWORK_MODE_CLIENT)
                 {
-                    start_silent_record();
+                    network_close();
                 }
+            }
+            // This ensures that the newly loaded save reflects the user's
+            // 'show real names of guests' option, now that it's a global setting
+            peep_update_names(gConfigGeneral.show_real_names_of_guests);
+            if (sendMap)
+            {
+                network_send_map();
+            }
+#ifdef USE_BREAKPAD
+            if (network_get_mode() == NETWORK_MODE_NONE)
+            {
+                start_silent_record();
+            }
 #endif
+        }
+
+        template<typename TFunc> bool TryLoadPark(TFunc readPark, const std::string& path, bool loadTitleScreenFirstOnFail)
+        {
+            try
+            {
+                auto park = readPark();
+                ApplyPark(*park);
                 return true;
             }
             catch (const ObjectLoadException& e)
@@ -681,7 +977,38 @@ namespace OpenRCT2
             return false;
         }
 
-    private:
+        /**
+         * Replaces the current park with the park being loaded in the background once it has been read.
+         */
+        void UpdateParkLoad()
+        {
+            if (_parkLoad == nullptr || _parkLoad->Result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                return;
+            }
+
+            auto load = std::move(_parkLoad);
+            bool result = TryLoadPark([&load]() { return load->Result.get(); }, load->Path, false);
+            if (load->Callback != nullptr)
+            {
+                load->Callback(result);
+            }
+        }
+
+        void CancelParkLoad()
+        {
+            if (_parkLoad != nullptr)
+            {
+                auto load = std::move(_parkLoad);
+                load->Cancelled = true;
+                load->Result.wait();
+                if (load->Callback != nullptr)
+                {
+                    load->Callback(false);
+                }
+            }
+        }
+
         std::string GetOrPromptRCT2Path()
         {
             auto result = std::string();
@@ -743,6 +1070,7 @@ namespace OpenRCT2
                 }
             }
 
+            auto startupActionScope = _startupProfile.Measure("startup action");
             switch (gOpenRCT2StartupAction)
             {
                 case StartupAction::Intro:
@@ -850,6 +1178,12 @@ namespace OpenRCT2
                 network_begin_client(gNetworkStartHost, gNetworkStartPort);
             }
 #endif // DISABLE_NETWORK
+            startupActionScope.End();
+
+            if (gOpenRCT2StartupProfile)
+            {
+                _startupProfile.Print();
+            }
 
             _stdInOutConsole.Start();
             RunGameLoop();
@@ -1003,6 +1337,8 @@ namespace OpenRCT2
 
         void Update()
         {
+            UpdateParkLoad();
+
             uint32_t currentUpdateTime = platform_get_ticks();
 
             gCurrentDeltaTime = std::min<uint32_t>(currentUpdateTime - _lastUpdateTime, 500);
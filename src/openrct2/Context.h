@@ -12,7 +12,9 @@
 #include "common.h"
 #include "world/Location.hpp"
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 
 interface IObjectManager;
@@ -100,6 +102,20 @@ namespace OpenRCT2
         interface Painter;
     }
 
+    enum class ParkLoadStage : uint8_t
+    {
+        Reading,
+        ReadingObjects,
+        Ready,
+    };
+
+    struct ParkLoadProgress
+    {
+        ParkLoadStage Stage;
+        size_t ObjectsRead;
+        size_t ObjectCount;
+    };
+
     /**
      * Represents an instance of OpenRCT2 and can be used to get various services.
      */
@@ -133,6 +149,15 @@ namespace OpenRCT2
         virtual bool LoadParkFromFile(const std::string& path, bool loadTitleScreenOnFail = false) abstract;
         virtual bool LoadParkFromStream(IStream * stream, const std::string& path, bool loadTitleScreenFirstOnFail = false)
             abstract;
+
+        /**
+         * Starts loading the park from the given file in the background. The file is read and decompressed, and the
+         * objects it uses are read, on another thread while the game carries on; the park then replaces the current one
+         * at the start of a later tick and the callback is called with whether that succeeded. Returns false if a park is
+         * already being loaded.
+         */
+        virtual bool LoadParkFromFileAsync(const std::string& path, std::function<void(bool)> callback) abstract;
+        virtual std::optional<ParkLoadProgress> GetParkLoadProgress() const abstract;
         virtual void WriteLine(const std::string& s) abstract;
         virtual void Finish() abstract;
         virtual void Quit() abstract;
@@ -550,6 +550,9 @@ void game_load_init()
 
     IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
     snapshots->Reset();
+    park_statistics_invalidate();
+    map_active_tiles_invalidate();
+    footpath_clear_queued_wide_flags();
 
     gScreenFlags = SCREEN_FLAGS_PLAYING;
     audio_stop_all_music_and_sounds();
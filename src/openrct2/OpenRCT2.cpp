@@ -24,6 +24,7 @@ bool gOpenRCT2NoGraphics = false;
 
 bool gOpenRCT2ShowChangelog;
 bool gOpenRCT2SilentBreakpad;
+bool gOpenRCT2StartupProfile = false;
 
 uint32_t gCurrentDrawCount = 0;
 uint8_t gScreenFlags;
@@ -59,6 +59,18 @@ public:
 
     virtual void Import() abstract;
     virtual bool GetDetails(scenario_index_entry * dst) abstract;
+
+    /**
+     * Makes LoadFromStream keep the objects packed into the park in memory instead of adding them to the object
+     * repository straight away, so that it can run off the main thread. ExportPackedObjects then adds them, which must
+     * happen before the park's objects are loaded.
+     */
+    virtual void DeferPackedObjects()
+    {
+    }
+    virtual void ExportPackedObjects()
+    {
+    }
 };
 
 namespace ParkImporter
@@ -100,6 +100,10 @@ public:
             map_invalidate_tile_full(_loc);
             tile_element_remove(footpathElement);
             footpath_update_queue_chains();
+            if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
+            {
+                footpath_queue_wide_flags_update(_loc);
+            }
 
             // Remove the spawn point (if there is one in the current tile)
             gPeepSpawns.erase(
@@ -192,6 +192,7 @@ public:
 
         pathElement->SetAddition(_pathItemType);
         pathElement->SetIsBroken(false);
+        map_active_tiles_mark(_loc);
         if (_pathItemType != 0)
         {
             rct_scenery_entry* scenery_entry = get_footpath_item_entry(_pathItemType - 1);
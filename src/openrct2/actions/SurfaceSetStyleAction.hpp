@@ -223,6 +223,7 @@ public:
                             surfaceCost += surfaceObject->Price;
 
                             surfaceElement->SetSurfaceStyle(_surfaceStyle);
+                            map_active_tiles_mark(coords);
 
                             map_invalidate_tile_full(coords);
                             footpath_remove_litter({ coords, tile_element_height(coords) });
@@ -21,6 +21,8 @@
 using namespace OpenRCT2;
 using namespace OpenRCT2::Audio;
 
+int32_t (*gMixerBenchmark)(int32_t numChannels, int32_t iterations) = nullptr;
+
 static IAudioMixer* GetMixer()
 {
     auto audioContext = GetContext()->GetAudioContext();
@@ -57,6 +57,12 @@ namespace OpenRCT2::Audio
 #    define DSBPAN_RIGHT 10000
 #endif
 
+/**
+ * Mixes the given number of channels for the given number of chunks and prints the timings. Set by the UI, which owns
+ * the SDL audio mixer, and left as nullptr in builds without one.
+ */
+extern int32_t (*gMixerBenchmark)(int32_t numChannels, int32_t iterations);
+
 void Mixer_Init(const char* device);
 void* Mixer_Play_Effect(SoundId id, int32_t loop, int32_t volume, float pan, double rate, int32_t deleteondone);
 void Mixer_Stop_Channel(void* channel);
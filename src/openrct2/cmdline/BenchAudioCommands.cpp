@@ -0,0 +1,46 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../audio/AudioMixer.h"
+#include "../core/Console.hpp"
+#include "CommandLine.hpp"
+
+static exitcode_t HandleBenchAudio(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::BenchAudioCommands[]{
+    // Main commands
+    DefineCommand("", "[channels count] [iterations count]", nullptr, HandleBenchAudio), CommandTableEnd
+};
+
+static exitcode_t HandleBenchAudio(CommandLineArgEnumerator* argEnumerator)
+{
+    if (gMixerBenchmark == nullptr)
+    {
+        Console::Error::WriteLine("The audio mixer benchmark is not available in this build.");
+        return EXITCODE_FAIL;
+    }
+
+    int32_t numChannels = 32;
+    int32_t iterations = 1000;
+    if (argEnumerator->TryPopInteger(&numChannels))
+    {
+        argEnumerator->TryPopInteger(&iterations);
+    }
+    if (numChannels <= 0 || iterations <= 0)
+    {
+        Console::Error::WriteLine("Channels and iterations count must be greater than zero.");
+        return EXITCODE_FAIL;
+    }
+
+    if (gMixerBenchmark(numChannels, iterations) < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
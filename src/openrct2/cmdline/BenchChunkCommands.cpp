@@ -0,0 +1,203 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/FileScanner.h"
+#include "../core/MemoryStream.h"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
+#include "../rct12/SawyerChunkReader.h"
+#include "../scenario/Scenario.h"
+#include "CommandLine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+static constexpr int32_t BENCH_CHUNK_ITERATIONS = 20;
+
+static exitcode_t HandleBenchChunk(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::BenchChunkCommands[]{
+    // Main commands
+    DefineCommand("", "<file or directory>...", nullptr, HandleBenchChunk), CommandTableEnd
+};
+
+struct BenchChunk
+{
+    uint64_t Offset;
+    size_t Length;
+    bool Track;
+};
+
+static std::vector<std::string> BenchChunkGetFiles(CommandLineArgEnumerator* argEnumerator)
+{
+    std::vector<std::string> files;
+    const char* path;
+    while (argEnumerator->TryPopString(&path))
+    {
+        if (Path::DirectoryExists(path))
+        {
+            auto pattern = Path::Combine(path, "*.sv6;*.sc6;*.td6");
+            auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(pattern, true));
+            std::vector<std::string> directoryFiles;
+            while (scanner->Next())
+            {
+                directoryFiles.emplace_back(scanner->GetPath());
+            }
+            std::sort(directoryFiles.begin(), directoryFiles.end());
+            files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+        }
+        else
+        {
+            files.emplace_back(path);
+        }
+    }
+    return files;
+}
+
+/**
+ * Reads every chunk of a park, scenario or track design once to find where each one starts and how long it is.
+ */
+static std::vector<BenchChunk> BenchChunkGetChunks(MemoryStream& stream, bool isTrackDesign)
+{
+    std::vector<BenchChunk> chunks;
+    SawyerChunkReader reader(&stream);
+    if (isTrackDesign)
+    {
+        auto chunk = reader.ReadChunkTrack();
+        chunks.push_back({ 0, chunk->GetLength(), true });
+        return chunks;
+    }
+
+    auto readChunk = [&]() {
+        auto offset = stream.GetPosition();
+        auto chunk = reader.ReadChunk();
+        chunks.push_back({ offset, chunk->GetLength(), false });
+        return chunk;
+    };
+
+    auto headerChunk = readChunk();
+    if (headerChunk->GetLength() < sizeof(rct_s6_header))
+    {
+        throw IOException("Invalid park header.");
+    }
+    auto header = *static_cast<const rct_s6_header*>(headerChunk->GetData());
+    if (header.type == S6_TYPE_SCENARIO)
+    {
+        readChunk();
+    }
+    for (uint16_t i = 0; i < header.num_packed_objects; i++)
+    {
+        stream.Seek(sizeof(rct_object_entry), STREAM_SEEK_CURRENT);
+        readChunk();
+    }
+
+    // The last 4 bytes are the checksum
+    while (stream.GetPosition() + 4 < stream.GetLength())
+    {
+        readChunk();
+    }
+    return chunks;
+}
+
+/**
+ * Decodes the chunks either into chunk buffers or straight into a destination the length of each chunk, returning the
+ * time taken in seconds. Track designs can only be decoded into chunk buffers.
+ */
+static double BenchChunkDecode(MemoryStream& stream, const std::vector<BenchChunk>& chunks, bool direct, int32_t iterations)
+{
+    size_t maxLength = 0;
+    for (const auto& chunk : chunks)
+    {
+        maxLength = std::max(maxLength, chunk.Length);
+    }
+    std::vector<uint8_t> buffer(maxLength);
+
+    SawyerChunkReader reader(&stream);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (int32_t i = 0; i < iterations; i++)
+    {
+        for (const auto& chunk : chunks)
+        {
+            stream.SetPosition(chunk.Offset);
+            if (chunk.Track)
+            {
+                reader.ReadChunkTrack();
+            }
+            else if (direct)
+            {
+                reader.ReadChunk(buffer.data(), chunk.Length);
+            }
+            else
+            {
+                reader.ReadChunk();
+            }
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+static exitcode_t HandleBenchChunk(CommandLineArgEnumerator* argEnumerator)
+{
+    auto files = BenchChunkGetFiles(argEnumerator);
+    if (files.empty())
+    {
+        Console::Error::WriteLine("Expected at least one park, scenario or track design file or a directory of them.");
+        return EXITCODE_FAIL;
+    }
+
+    exitcode_t result = EXITCODE_OK;
+    double totalMiB = 0;
+    double totalBufferedTime = 0;
+    double totalDirectTime = 0;
+    for (const auto& path : files)
+    {
+        try
+        {
+            // Decode from memory so that the file system is not measured
+            auto data = File::ReadAllBytes(path);
+            MemoryStream stream(data.data(), data.size());
+            auto isTrackDesign = String::Equals(Path::GetExtension(path), ".td6", true);
+            auto chunks = BenchChunkGetChunks(stream, isTrackDesign);
+
+            size_t decodedLength = 0;
+            for (const auto& chunk : chunks)
+            {
+                decodedLength += chunk.Length;
+            }
+            auto decodedMiB = static_cast<double>(decodedLength) * BENCH_CHUNK_ITERATIONS / (1024 * 1024);
+            auto bufferedTime = BenchChunkDecode(stream, chunks, false, BENCH_CHUNK_ITERATIONS);
+            auto directTime = BenchChunkDecode(stream, chunks, true, BENCH_CHUNK_ITERATIONS);
+            Console::WriteLine(
+                "%s: %zu chunks, %zu bytes, buffered %.1f MiB/s, direct %.1f MiB/s", path.c_str(), chunks.size(),
+                decodedLength, decodedMiB / bufferedTime, decodedMiB / directTime);
+
+            totalMiB += decodedMiB;
+            totalBufferedTime += bufferedTime;
+            totalDirectTime += directTime;
+        }
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("Unable to read %s: %s", path.c_str(), e.what());
+            result = EXITCODE_FAIL;
+        }
+    }
+
+    if (totalMiB > 0)
+    {
+        Console::WriteLine(
+            "Total: buffered %.1f MiB/s, direct %.1f MiB/s", totalMiB / totalBufferedTime, totalMiB / totalDirectTime);
+    }
+    return result;
+}
@@ -10,11 +10,30 @@
 #include "../interface/Screenshot.h"
 #include "CommandLine.hpp"
 
+static BenchGfxSuiteOptions _suiteOptions;
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition BenchGfxSuiteOptionsDef[]
+{
+    { CMDLINE_TYPE_INTEGER, &_suiteOptions.iterations,  NAC, "iterations",  "number of times each view is rendered (default 1)" },
+    { CMDLINE_TYPE_STRING,  &_suiteOptions.output,      NAC, "output",      "path of a JSON file to write the results to" },
+    { CMDLINE_TYPE_STRING,  &_suiteOptions.save_images, NAC, "save-images", "directory to save the rendered images to" },
+    { CMDLINE_TYPE_STRING,  &_suiteOptions.compare,     NAC, "compare",     "directory of images saved by another build to compare with" },
+    OptionTableEnd
+};
+// clang-format on
+
 static exitcode_t HandleBenchGfx(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleBenchGfxBlend(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleBenchGfxLightFX(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleBenchGfxSuite(CommandLineArgEnumerator* argEnumerator);
 
 const CommandLineCommand CommandLine::BenchGfxCommands[]{
     // Main commands
-    DefineCommand("", "<file> [iterations count]", nullptr, HandleBenchGfx), CommandTableEnd
+    DefineCommand("", "<file> [iterations count]", nullptr, HandleBenchGfx),
+    DefineCommand("blend", "<file> [iterations count]", nullptr, HandleBenchGfxBlend),
+    DefineCommand("lightfx", "<file> [iterations count]", nullptr, HandleBenchGfxLightFX),
+    DefineCommand("suite", "<file or directory>...", BenchGfxSuiteOptionsDef, HandleBenchGfxSuite), CommandTableEnd
 };
 
 static exitcode_t HandleBenchGfx(CommandLineArgEnumerator* argEnumerator)
@@ -28,3 +47,39 @@ static exitcode_t HandleBenchGfx(CommandLineArgEnumerator* argEnumerator)
     }
     return EXITCODE_OK;
 }
+
+static exitcode_t HandleBenchGfxBlend(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_gfxbench_blend(argv, argc);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+static exitcode_t HandleBenchGfxLightFX(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_gfxbench_lightfx(argv, argc);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+static exitcode_t HandleBenchGfxSuite(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_gfxbench_suite(argv, argc, &_suiteOptions);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
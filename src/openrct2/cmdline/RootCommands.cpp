@@ -58,6 +58,7 @@ static utf8* _openrct2DataPath = nullptr;
 static utf8* _rct1DataPath = nullptr;
 static utf8* _rct2DataPath = nullptr;
 static bool _silentBreakpad = false;
+static bool _startupProfile = false;
 
 // clang-format off
 static constexpr const CommandLineOptionDefinition StandardOptions[]
@@ -69,6 +70,7 @@ static constexpr const CommandLineOptionDefinition StandardOptions[]
     { CMDLINE_TYPE_SWITCH,  &_about,            NAC, "about",              "show information about " OPENRCT2_NAME                      },
     { CMDLINE_TYPE_SWITCH,  &_verbose,          NAC, "verbose",            "log verbose messages"                                       },
     { CMDLINE_TYPE_SWITCH,  &_headless,         NAC, "headless",           "run " OPENRCT2_NAME " headless" IMPLIES_SILENT_BREAKPAD     },
+    { CMDLINE_TYPE_SWITCH,  &_startupProfile,   NAC, "startup-profile",    "print a timeline of the startup phases once started"        },
 #ifndef DISABLE_NETWORK                                                    
     { CMDLINE_TYPE_INTEGER, &_port,             NAC, "port",               "port to use for hosting or joining a server"                },
     { CMDLINE_TYPE_STRING,  &_address,          NAC, "address",            "address to listen on when hosting a server"                 },
@@ -140,6 +142,8 @@ const CommandLineCommand CommandLine::RootCommands[]
     DefineSubCommand("sprite",          CommandLine::SpriteCommands           ),
     DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
     DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
+    DefineSubCommand("benchaudio",      CommandLine::BenchAudioCommands       ),
+    DefineSubCommand("benchchunk",      CommandLine::BenchChunkCommands       ),
     DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
     CommandTableEnd
 };
@@ -195,6 +199,7 @@ exitcode_t CommandLine::HandleCommandDefault()
     gOpenRCT2Headless = _headless;
     gOpenRCT2NoGraphics = _headless;
     gOpenRCT2SilentBreakpad = _silentBreakpad || _headless;
+    gOpenRCT2StartupProfile = _startupProfile;
 
     if (_userDataPath != nullptr)
     {
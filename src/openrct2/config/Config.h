@@ -44,6 +44,7 @@ struct GeneralConfiguration
     bool enable_light_fx;
     bool enable_light_fx_for_vehicles;
     bool upper_case_banners;
+    int32_t scrolling_text_cache_size;
     bool render_weather_effects;
     bool render_weather_gloom;
     bool disable_lightning_effect;
@@ -246,5 +247,5 @@ std::string FindCsg1datAtLocation(const utf8* path);
 bool Csg1datPresentAtLocation(const utf8* path);
 std::string FindCsg1idatAtLocation(const utf8* path);
 bool Csg1idatPresentAtLocation(const utf8* path);
-bool CsgIsUsable(rct_gx csg);
+bool CsgIsUsable(const rct_gx& csg);
 bool CsgAtLocationIsUsable(const utf8* path);
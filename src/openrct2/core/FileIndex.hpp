@@ -18,34 +18,37 @@
 #include "Path.hpp"
 
 #include <chrono>
-#include <list>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 template<typename TItem> class FileIndex
 {
-private:
-    struct DirectoryStats
+protected:
+    struct ScannedFile
     {
-        uint32_t TotalFiles = 0;
-        uint64_t TotalFileSize = 0;
-        uint32_t FileDateModifiedChecksum = 0;
-        uint32_t PathChecksum = 0;
+        std::string Path;
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
     };
 
-    struct ScanResult
+    /**
+     * What the index knows about a file: its size and modification date when it was indexed and the item created from
+     * it, if any. Files that did not produce an item are kept too so that they are not loaded again on every start.
+     */
+    struct FileRecord
     {
-        DirectoryStats const Stats;
-        std::vector<std::string> const Files;
-
-        ScanResult(DirectoryStats stats, std::vector<std::string> files)
-            : Stats(stats)
-            , Files(files)
-        {
-        }
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
+        std::optional<TItem> Item;
     };
 
+    using FileRecordMap = std::unordered_map<std::string, FileRecord>;
+
+private:
     struct FileIndexHeader
     {
         uint32_t HeaderSize = sizeof(FileIndexHeader);
@@ -53,13 +56,13 @@ private:
         uint8_t VersionA = 0;
         uint8_t VersionB = 0;
         uint16_t LanguageId = 0;
-        DirectoryStats Stats;
-        uint32_t NumItems = 0;
+        uint32_t NumFiles = 0;
     };
 
     // Index file format version which when incremented forces a rebuild
-    static constexpr uint8_t FILE_INDEX_VERSION = 4;
+    static constexpr uint8_t FILE_INDEX_VERSION = 5;
 
+protected:
     std::string const _name;
     uint32_t const _magicNumber;
     uint8_t const _version;
@@ -94,32 +97,21 @@ public:
     virtual ~FileIndex() = default;
 
     /**
-     * Queries and directories and loads the index header. If the index is up to date,
-     * the items are loaded from the index and returned, otherwise the index is rebuilt.
+     * Queries the directories and loads the index. Items of files that have not changed since they were indexed are
+     * taken from the index, only files that have been added or modified are loaded again.
+     * @param outIndexUpToDate Set to whether the index file on disk matches the returned items.
      */
-    std::vector<TItem> LoadOrBuild(int32_t language) const
+    std::vector<TItem> LoadOrBuild(int32_t language, bool* outIndexUpToDate = nullptr) const
     {
-        std::vector<TItem> items;
-        auto scanResult = Scan();
-        auto readIndexResult = ReadIndexFile(language, scanResult.Stats);
-        if (std::get<0>(readIndexResult))
-        {
-            // Index was loaded
-            items = std::get<1>(readIndexResult);
-        }
-        else
-        {
-            // Index was not loaded
-            items = Build(language, scanResult);
-        }
-        return items;
+        auto files = Scan();
+        auto records = ReadIndexFile(language);
+        return Build(language, files, records, outIndexUpToDate);
     }
 
-    std::vector<TItem> Rebuild(int32_t language) const
+    std::vector<TItem> Rebuild(int32_t language, bool* outIndexUpToDate = nullptr) const
     {
-        auto scanResult = Scan();
-        auto items = Build(language, scanResult);
-        return items;
+        auto files = Scan();
+        return Build(language, files, std::nullopt, outIndexUpToDate);
     }
 
 protected:
@@ -130,20 +122,24 @@ protected:
     virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
 
     /**
-     * Serialises an index item to the given stream.
+     * Serialises an index item to the given stream. Not used if the index overrides how its file is read and written.
      */
-    virtual void Serialise(IStream* stream, const TItem& item) const abstract;
+    virtual void Serialise([[maybe_unused]] IStream* stream, [[maybe_unused]] const TItem& item) const
+    {
+        throw std::logic_error("FileIndex::Serialise not implemented");
+    }
 
     /**
-     * Deserialises an index item from the given stream.
+     * Deserialises an index item from the given stream. Not used if the index overrides how its file is read and written.
      */
-    virtual TItem Deserialise(IStream* stream) const abstract;
+    virtual TItem Deserialise([[maybe_unused]] IStream* stream) const
+    {
+        throw std::logic_error("FileIndex::Deserialise not implemented");
+    }
 
-private:
-    ScanResult Scan() const
+    std::vector<ScannedFile> Scan() const
     {
-        DirectoryStats stats{};
-        std::vector<std::string> files;
+        std::vector<ScannedFile> files;
         for (const auto& directory : SearchPaths)
         {
             auto absoluteDirectory = Path::GetAbsolute(directory);
@@ -154,30 +150,22 @@ private:
             while (scanner->Next())
             {
                 auto fileInfo = scanner->GetFileInfo();
-                auto path = std::string(scanner->GetPath());
-
-                files.push_back(path);
-
-                stats.TotalFiles++;
-                stats.TotalFileSize += fileInfo->Size;
-                stats.FileDateModifiedChecksum ^= static_cast<uint32_t>(fileInfo->LastModified >> 32)
-                    ^ static_cast<uint32_t>(fileInfo->LastModified & 0xFFFFFFFF);
-                stats.FileDateModifiedChecksum = ror32(stats.FileDateModifiedChecksum, 5);
-                stats.PathChecksum += GetPathChecksum(path);
+                files.push_back({ scanner->GetPath(), fileInfo->Size, fileInfo->LastModified });
             }
             delete scanner;
         }
-        return ScanResult(stats, files);
+        return files;
     }
 
+private:
     void BuildRange(
-        int32_t language, const ScanResult& scanResult, size_t rangeStart, size_t rangeEnd, std::vector<TItem>& items,
-        std::atomic<size_t>& processed, std::mutex& printLock) const
+        int32_t language, const std::vector<ScannedFile>& files, const std::vector<size_t>& pending, size_t rangeStart,
+        size_t rangeEnd, std::vector<FileRecord>& records, std::atomic<size_t>& processed, std::mutex& printLock) const
     {
-        items.reserve(rangeEnd - rangeStart);
         for (size_t i = rangeStart; i < rangeEnd; i++)
         {
-            const auto& filePath = scanResult.Files.at(i);
+            const auto fileIndex = pending[i];
+            const auto& filePath = files[fileIndex].Path;
 
             if (_log_levels[DIAGNOSTIC_LEVEL_VERBOSE])
             {
@@ -188,28 +176,71 @@ private:
             auto item = Create(language, filePath);
             if (std::get<0>(item))
             {
-                items.push_back(std::get<1>(item));
+                records[fileIndex].Item = std::move(std::get<1>(item));
             }
 
             processed++;
         }
     }
 
-    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult) const
+protected:
+    /**
+     * Creates the items of every scanned file that is not in the given index records or has changed since it was
+     * indexed. Records of files that no longer exist are dropped. The index file is only written if anything changed.
+     * @param outIndexUpToDate Set to false if the index file had to be written but could not be.
+     */
+    std::vector<TItem> Build(
+        int32_t language, const std::vector<ScannedFile>& files, std::optional<FileRecordMap> indexRecords,
+        bool* outIndexUpToDate = nullptr) const
     {
-        std::vector<TItem> allItems;
-        Console::WriteLine("Building %s (%zu items)", _name.c_str(), scanResult.Files.size());
-
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        const size_t totalCount = scanResult.Files.size();
+        std::vector<FileRecord> records(files.size());
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            const auto& file = files[i];
+            auto& record = records[i];
+            record.Size = file.Size;
+            record.LastModified = file.LastModified;
+
+            if (indexRecords)
+            {
+                // Found records are taken out, so that a file scanned twice is only matched once and only the records
+                // of removed files are left
+                auto itr = indexRecords->find(file.Path);
+                if (itr != indexRecords->end())
+                {
+                    auto indexRecord = std::move(itr->second);
+                    indexRecords->erase(itr);
+                    if (indexRecord.Size == file.Size && indexRecord.LastModified == file.LastModified)
+                    {
+                        record.Item = std::move(indexRecord.Item);
+                        continue;
+                    }
+                }
+            }
+            pending.push_back(i);
+        }
+
+        // Any file in the index that was not found by the scan has been removed
+        const size_t removedCount = indexRecords ? indexRecords->size() : 0;
+        if (!indexRecords)
+        {
+            Console::WriteLine("Building %s (%zu items)", _name.c_str(), files.size());
+        }
+        else if (!pending.empty() || removedCount > 0)
+        {
+            Console::WriteLine(
+                "Updating %s (%zu new or modified, %zu removed)", _name.c_str(), pending.size(), removedCount);
+        }
+
+        const size_t totalCount = pending.size();
         if (totalCount > 0)
         {
             JobPool jobPool;
             std::mutex printLock; // For verbose prints.
 
-            std::list<std::vector<TItem>> containers;
-
             size_t stepSize = 100; // Handpicked, seems to work well with 4/8 cores.
 
             std::atomic<size_t> processed = ATOMIC_VAR_INIT(0);
@@ -226,75 +257,95 @@ private:
                     stepSize = totalCount - rangeStart;
                 }
 
-                auto& items = containers.emplace_back();
-
                 jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                    &FileIndex<TItem>::BuildRange, this, language, std::cref(files), std::cref(pending), rangeStart,
+                    rangeStart + stepSize, std::ref(records), std::ref(processed), std::ref(printLock)));
 
                 reportProgress();
             }
 
             jobPool.Join(reportProgress);
-
-            for (auto&& itr : containers)
-            {
-                allItems.insert(allItems.end(), itr.begin(), itr.end());
-            }
         }
 
-        WriteIndexFile(language, scanResult.Stats, allItems);
+        bool indexUpToDate = true;
+        if (!indexRecords || totalCount > 0 || removedCount > 0)
+        {
+            indexUpToDate = WriteIndexFile(language, files, records);
 
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration<float>(endTime - startTime);
-        Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration<float>(endTime - startTime);
+            Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
+        }
+        if (outIndexUpToDate != nullptr)
+        {
+            *outIndexUpToDate = indexUpToDate;
+        }
 
+        std::vector<TItem> allItems;
+        allItems.reserve(records.size());
+        for (auto& record : records)
+        {
+            if (record.Item)
+            {
+                allItems.push_back(std::move(*record.Item));
+            }
+        }
         return allItems;
     }
 
-    std::tuple<bool, std::vector<TItem>> ReadIndexFile(int32_t language, const DirectoryStats& stats) const
+    /**
+     * Reads the records of every file in the index, or nothing if the index does not exist or was written by a
+     * different version or for a different language.
+     */
+    virtual std::optional<FileRecordMap> ReadIndexFile(int32_t language) const
     {
-        bool loadedItems = false;
-        std::vector<TItem> items;
-        if (File::Exists(_indexPath))
+        if (!File::Exists(_indexPath))
+        {
+            return std::nullopt;
+        }
+
+        try
         {
-            try
+            log_verbose("FileIndex:Loading index: '%s'", _indexPath.c_str());
+            auto fs = FileStream(_indexPath, FILE_MODE_OPEN);
+
+            auto header = fs.ReadValue<FileIndexHeader>();
+            if (header.HeaderSize != sizeof(FileIndexHeader) || header.MagicNumber != _magicNumber
+                || header.VersionA != FILE_INDEX_VERSION || header.VersionB != _version || header.LanguageId != language)
             {
-                log_verbose("FileIndex:Loading index: '%s'", _indexPath.c_str());
-                auto fs = FileStream(_indexPath, FILE_MODE_OPEN);
-
-                // Read header, check if we need to re-scan
-                auto header = fs.ReadValue<FileIndexHeader>();
-                if (header.HeaderSize == sizeof(FileIndexHeader) && header.MagicNumber == _magicNumber
-                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language
-                    && header.Stats.TotalFiles == stats.TotalFiles && header.Stats.TotalFileSize == stats.TotalFileSize
-                    && header.Stats.FileDateModifiedChecksum == stats.FileDateModifiedChecksum
-                    && header.Stats.PathChecksum == stats.PathChecksum)
-                {
-                    items.reserve(header.NumItems);
-                    // Directory is the same, just read the saved items
-                    for (uint32_t i = 0; i < header.NumItems; i++)
-                    {
-                        auto item = Deserialise(&fs);
-                        items.push_back(item);
-                    }
-                    loadedItems = true;
-                }
-                else
-                {
-                    Console::WriteLine("%s out of date", _name.c_str());
-                }
+                Console::WriteLine("%s out of date", _name.c_str());
+                return std::nullopt;
             }
-            catch (const std::exception& e)
+
+            FileRecordMap records;
+            records.reserve(header.NumFiles);
+            for (uint32_t i = 0; i < header.NumFiles; i++)
             {
-                Console::Error::WriteLine("Unable to load index: '%s'.", _indexPath.c_str());
-                Console::Error::WriteLine("%s", e.what());
+                auto path = fs.ReadStdString();
+                FileRecord record;
+                record.Size = fs.ReadValue<uint64_t>();
+                record.LastModified = fs.ReadValue<uint64_t>();
+                if (fs.ReadValue<uint8_t>() != 0)
+                {
+                    record.Item = Deserialise(&fs);
+                }
+                records.emplace(std::move(path), std::move(record));
             }
+            return records;
         }
-        return std::make_tuple(loadedItems, items);
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("Unable to load index: '%s'.", _indexPath.c_str());
+            Console::Error::WriteLine("%s", e.what());
+        }
+        return std::nullopt;
     }
 
-    void WriteIndexFile(int32_t language, const DirectoryStats& stats, const std::vector<TItem>& items) const
+    /**
+     * Writes the records of every scanned file to the index file, returning false if it could not be written.
+     */
+    virtual bool WriteIndexFile(
+        int32_t language, const std::vector<ScannedFile>& files, const std::vector<FileRecord>& records) const
     {
         try
         {
@@ -308,35 +359,29 @@ private:
             header.VersionA = FILE_INDEX_VERSION;
             header.VersionB = _version;
             header.LanguageId = language;
-            header.Stats = stats;
-            header.NumItems = static_cast<uint32_t>(items.size());
+            header.NumFiles = static_cast<uint32_t>(files.size());
             fs.WriteValue(header);
 
-            // Write items
-            for (const auto& item : items)
+            // Write a record for every file
+            for (size_t i = 0; i < files.size(); i++)
             {
-                Serialise(&fs, item);
+                const auto& record = records[i];
+                fs.WriteString(files[i].Path);
+                fs.WriteValue<uint64_t>(record.Size);
+                fs.WriteValue<uint64_t>(record.LastModified);
+                fs.WriteValue<uint8_t>(record.Item ? 1 : 0);
+                if (record.Item)
+                {
+                    Serialise(&fs, *record.Item);
+                }
             }
+            return true;
         }
         catch (const std::exception& e)
         {
             Console::Error::WriteLine("Unable to save index: '%s'.", _indexPath.c_str());
             Console::Error::WriteLine("%s", e.what());
+            return false;
         }
     }
-
-    static uint32_t GetPathChecksum(const std::string& path)
-    {
-        uint32_t hash = 0xD8430DED;
-        for (const utf8* ch = path.c_str(); *ch != '\0'; ch++)
-        {
-            hash += (*ch);
-            hash += (hash << 10);
-            hash ^= (hash >> 6);
-        }
-        hash += (hash << 3);
-        hash ^= (hash >> 11);
-        hash += (hash << 15);
-        return hash;
-    }
 };
@@ -162,92 +162,204 @@ namespace Imaging
         }
     }
 
-    static void WritePng(std::ostream& ostream, const Image& image)
+    /**
+     * Writes the header of a PNG image on construction and then any number of rows at a time.
+     */
+    class PngWriter
     {
-        png_structp png_ptr = nullptr;
-        png_colorp png_palette = nullptr;
-        try
+    private:
+        png_structp _png = nullptr;
+        png_infop _info = nullptr;
+        png_colorp _palette = nullptr;
+        uint32_t _height{};
+        uint32_t _rowsWritten{};
+
+    public:
+        PngWriter(std::ostream& ostream, const Image& image)
+            : _height(image.Height)
         {
-            png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
-            if (png_ptr == nullptr)
+            try
             {
-                throw std::runtime_error("png_create_write_struct failed.");
-            }
+                _png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
+                if (_png == nullptr)
+                {
+                    throw std::runtime_error("png_create_write_struct failed.");
+                }
 
-            png_text text_ptr[1];
-            text_ptr[0].key = const_cast<char*>("Software");
-            text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
-            text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
+                png_text text_ptr[1];
+                text_ptr[0].key = const_cast<char*>("Software");
+                text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
+                text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
 
-            auto info_ptr = png_create_info_struct(png_ptr);
-            if (info_ptr == nullptr)
-            {
-                throw std::runtime_error("png_create_info_struct failed.");
-            }
+                _info = png_create_info_struct(_png);
+                if (_info == nullptr)
+                {
+                    throw std::runtime_error("png_create_info_struct failed.");
+                }
 
-            if (image.Depth == 8)
-            {
-                if (image.Palette == nullptr)
+                if (image.Depth == 8)
                 {
-                    throw std::runtime_error("Expected a palette for 8-bit image.");
+                    if (image.Palette == nullptr)
+                    {
+                        throw std::runtime_error("Expected a palette for 8-bit image.");
+                    }
+
+                    // Set the palette
+                    _palette = static_cast<png_colorp>(png_malloc(_png, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
+                    if (_palette == nullptr)
+                    {
+                        throw std::runtime_error("png_malloc failed.");
+                    }
+                    for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
+                    {
+                        const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
+                        _palette[i].blue = entry.Blue;
+                        _palette[i].green = entry.Green;
+                        _palette[i].red = entry.Red;
+                    }
+                    png_set_PLTE(_png, _info, _palette, PNG_MAX_PALETTE_LENGTH);
                 }
 
-                // Set the palette
-                png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
-                if (png_palette == nullptr)
+                png_set_write_fn(_png, &ostream, PngWriteData, PngFlush);
+
+                // Set error handler
+                if (setjmp(png_jmpbuf(_png)))
                 {
-                    throw std::runtime_error("png_malloc failed.");
+                    throw std::runtime_error("PNG ERROR");
                 }
-                for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
+
+                // Write header
+                auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
+                if (image.Depth == 8)
                 {
-                    const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
-                    png_palette[i].blue = entry.Blue;
-                    png_palette[i].green = entry.Green;
-                    png_palette[i].red = entry.Red;
+                    png_byte transparentIndex = 0;
+                    png_set_tRNS(_png, _info, &transparentIndex, 1, nullptr);
+                    colourType = PNG_COLOR_TYPE_PALETTE;
                 }
-                png_set_PLTE(png_ptr, info_ptr, png_palette, PNG_MAX_PALETTE_LENGTH);
+                png_set_text(_png, _info, text_ptr, 1);
+                png_set_IHDR(
+                    _png, _info, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                    PNG_FILTER_TYPE_DEFAULT);
+                png_write_info(_png, _info);
             }
+            catch (const std::exception&)
+            {
+                Destroy();
+                throw;
+            }
+        }
 
-            png_set_write_fn(png_ptr, &ostream, PngWriteData, PngFlush);
+        PngWriter(const PngWriter&) = delete;
+        PngWriter& operator=(const PngWriter&) = delete;
+
+        ~PngWriter()
+        {
+            Destroy();
+        }
+
+        void WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride)
+        {
+            if (_rowsWritten + numRows > _height)
+            {
+                throw std::out_of_range("Attempted to write more rows than the image height.");
+            }
 
             // Set error handler
-            if (setjmp(png_jmpbuf(png_ptr)))
+            if (setjmp(png_jmpbuf(_png)))
             {
                 throw std::runtime_error("PNG ERROR");
             }
 
-            // Write header
-            auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
-            if (image.Depth == 8)
+            for (uint32_t y = 0; y < numRows; y++)
+            {
+                png_write_row(_png, const_cast<png_byte*>(pixels));
+                pixels += stride;
+            }
+            _rowsWritten += numRows;
+        }
+
+        void Finish()
+        {
+            if (_rowsWritten != _height)
+            {
+                throw std::runtime_error("Not all rows of the image have been written.");
+            }
+
+            // Set error handler
+            if (setjmp(png_jmpbuf(_png)))
             {
-                png_byte transparentIndex = 0;
-                png_set_tRNS(png_ptr, info_ptr, &transparentIndex, 1, nullptr);
-                colourType = PNG_COLOR_TYPE_PALETTE;
+                throw std::runtime_error("PNG ERROR");
             }
-            png_set_text(png_ptr, info_ptr, text_ptr, 1);
-            png_set_IHDR(
-                png_ptr, info_ptr, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-                PNG_FILTER_TYPE_DEFAULT);
-            png_write_info(png_ptr, info_ptr);
-
-            // Write pixels
-            auto pixels = image.Pixels.data();
-            for (uint32_t y = 0; y < image.Height; y++)
+
+            png_write_end(_png, nullptr);
+        }
+
+    private:
+        void Destroy()
+        {
+            if (_png != nullptr)
             {
-                png_write_row(png_ptr, const_cast<png_byte*>(pixels));
-                pixels += image.Stride;
+                png_free(_png, _palette);
+                png_destroy_write_struct(&_png, _info != nullptr ? &_info : nullptr);
             }
+            _png = nullptr;
+            _info = nullptr;
+            _palette = nullptr;
+        }
+    };
+
+    static void WritePng(std::ostream& ostream, const Image& image)
+    {
+        PngWriter writer(ostream, image);
+        writer.WriteRows(image.Pixels.data(), image.Height, image.Stride);
+        writer.Finish();
+    }
+
+    static std::ofstream OpenFileForWriting(const std::string_view& path)
+    {
+#if defined(_WIN32) && !defined(__MINGW32__)
+        auto pathW = String::ToWideChar(path);
+        return std::ofstream(pathW, std::ios::binary);
+#else
+        return std::ofstream(std::string(path), std::ios::binary);
+#endif
+    }
 
-            png_write_end(png_ptr, nullptr);
-            png_destroy_info_struct(png_ptr, &info_ptr);
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
+    struct PngFileWriter::Impl
+    {
+        std::ofstream Stream;
+        PngWriter Writer;
+
+        Impl(const std::string_view& path, const Image& image)
+            : Stream(OpenFileForWriting(path))
+            , Writer(Stream, image)
+        {
         }
-        catch (const std::exception&)
+    };
+
+    PngFileWriter::PngFileWriter(const std::string_view& path, const Image& image)
+    {
+        _impl = std::make_unique<Impl>(path, image);
+        if (!_impl->Stream)
         {
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
-            throw;
+            throw std::runtime_error("Unable to open file for writing.");
+        }
+    }
+
+    PngFileWriter::~PngFileWriter() = default;
+
+    void PngFileWriter::WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride)
+    {
+        _impl->Writer.WriteRows(pixels, numRows, stride);
+    }
+
+    void PngFileWriter::Finish()
+    {
+        _impl->Writer.Finish();
+        _impl->Stream.flush();
+        if (!_impl->Stream)
+        {
+            throw std::runtime_error("Unable to write to file.");
         }
     }
 
@@ -338,12 +450,7 @@ namespace Imaging
                 break;
             case IMAGE_FORMAT::PNG:
             {
-#if defined(_WIN32) && !defined(__MINGW32__)
-                auto pathW = String::ToWideChar(path);
-                std::ofstream fs(pathW, std::ios::binary);
-#else
-                std::ofstream fs(path.data(), std::ios::binary);
-#endif
+                auto fs = OpenFileForWriting(path);
                 WritePng(fs, image);
                 break;
             }
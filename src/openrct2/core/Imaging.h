@@ -52,4 +52,23 @@ namespace Imaging
     void WriteToFile(const std::string_view& path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
+
+    /**
+     * Writes a PNG image to a file a number of rows at a time, for images too large to be held in memory at once.
+     * Only the size, depth and palette of the given image are used, the rows must be written in order from the top
+     * and Finish called once all of them have been written.
+     */
+    class PngFileWriter
+    {
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+
+    public:
+        PngFileWriter(const std::string_view& path, const Image& image);
+        ~PngFileWriter();
+
+        void WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride);
+        void Finish();
+    };
 } // namespace Imaging
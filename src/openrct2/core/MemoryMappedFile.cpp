@@ -0,0 +1,133 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MemoryMappedFile.h"
+
+#include "IStream.hpp"
+#include "String.hpp"
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path)
+{
+    auto pathW = String::ToWideChar(path);
+    _fileHandle = CreateFileW(
+        pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        _fileHandle = nullptr;
+        throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(_fileHandle, &fileSize))
+    {
+        Close();
+        throw IOException(String::StdFormat("Unable to get size of '%s'", path.c_str()));
+    }
+    _length = static_cast<size_t>(fileSize.QuadPart);
+
+    // Empty files can not be mapped, leave the data as nullptr
+    if (_length != 0)
+    {
+        _mappingHandle = CreateFileMappingW(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mappingHandle != nullptr)
+        {
+            _data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (_data == nullptr)
+        {
+            Close();
+            throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+        }
+    }
+}
+
+void MemoryMappedFile::Close()
+{
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+    }
+    if (_mappingHandle != nullptr)
+    {
+        CloseHandle(_mappingHandle);
+        _mappingHandle = nullptr;
+    }
+    if (_fileHandle != nullptr)
+    {
+        CloseHandle(_fileHandle);
+        _fileHandle = nullptr;
+    }
+    _length = 0;
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+    }
+
+    // Only allow regular files to be mapped as its possible to open directories.
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        close(fd);
+        throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+    }
+    _length = static_cast<size_t>(fileStat.st_size);
+
+    // Empty files can not be mapped, leave the data as nullptr
+    if (_length != 0)
+    {
+        void* data = mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            _length = 0;
+            throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+        }
+        _data = static_cast<const uint8_t*>(data);
+    }
+
+    // The mapping keeps its own reference to the file
+    close(fd);
+}
+
+void MemoryMappedFile::Close()
+{
+    if (_data != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(_data), _length);
+        _data = nullptr;
+    }
+    _length = 0;
+}
+
+#endif
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    Close();
+}
@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <string>
+
+/**
+ * A read-only view of a whole file mapped into memory. Pages are only read from disk when they are first touched
+ * and can be dropped by the OS under memory pressure, unlike a buffer read with File::ReadAllBytes.
+ */
+class MemoryMappedFile final
+{
+private:
+    const uint8_t* _data = nullptr;
+    size_t _length = 0;
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif
+
+public:
+    /**
+     * Maps the given file, throws IOException if the file can not be opened or mapped.
+     */
+    explicit MemoryMappedFile(const std::string& path);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    const uint8_t* GetData() const
+    {
+        return _data;
+    }
+
+    size_t GetLength() const
+    {
+        return _length;
+    }
+
+private:
+    void Close();
+};
@@ -10,9 +10,11 @@
 #include "../common.h"
 #include "../core/Guard.hpp"
 #include "Drawing.h"
+#include "LightFX.h"
 
 #ifdef __AVX2__
 
+#    include <cstring>
 #    include <immintrin.h>
 
 void mask_avx2(
@@ -42,6 +44,143 @@ void mask_avx2(
     }
 }
 
+void rle_copy_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count)
+{
+    if (count < 32)
+    {
+        rle_copy_run_sse4_1(dst, src, count);
+        return;
+    }
+
+    int32_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), pixels);
+    }
+    if (i < count)
+    {
+        // Finish with an overlapping copy of the last 32 pixels
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + count - 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + count - 32), pixels);
+    }
+}
+
+/**
+ * Looks up 16 palette indices with two 32-bit gathers from the byte lookup table, which is why the table needs padding
+ * after its last entry, then packs the low bytes back together.
+ */
+static __m128i rle_lookup_avx2(const uint8_t* RESTRICT lut, const uint8_t* indices)
+{
+    const int* table = reinterpret_cast<const int*>(lut);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i index0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices)));
+    const __m256i index1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + 8)));
+    const __m256i values0 = _mm256_and_si256(_mm256_i32gather_epi32(table, index0, 1), byteMask);
+    const __m256i values1 = _mm256_and_si256(_mm256_i32gather_epi32(table, index1, 1), byteMask);
+    // packus works per 128-bit lane, so put the 64-bit quarters back in order before the final pack
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(values0, values1), 0xD8);
+    return _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+}
+
+void rle_remap_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, const uint8_t* RESTRICT lut, int32_t count)
+{
+    int32_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), rle_lookup_avx2(lut, src + i));
+    }
+    rle_remap_run_scalar(dst + i, src + i, lut, count - i);
+}
+
+void rle_transparent_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT lut, int32_t count)
+{
+    int32_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), rle_lookup_avx2(lut, dst + i));
+    }
+    rle_transparent_run_scalar(dst + i, lut, count - i);
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_row_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity)
+{
+    int32_t i = 0;
+    if (intensity == 0xFF)
+    {
+        for (; i + 32 <= count; i += 32)
+        {
+            const __m256i light = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m256i buffer = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_adds_epu8(buffer, light));
+        }
+    }
+    else
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i scale = _mm256_set1_epi16(1 + intensity);
+        for (; i + 32 <= count; i += 32)
+        {
+            // Unpacking and packing both work within 128-bit lanes, so the pixels keep their order
+            const __m256i light = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(light, zero), scale), 8);
+            const __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(light, zero), scale), 8);
+            const __m256i buffer = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(dst + i), _mm256_adds_epu8(buffer, _mm256_packus_epi16(lo, hi)));
+        }
+    }
+    lightfx_add_row_scalar(dst + i, src + i, count - i, intensity);
+}
+
+// Adds (lit * k) >> 8 to dark for 16-bit channels, the product needs up to 19 bits
+static __m256i lightfx_mix_avx2(__m256i dark, __m256i lit, __m256i k)
+{
+    const __m256i lo = _mm256_mullo_epi16(lit, k);
+    const __m256i hi = _mm256_mulhi_epu16(lit, k);
+    return _mm256_add_epi16(dark, _mm256_or_si256(_mm256_slli_epi16(hi, 8), _mm256_srli_epi16(lo, 8)));
+}
+
+void lightfx_compose_row_avx2(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i six = _mm256_set1_epi32(6);
+    const int* darkTable = reinterpret_cast<const int*>(palette);
+    const int* litTable = reinterpret_cast<const int*>(lightPalette);
+    int32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bits + i)));
+        const __m256i dark = _mm256_i32gather_epi32(darkTable, indices, 4);
+        uint64_t intensityBits;
+        std::memcpy(&intensityBits, light + i, sizeof(intensityBits));
+        if (intensityBits == 0)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), dark);
+            continue;
+        }
+        const __m256i lit = _mm256_i32gather_epi32(litTable, indices, 4);
+
+        // Spread the intensity of each pixel over its four channels
+        const __m128i intensities = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(light + i));
+        __m256i k = _mm256_mullo_epi16(_mm256_cvtepu8_epi32(intensities), six);
+        k = _mm256_or_si256(k, _mm256_slli_epi32(k, 16));
+
+        const __m256i lo = lightfx_mix_avx2(
+            _mm256_unpacklo_epi8(dark, zero), _mm256_unpacklo_epi8(lit, zero), _mm256_unpacklo_epi32(k, k));
+        const __m256i hi = lightfx_mix_avx2(
+            _mm256_unpackhi_epi8(dark, zero), _mm256_unpackhi_epi8(lit, zero), _mm256_unpackhi_epi32(k, k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    lightfx_compose_row_scalar(dst + i, bits + i, light + i, count - i, palette, lightPalette);
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +194,35 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void rle_copy_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void rle_remap_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, const uint8_t* RESTRICT lut, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void rle_transparent_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT lut, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_row_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void lightfx_compose_row_avx2(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #endif // __AVX2__
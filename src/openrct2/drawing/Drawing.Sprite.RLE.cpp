@@ -9,13 +9,428 @@
 
 #pragma warning(disable : 4127) // conditional expression is constant
 
+#include "../util/Util.h"
 #include "Drawing.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
-template<int32_t image_type, int32_t zoom_level> static void FASTCALL DrawRLESpriteMagnify(DrawSpriteArgs& args)
+/**
+ * A copy of an RLE image with only every (2^zoom)th column and row, starting at the given phase, so that minified drawing
+ * does not have to walk and skip the full resolution runs every frame.
+ */
+struct RLEMip
+{
+    rct_g1_element Element{};
+    std::vector<uint8_t> Data;
+};
+
+/**
+ * The sources of RLE images that have been replaced or unloaded, numbered by a generation that increases with every one
+ * of them. Every drawing thread keeps its own cache of copies and applies the invalidations since the generation it last
+ * saw before using it, so that drawing never has to take a lock unless something has been invalidated.
+ */
+class RLEMipInvalidations
+{
+private:
+    // Threads that are further behind than this clear their whole cache
+    static constexpr size_t MAX_COUNT = 4096;
+
+    std::mutex _mutex;
+    // A null source invalidates everything
+    std::deque<std::pair<uint64_t, const uint8_t*>> _sources;
+    std::atomic<uint64_t> _generation{};
+
+public:
+    uint64_t GetGeneration() const
+    {
+        return _generation.load(std::memory_order_acquire);
+    }
+
+    void Add(const uint8_t* source)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto generation = _generation.load(std::memory_order_relaxed) + 1;
+        _sources.emplace_back(generation, source);
+        if (_sources.size() > MAX_COUNT)
+        {
+            _sources.pop_front();
+        }
+        _generation.store(generation, std::memory_order_release);
+    }
+
+    /**
+     * Calls invalidate with every source invalidated after the given generation, or with nullptr if everything has to
+     * be invalidated. Returns the generation that has been reached.
+     */
+    template<typename TFunc> uint64_t Apply(uint64_t generation, TFunc invalidate)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_sources.empty() || _sources.front().first > generation + 1)
+        {
+            invalidate(nullptr);
+        }
+        else
+        {
+            // The sources are in order of generation
+            auto it = _sources.begin() + (generation + 1 - _sources.front().first);
+            for (; it != _sources.end(); it++)
+            {
+                invalidate(it->second);
+            }
+        }
+        return _generation.load(std::memory_order_relaxed);
+    }
+};
+
+static RLEMipInvalidations _rleMipInvalidations;
+
+class RLEMipCache
 {
-    // TODO
+private:
+    struct Key
+    {
+        const uint8_t* Source;
+        uint8_t Zoom;
+        uint8_t PhaseX;
+        uint8_t PhaseY;
+
+        bool operator<(const Key& rhs) const
+        {
+            if (Source != rhs.Source)
+                return Source < rhs.Source;
+            if (Zoom != rhs.Zoom)
+                return Zoom < rhs.Zoom;
+            if (PhaseX != rhs.PhaseX)
+                return PhaseX < rhs.PhaseX;
+            return PhaseY < rhs.PhaseY;
+        }
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<const RLEMip> Mip;
+        std::list<Key>::iterator Order;
+    };
+
+    // Per thread, so the paint threads hold several copies of the images they all draw
+    static constexpr size_t MAX_SIZE = 4 * 1024 * 1024;
+
+    std::map<Key, Entry> _entries;
+    std::list<Key> _order;
+    size_t _size = 0;
+    uint64_t _generation = 0;
+
+public:
+    std::shared_ptr<const RLEMip> Get(const rct_g1_element& g1, int32_t zoom, int32_t phaseX, int32_t phaseY)
+    {
+        // The source of an invalidated image may have been reused by another image since
+        if (_generation != _rleMipInvalidations.GetGeneration())
+        {
+            _generation = _rleMipInvalidations.Apply(_generation, [this](const uint8_t* source) { Invalidate(source); });
+        }
+
+        Key key{ g1.offset, static_cast<uint8_t>(zoom), static_cast<uint8_t>(phaseX), static_cast<uint8_t>(phaseY) };
+        auto it = _entries.find(key);
+        if (it != _entries.end())
+        {
+            _order.splice(_order.begin(), _order, it->second.Order);
+            return it->second.Mip;
+        }
+
+        auto mip = Build(g1, zoom, phaseX, phaseY);
+        if (mip == nullptr)
+            return nullptr;
+
+        _order.push_front(key);
+        _entries.emplace(key, Entry{ mip, _order.begin() });
+        _size += mip->Data.size();
+        while (_size > MAX_SIZE && _order.size() > 1)
+        {
+            Remove(_entries.find(_order.back()));
+        }
+        return mip;
+    }
+
+private:
+    void Invalidate(const uint8_t* source)
+    {
+        if (source == nullptr)
+        {
+            _entries.clear();
+            _order.clear();
+            _size = 0;
+            return;
+        }
+
+        auto it = _entries.lower_bound(Key{ source, 0, 0, 0 });
+        while (it != _entries.end() && it->first.Source == source)
+        {
+            it = Remove(it);
+        }
+    }
+
+    std::map<Key, Entry>::iterator Remove(std::map<Key, Entry>::iterator it)
+    {
+        _size -= it->second.Mip->Data.size();
+        _order.erase(it->second.Order);
+        return _entries.erase(it);
+    }
+
+    static std::shared_ptr<const RLEMip> Build(const rct_g1_element& g1, int32_t zoom, int32_t phaseX, int32_t phaseY)
+    {
+        const int32_t zoomAmount = 1 << zoom;
+        const int32_t mipWidth = std::max(0, g1.width - phaseX + zoomAmount - 1) >> zoom;
+        const int32_t mipHeight = std::max(0, g1.height - phaseY + zoomAmount - 1) >> zoom;
+        if (mipWidth > 256)
+            return nullptr;
+
+        auto mip = std::make_shared<RLEMip>();
+        auto& data = mip->Data;
+        data.resize(mipHeight * 2);
+
+        // Opaque pixels of the current source line, 0x100 marks a transparent pixel
+        std::vector<uint16_t> line(g1.width);
+        for (int32_t mipY = 0; mipY < mipHeight; mipY++)
+        {
+            const int32_t y = phaseY + (mipY << zoom);
+            std::fill(line.begin(), line.end(), 0x100);
+            const uint8_t* lineData = g1.offset + (g1.offset[y * 2] | (g1.offset[y * 2 + 1] << 8));
+            uint8_t isEndOfLine = 0;
+            while (!isEndOfLine)
+            {
+                uint8_t dataSize = *lineData++;
+                uint8_t firstPixelX = *lineData++;
+                isEndOfLine = dataSize & 0x80;
+                dataSize &= 0x7F;
+                for (int32_t i = 0; i < dataSize && firstPixelX + i < g1.width; i++)
+                {
+                    line[firstPixelX + i] = lineData[i];
+                }
+                lineData += dataSize;
+            }
+
+            if (data.size() > 0xFFFF)
+                return nullptr;
+            data[mipY * 2] = static_cast<uint8_t>(data.size());
+            data[mipY * 2 + 1] = static_cast<uint8_t>(data.size() >> 8);
+
+            // Re-encode the sampled pixels, splitting runs at the maximum run length
+            size_t lastRunHeader = SIZE_MAX;
+            int32_t mipX = 0;
+            while (mipX < mipWidth)
+            {
+                if (line[phaseX + (mipX << zoom)] == 0x100)
+                {
+                    mipX++;
+                    continue;
+                }
+
+                lastRunHeader = data.size();
+                data.push_back(0);
+                data.push_back(static_cast<uint8_t>(mipX));
+                uint8_t runLength = 0;
+                while (mipX < mipWidth && runLength < 0x7F && line[phaseX + (mipX << zoom)] != 0x100)
+                {
+                    data.push_back(static_cast<uint8_t>(line[phaseX + (mipX << zoom)]));
+                    runLength++;
+                    mipX++;
+                }
+                data[lastRunHeader] = runLength;
+            }
+
+            if (lastRunHeader == SIZE_MAX)
+            {
+                // Empty line
+                data.push_back(0x80);
+                data.push_back(0);
+            }
+            else
+            {
+                data[lastRunHeader] |= 0x80;
+            }
+        }
+        data.shrink_to_fit();
+
+        mip->Element = g1;
+        mip->Element.offset = data.data();
+        mip->Element.width = mipWidth;
+        mip->Element.height = mipHeight;
+        mip->Element.flags = G1_FLAG_RLE_COMPRESSION;
+        return mip;
+    }
+};
+
+static thread_local RLEMipCache _rleMipCache;
+
+void rle_copy_run_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count)
+{
+    if (count > 0)
+    {
+        std::memcpy(dst, src, count);
+    }
+}
+
+void rle_remap_run_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, const uint8_t* RESTRICT lut, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        dst[i] = lut[src[i]];
+    }
+}
+
+void rle_transparent_run_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT lut, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        dst[i] = lut[dst[i]];
+    }
+}
+
+// A 256 entry lookup is faster done by scalar code than with 16 SSE shuffles, so only AVX2 (with gathers) has its own
+static constexpr RLERunKernels RLERunKernelsScalar = { "scalar", rle_copy_run_scalar, rle_remap_run_scalar,
+                                                       rle_transparent_run_scalar };
+static constexpr RLERunKernels RLERunKernelsSSE41 = { "SSE4.1", rle_copy_run_sse4_1, rle_remap_run_scalar,
+                                                      rle_transparent_run_scalar };
+static constexpr RLERunKernels RLERunKernelsAVX2 = { "AVX2", rle_copy_run_avx2, rle_remap_run_avx2,
+                                                     rle_transparent_run_avx2 };
+
+static const RLERunKernels* _rleRunKernels = &RLERunKernelsScalar;
+
+void rle_run_kernels_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 RLE run functions");
+        _rleRunKernels = &RLERunKernelsAVX2;
+    }
+    else if (sse41_available())
+    {
+        log_verbose("registering SSE4.1 RLE run functions");
+        _rleRunKernels = &RLERunKernelsSSE41;
+    }
+    else
+    {
+        log_verbose("registering scalar RLE run functions");
+        _rleRunKernels = &RLERunKernelsScalar;
+    }
+}
+
+const RLERunKernels& rle_get_run_kernels()
+{
+    return *_rleRunKernels;
+}
+
+void rle_set_run_kernels(const RLERunKernels& kernels)
+{
+    for (auto available : { &RLERunKernelsScalar, &RLERunKernelsSSE41, &RLERunKernelsAVX2 })
+    {
+        if (std::strcmp(available->Name, kernels.Name) == 0)
+        {
+            _rleRunKernels = available;
+        }
+    }
+}
+
+std::vector<RLERunKernels> rle_get_available_run_kernels()
+{
+    std::vector<RLERunKernels> result = { RLERunKernelsScalar };
+    if (sse41_available())
+        result.push_back(RLERunKernelsSSE41);
+    if (avx2_available())
+        result.push_back(RLERunKernelsAVX2);
+    return result;
+}
+
+template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLESpriteMagnify(DrawSpriteArgs& args)
+{
+    auto dpi = args.DPI;
+    auto source_bits_pointer = args.SourceImage.offset;
+    auto dest_bits_pointer = args.DestinationBits;
+    auto source_x_start = args.SrcX;
+    auto source_y_start = args.SrcY;
+    auto width = args.Width;
+    auto height = args.Height;
+    [[maybe_unused]] auto& paletteMap = args.PalMap;
+
+    // Every source pixel covers a square of 2^zoom_level destination pixels.
+    constexpr int32_t zoom_amount = 1 << zoom_level;
+
+    // Width of one screen line in the dest buffer
+    int32_t line_width = (dpi->width << zoom_level) + dpi->pitch;
+
+    // For every line in the image
+    for (int32_t i = 0; i < height; i++)
+    {
+        int32_t y = source_y_start + i;
+
+        const uint16_t lineOffset = source_bits_pointer[y * 2] | (source_bits_pointer[y * 2 + 1] << 8);
+        const uint8_t* lineData = source_bits_pointer + lineOffset;
+        uint8_t* loop_dest_pointer = dest_bits_pointer + line_width * (i << zoom_level);
+
+        uint8_t isEndOfLine = 0;
+
+        // For every data chunk in the line
+        while (!isEndOfLine)
+        {
+            const uint8_t* copySrc = lineData;
+
+            uint8_t dataSize = *copySrc++;
+            uint8_t firstPixelX = *copySrc++;
+
+            isEndOfLine = dataSize & 0x80;
+            dataSize &= 0x7F;
+
+            lineData = copySrc + dataSize;
+
+            int32_t x_start = firstPixelX - source_x_start;
+            int32_t numPixels = dataSize;
+            if (x_start < 0)
+            {
+                copySrc -= x_start;
+                numPixels += x_start;
+                x_start = 0;
+            }
+            if (x_start + numPixels > width)
+                numPixels = width - x_start;
+
+            // Repeat every source pixel across its square of destination pixels
+            for (int32_t j = 0; j < numPixels; j++, copySrc++)
+            {
+                uint8_t* copyDest = loop_dest_pointer + ((x_start + j) << zoom_level);
+                for (int32_t dy = 0; dy < zoom_amount; dy++, copyDest += line_width)
+                {
+                    for (int32_t dx = 0; dx < zoom_amount; dx++)
+                    {
+                        if constexpr ((TBlendOp & BLEND_SRC) != 0 && (TBlendOp & BLEND_DST) != 0)
+                        {
+                            copyDest[dx] = paletteMap.Blend(*copySrc, copyDest[dx]);
+                        }
+                        else if constexpr ((TBlendOp & BLEND_SRC) != 0)
+                        {
+                            copyDest[dx] = paletteMap[*copySrc];
+                        }
+                        else if constexpr ((TBlendOp & BLEND_DST) != 0)
+                        {
+                            copyDest[dx] = paletteMap[copyDest[dx]];
+                        }
+                        else
+                        {
+                            copyDest[dx] = *copySrc;
+                        }
+                    }
+                }
+            }
+        }
+    }
 }
 
 template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLESpriteMinify(DrawSpriteArgs& args)
@@ -36,6 +451,15 @@ template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLES
     // Width of one screen line in the dest buffer
     int32_t line_width = (dpi->width >> zoom_level) + dpi->pitch;
 
+    // Unscaled runs of the common blend operations are copied by the SIMD run functions
+    constexpr bool useRunKernels = zoom_level == 0 && ((TBlendOp & BLEND_SRC) == 0 || (TBlendOp & BLEND_DST) == 0);
+    [[maybe_unused]] const auto& kernels = *_rleRunKernels;
+    [[maybe_unused]] uint8_t lut[RLE_LOOKUP_TABLE_SIZE];
+    if constexpr (useRunKernels && ((TBlendOp & BLEND_SRC) != 0 || (TBlendOp & BLEND_DST) != 0))
+    {
+        paletteMap.CopyToLookupTable(lut);
+    }
+
     // Move up to the first line of the image if source_y_start is negative. Why does this even occur?
     if (source_y_start < 0)
     {
@@ -106,7 +530,22 @@ template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLES
 
             // Finally after all those checks, copy the image onto the drawing surface
             // If the image type is not a basic one we require to mix the pixels
-            if constexpr ((TBlendOp & BLEND_SRC) != 0) // palette controlled images
+            if constexpr (useRunKernels)
+            {
+                if constexpr ((TBlendOp & BLEND_SRC) != 0) // palette controlled images
+                {
+                    kernels.RemapRun(copyDest, copySrc, lut, numPixels);
+                }
+                else if constexpr ((TBlendOp & BLEND_DST) != 0) // single alpha blended color (used for glass)
+                {
+                    kernels.TransparentRun(copyDest, lut, numPixels);
+                }
+                else // standard opaque image
+                {
+                    kernels.CopyRun(copyDest, copySrc, numPixels);
+                }
+            }
+            else if constexpr ((TBlendOp & BLEND_SRC) != 0) // palette controlled images
             {
                 for (int j = 0; j < numPixels; j += zoom_amount, copySrc += zoom_amount, copyDest++)
                 {
@@ -129,22 +568,57 @@ template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLES
             }
             else // standard opaque image
             {
-                if (zoom_level == 0)
-                {
-                    // Since we're sampling each pixel at this zoom level, just do a straight std::memcpy
-                    if (numPixels > 0)
-                        std::memcpy(copyDest, copySrc, numPixels);
-                }
-                else
-                {
-                    for (int j = 0; j < numPixels; j += zoom_amount, copySrc += zoom_amount, copyDest++)
-                        *copyDest = *copySrc;
-                }
+                for (int j = 0; j < numPixels; j += zoom_amount, copySrc += zoom_amount, copyDest++)
+                    *copyDest = *copySrc;
             }
         }
     }
 }
 
+/**
+ * Draws a minified RLE image using a cached copy that has already been sampled down to the zoom level, falling back to
+ * sampling the full resolution image if the copy could not be built.
+ */
+template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLESpriteMinifyCached(DrawSpriteArgs& args)
+{
+    constexpr int32_t zoom_amount = 1 << zoom_level;
+
+    auto dpi = args.DPI;
+    auto source_x_start = args.SrcX;
+    auto source_y_start = args.SrcY;
+    auto height = args.Height;
+    auto dest_bits_pointer = args.DestinationBits;
+
+    // Same adjustment as DrawRLESpriteMinify so both sample the same source lines
+    if (source_y_start < 0)
+    {
+        source_y_start += zoom_amount;
+        height -= zoom_amount;
+        dest_bits_pointer += (dpi->width >> zoom_level) + dpi->pitch;
+    }
+
+    // The sampled columns and lines are those congruent to the source start, modulo the zoom amount
+    const int32_t phaseX = source_x_start & (zoom_amount - 1);
+    const int32_t phaseY = source_y_start & (zoom_amount - 1);
+    auto mip = _rleMipCache.Get(args.SourceImage, zoom_level, phaseX, phaseY);
+    if (mip == nullptr)
+    {
+        DrawRLESpriteMinify<TBlendOp, zoom_level>(args);
+        return;
+    }
+
+    // The mip is drawn unscaled onto the zoomed buffer
+    rct_drawpixelinfo mipDpi = *dpi;
+    mipDpi.width = dpi->width >> zoom_level;
+    mipDpi.zoom_level = 0;
+
+    DrawSpriteArgs mipArgs(
+        &mipDpi, args.Image, args.PalMap, mip->Element, (source_x_start - phaseX) / zoom_amount,
+        (source_y_start - phaseY) / zoom_amount, (args.Width + zoom_amount - 1) / zoom_amount,
+        (height + zoom_amount - 1) / zoom_amount, dest_bits_pointer);
+    DrawRLESpriteMinify<TBlendOp, 0>(mipArgs);
+}
+
 template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs& args)
 {
     auto zoom_level = static_cast<int8_t>(args.DPI->zoom_level);
@@ -160,13 +634,13 @@ template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs
             DrawRLESpriteMinify<TBlendOp, 0>(args);
             break;
         case 1:
-            DrawRLESpriteMinify<TBlendOp, 1>(args);
+            DrawRLESpriteMinifyCached<TBlendOp, 1>(args);
             break;
         case 2:
-            DrawRLESpriteMinify<TBlendOp, 2>(args);
+            DrawRLESpriteMinifyCached<TBlendOp, 2>(args);
             break;
         case 3:
-            DrawRLESpriteMinify<TBlendOp, 3>(args);
+            DrawRLESpriteMinifyCached<TBlendOp, 3>(args);
             break;
         default:
             assert(false);
@@ -174,6 +648,118 @@ template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs
     }
 }
 
+struct RecordedRLESprite
+{
+    size_t BlendOp;
+    rct_drawpixelinfo DPI;
+    ImageId Image;
+    rct_g1_element SourceImage;
+    int32_t SrcX;
+    int32_t SrcY;
+    int32_t Width;
+    int32_t Height;
+    size_t DestinationOffset;
+    uint8_t Lut[256];
+};
+
+static constexpr const char* RLEBenchmarkBlendOpNames[] = { "plain", "remap", "transparent" };
+
+static std::unique_ptr<std::vector<RecordedRLESprite>> _rleRecording;
+
+static void RecordRLESprite(const DrawSpriteArgs& args)
+{
+    size_t blendOp = 0;
+    if (args.Image.HasPrimary())
+    {
+        // Blending with a palette per source colour is not one of the benchmarked operations
+        if (args.Image.IsBlended())
+            return;
+        blendOp = 1;
+    }
+    else if (args.Image.IsBlended())
+    {
+        blendOp = 2;
+    }
+
+    auto& sprite = _rleRecording->emplace_back();
+    sprite.BlendOp = blendOp;
+    sprite.DPI = *args.DPI;
+    sprite.Image = args.Image;
+    sprite.SourceImage = args.SourceImage;
+    sprite.SrcX = args.SrcX;
+    sprite.SrcY = args.SrcY;
+    sprite.Width = args.Width;
+    sprite.Height = args.Height;
+    sprite.DestinationOffset = args.DestinationBits - args.DPI->bits;
+    args.PalMap.CopyToLookupTable(sprite.Lut);
+}
+
+void rle_benchmark_start_recording()
+{
+    _rleRecording = std::make_unique<std::vector<RecordedRLESprite>>();
+}
+
+std::vector<RLEBlendOpBenchmark> rle_benchmark_run(int32_t iterations)
+{
+    std::vector<RLEBlendOpBenchmark> results;
+    auto recording = std::move(_rleRecording);
+    if (recording == nullptr)
+        return results;
+
+    // Draw everything into a scratch buffer large enough for any of the recorded drawing areas
+    size_t bufferSize = 0;
+    for (const auto& sprite : *recording)
+    {
+        const auto& dpi = sprite.DPI;
+        auto size = static_cast<size_t>((dpi.width / dpi.zoom_level) + dpi.pitch) * ((dpi.height / dpi.zoom_level) + 1);
+        bufferSize = std::max(bufferSize, size);
+    }
+    std::vector<uint8_t> buffer(bufferSize);
+
+    const auto* originalKernels = _rleRunKernels;
+    for (const auto& kernels : rle_get_available_run_kernels())
+    {
+        rle_set_run_kernels(kernels);
+        for (size_t blendOp = 0; blendOp < std::size(RLEBenchmarkBlendOpNames); blendOp++)
+        {
+            auto& result = results.emplace_back();
+            result = { kernels.Name, RLEBenchmarkBlendOpNames[blendOp], 0, 0, 0.0 };
+
+            const auto startTime = std::chrono::high_resolution_clock::now();
+            for (int32_t i = 0; i < iterations; i++)
+            {
+                for (auto& sprite : *recording)
+                {
+                    if (sprite.BlendOp != blendOp)
+                        continue;
+
+                    auto dpi = sprite.DPI;
+                    dpi.bits = buffer.data();
+                    PaletteMap paletteMap(sprite.Lut);
+                    DrawSpriteArgs args(
+                        &dpi, sprite.Image, paletteMap, sprite.SourceImage, sprite.SrcX, sprite.SrcY, sprite.Width,
+                        sprite.Height, buffer.data() + sprite.DestinationOffset);
+                    gfx_rle_sprite_to_buffer(args);
+                }
+            }
+            const auto endTime = std::chrono::high_resolution_clock::now();
+            result.Seconds = std::chrono::duration<double>(endTime - startTime).count();
+
+            for (const auto& sprite : *recording)
+            {
+                if (sprite.BlendOp == blendOp)
+                {
+                    result.Sprites++;
+                    result.Pixels += static_cast<uint64_t>(sprite.Width / sprite.DPI.zoom_level)
+                        * (sprite.Height / sprite.DPI.zoom_level) * iterations;
+                }
+            }
+        }
+    }
+    _rleRunKernels = originalKernels;
+    return results;
+}
+
 /**
  * Transfers readied images onto buffers
  * This function copies the sprite data onto the screen
@@ -182,6 +768,11 @@ template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs
  */
 void FASTCALL gfx_rle_sprite_to_buffer(DrawSpriteArgs& args)
 {
+    if (_rleRecording != nullptr)
+    {
+        RecordRLESprite(args);
+    }
+
     if (args.Image.HasPrimary())
     {
         if (args.Image.IsBlended())
@@ -202,3 +793,16 @@ void FASTCALL gfx_rle_sprite_to_buffer(DrawSpriteArgs& args)
         DrawRLESprite<BLEND_TRANSPARENT>(args);
     }
 }
+
+void gfx_rle_mip_cache_invalidate(const uint8_t* imageData)
+{
+    if (imageData != nullptr)
+    {
+        _rleMipInvalidations.Add(imageData);
+    }
+}
+
+void gfx_rle_mip_cache_clear()
+{
+    _rleMipInvalidations.Add(nullptr);
+}
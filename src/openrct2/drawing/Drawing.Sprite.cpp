@@ -12,6 +12,8 @@
 #include "../PlatformEnvironment.h"
 #include "../config/Config.h"
 #include "../core/FileStream.hpp"
+#include "../core/MemoryMappedFile.h"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../platform/platform.h"
 #include "../sprites.h"
@@ -67,7 +69,10 @@ static inline uint32_t rctc_to_rct2_index(uint32_t image)
 }
 // clang-format on
 
-static void read_and_convert_gxdat(IStream* stream, size_t count, bool is_rctc, rct_g1_element* elements)
+/**
+ * Reads the element headers and resolves their data offsets relative to the given image data.
+ */
+static void read_and_convert_gxdat(IStream* stream, size_t count, bool is_rctc, const uint8_t* data, rct_g1_element* elements)
 {
     auto g1Elements32 = std::make_unique<rct_g1_element_32bit[]>(count);
     stream->Read(g1Elements32.get(), count * sizeof(rct_g1_element_32bit));
@@ -101,9 +106,8 @@ static void read_and_convert_gxdat(IStream* stream, size_t count, bool is_rctc,
 
             const rct_g1_element_32bit& src = g1Elements32[rctc];
 
-            // Double cast to silence compiler warning about casting to
-            // pointer from integer of mismatched length.
-            elements[i].offset = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(src.offset));
+            // The data is mapped read-only, nothing writes through g1 element offsets
+            elements[i].offset = const_cast<uint8_t*>(data) + src.offset;
             elements[i].width = src.width;
             elements[i].height = src.height;
             elements[i].x_offset = src.x_offset;
@@ -140,9 +144,8 @@ static void read_and_convert_gxdat(IStream* stream, size_t count, bool is_rctc,
         {
             const rct_g1_element_32bit& src = g1Elements32[i];
 
-            // Double cast to silence compiler warning about casting to
-            // pointer from integer of mismatched length.
-            elements[i].offset = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(src.offset));
+            // The data is mapped read-only, nothing writes through g1 element offsets
+            elements[i].offset = const_cast<uint8_t*>(data) + src.offset;
             elements[i].width = src.width;
             elements[i].height = src.height;
             elements[i].x_offset = src.x_offset;
@@ -177,6 +180,19 @@ void mask_scalar(
     }
 }
 
+/**
+ * Gets the image data of a g1.dat style file, which follows the header and the element headers.
+ */
+static const uint8_t* get_gxdat_data(const MemoryMappedFile& file, const rct_g1_header& header)
+{
+    size_t dataOffset = sizeof(rct_g1_header) + static_cast<size_t>(header.num_entries) * sizeof(rct_g1_element_32bit);
+    if (dataOffset + header.total_size > file.GetLength())
+    {
+        throw std::runtime_error("Image data is truncated");
+    }
+    return file.GetData() + dataOffset;
+}
+
 static rct_gx _g1 = {};
 static rct_gx _g2 = {};
 static rct_gx _csg = {};
@@ -196,8 +212,9 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
     try
     {
         auto path = Path::Combine(env.GetDirectoryPath(DIRBASE::RCT2, DIRID::DATA), "g1.dat");
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g1.header = fs.ReadValue<rct_g1_header>();
+        _g1.file = std::make_unique<MemoryMappedFile>(path);
+        auto ms = MemoryStream(_g1.file->GetData(), _g1.file->GetLength());
+        _g1.header = ms.ReadValue<rct_g1_header>();
 
         log_verbose("g1.dat, number of entries: %u", _g1.header.num_entries);
 
@@ -206,26 +223,19 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
             throw std::runtime_error("Not enough elements in g1.dat");
         }
 
-        // Read element headers
+        // Read element headers, the element data follows them
         bool is_rctc = _g1.header.num_entries == SPR_RCTC_G1_END;
+        auto data = get_gxdat_data(*_g1.file, _g1.header);
         _g1.elements.resize(_g1.header.num_entries);
-        read_and_convert_gxdat(&fs, _g1.header.num_entries, is_rctc, _g1.elements.data());
+        read_and_convert_gxdat(&ms, _g1.header.num_entries, is_rctc, data, _g1.elements.data());
         gTinyFontAntiAliased = is_rctc;
-
-        // Read element data
-        _g1.data = fs.ReadArray<uint8_t>(_g1.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g1.header.num_entries; i++)
-        {
-            _g1.elements[i].offset += reinterpret_cast<uintptr_t>(_g1.data);
-        }
         return true;
     }
     catch (const std::exception&)
     {
         _g1.elements.clear();
         _g1.elements.shrink_to_fit();
+        _g1.file = nullptr;
 
         log_fatal("Unable to load g1 graphics");
         if (!gOpenRCT2Headless)
@@ -239,23 +249,26 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
 
 void gfx_unload_g1()
 {
-    SafeFree(_g1.data);
+    gfx_rle_mip_cache_clear();
     _g1.elements.clear();
     _g1.elements.shrink_to_fit();
+    _g1.file = nullptr;
 }
 
 void gfx_unload_g2()
 {
-    SafeFree(_g2.data);
+    gfx_rle_mip_cache_clear();
     _g2.elements.clear();
     _g2.elements.shrink_to_fit();
+    _g2.file = nullptr;
 }
 
 void gfx_unload_csg()
 {
-    SafeFree(_csg.data);
+    gfx_rle_mip_cache_clear();
     _csg.elements.clear();
     _csg.elements.shrink_to_fit();
+    _csg.file = nullptr;
 }
 
 bool gfx_load_g2()
@@ -268,27 +281,21 @@ bool gfx_load_g2()
     safe_strcat_path(path, "g2.dat", MAX_PATH);
     try
     {
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g2.header = fs.ReadValue<rct_g1_header>();
+        _g2.file = std::make_unique<MemoryMappedFile>(path);
+        auto ms = MemoryStream(_g2.file->GetData(), _g2.file->GetLength());
+        _g2.header = ms.ReadValue<rct_g1_header>();
 
-        // Read element headers
+        // Read element headers, the element data follows them
+        auto data = get_gxdat_data(*_g2.file, _g2.header);
         _g2.elements.resize(_g2.header.num_entries);
-        read_and_convert_gxdat(&fs, _g2.header.num_entries, false, _g2.elements.data());
-
-        // Read element data
-        _g2.data = fs.ReadArray<uint8_t>(_g2.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g2.header.num_entries; i++)
-        {
-            _g2.elements[i].offset += reinterpret_cast<uintptr_t>(_g2.data);
-        }
+        read_and_convert_gxdat(&ms, _g2.header.num_entries, false, data, _g2.elements.data());
         return true;
     }
     catch (const std::exception&)
     {
         _g2.elements.clear();
         _g2.elements.shrink_to_fit();
+        _g2.file = nullptr;
 
         log_fatal("Unable to load g2 graphics");
         if (!gOpenRCT2Headless)
@@ -315,9 +322,9 @@ bool gfx_load_csg()
     try
     {
         auto fileHeader = FileStream(pathHeaderPath, FILE_MODE_OPEN);
-        auto fileData = FileStream(pathDataPath, FILE_MODE_OPEN);
+        _csg.file = std::make_unique<MemoryMappedFile>(pathDataPath);
         size_t fileHeaderSize = fileHeader.GetLength();
-        size_t fileDataSize = fileData.GetLength();
+        size_t fileDataSize = _csg.file->GetLength();
 
         _csg.header.num_entries = static_cast<uint32_t>(fileHeaderSize / sizeof(rct_g1_element_32bit));
         _csg.header.total_size = static_cast<uint32_t>(fileDataSize);
@@ -325,20 +332,16 @@ bool gfx_load_csg()
         if (!CsgIsUsable(_csg))
         {
             log_warning("Cannot load CSG1.DAT, it has too few entries. Only CSG1.DAT from Loopy Landscapes will work.");
+            _csg.file = nullptr;
             return false;
         }
 
-        // Read element headers
+        // Read element headers, the element data is the whole of the data file
         _csg.elements.resize(_csg.header.num_entries);
-        read_and_convert_gxdat(&fileHeader, _csg.header.num_entries, false, _csg.elements.data());
-
-        // Read element data
-        _csg.data = fileData.ReadArray<uint8_t>(_csg.header.total_size);
+        read_and_convert_gxdat(&fileHeader, _csg.header.num_entries, false, _csg.file->GetData(), _csg.elements.data());
 
-        // Fix entry data offsets
         for (uint32_t i = 0; i < _csg.header.num_entries; i++)
         {
-            _csg.elements[i].offset += reinterpret_cast<uintptr_t>(_csg.data);
             // RCT1 used zoomed offsets that counted from the beginning of the file, rather than from the current sprite.
             if (_csg.elements[i].flags & G1_FLAG_HAS_ZOOM_SPRITE)
             {
@@ -352,6 +355,7 @@ bool gfx_load_csg()
     {
         _csg.elements.clear();
         _csg.elements.shrink_to_fit();
+        _csg.file = nullptr;
 
         log_error("Unable to load csg graphics");
         return false;
@@ -728,6 +732,7 @@ void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1)
     {
         if (isTemp)
         {
+            gfx_rle_mip_cache_invalidate(_g1Temp.offset);
             _g1Temp = *g1;
         }
         else if (isValid)
@@ -736,6 +741,7 @@ void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1)
             {
                 if (imageId < static_cast<int32_t>(_g1.elements.size()))
                 {
+                    gfx_rle_mip_cache_invalidate(_g1.elements[imageId].offset);
                     _g1.elements[imageId] = *g1;
                 }
             }
@@ -747,6 +753,7 @@ void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1)
                 {
                     _imageListElements.resize(std::max<size_t>(256, _imageListElements.size() * 2));
                 }
+                gfx_rle_mip_cache_invalidate(_imageListElements[idx].offset);
                 _imageListElements[idx] = *g1;
             }
         }
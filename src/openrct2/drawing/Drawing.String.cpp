@@ -542,7 +542,7 @@ static void ttf_draw_string_raw_ttf(rct_drawpixelinfo* dpi, const utf8* text, te
     else
     {
         uint8_t colour = info->palette[1];
-        TTFSurface* surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
+        auto surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
         if (surface == nullptr)
             return;
 
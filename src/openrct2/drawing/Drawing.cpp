@@ -13,6 +13,7 @@
 #include "../OpenRCT2.h"
 #include "../common.h"
 #include "../core/Guard.hpp"
+#include "../interface/ViewportCache.h"
 #include "../object/Object.h"
 #include "../platform/platform.h"
 #include "../sprites.h"
@@ -81,6 +82,16 @@ void PaletteMap::Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, s
     std::memcpy(&_data[dstIndex], &src._data[srcIndex], copyLength);
 }
 
+void PaletteMap::CopyToLookupTable(uint8_t* lut) const
+{
+    auto length = std::min<size_t>(_dataLength, 256);
+    if (length != 0)
+    {
+        std::memcpy(lut, _data, length);
+    }
+    std::memset(lut + length, 0, 256 - length);
+}
+
 // HACK These were originally passed back through registers
 thread_local int32_t gLastDrawStringX;
 thread_local int32_t gLastDrawStringY;
@@ -663,6 +674,7 @@ void load_palette()
  */
 void gfx_invalidate_screen()
 {
+    viewport_cache_invalidate_all();
     gfx_set_dirty_blocks({ { 0, 0 }, { context_get_width(), context_get_height() } });
 }
 
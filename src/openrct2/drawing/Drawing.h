@@ -14,9 +14,12 @@
 #include "../interface/Colour.h"
 #include "../interface/ZoomLevel.hpp"
 
+#include <memory>
 #include <optional>
 #include <vector>
 
+class Formatter;
+class MemoryMappedFile;
 struct ScreenCoordsXY;
 struct ScreenLine;
 struct ScreenRect;
@@ -95,7 +98,8 @@ struct rct_gx
 {
     rct_g1_header header;
     std::vector<rct_g1_element> elements;
-    void* data;
+    // Read-only mapping of the file holding the image data, element offsets point into it
+    std::unique_ptr<MemoryMappedFile> file;
 };
 
 struct rct_drawpixelinfo
@@ -513,6 +517,11 @@ public:
     uint8_t operator[](size_t index) const;
     uint8_t Blend(uint8_t src, uint8_t dst) const;
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
+
+    /**
+     * Copies the first 256 entries into a plain lookup table, entries outside of the map become 0.
+     */
+    void CopyToLookupTable(uint8_t* lut) const;
 };
 
 struct DrawSpriteArgs
@@ -628,9 +637,13 @@ void gfx_object_free_images(uint32_t baseImageId, uint32_t count);
 void gfx_object_check_all_images_freed();
 size_t ImageListGetUsedCount();
 size_t ImageListGetMaximum();
+size_t ImageListGetFreeRangeCount();
+size_t ImageListGetLargestFreeRange();
 void FASTCALL gfx_sprite_to_buffer(DrawSpriteArgs& args);
 void FASTCALL gfx_bmp_sprite_to_buffer(DrawSpriteArgs& args);
 void FASTCALL gfx_rle_sprite_to_buffer(DrawSpriteArgs& args);
+void gfx_rle_mip_cache_invalidate(const uint8_t* imageData);
+void gfx_rle_mip_cache_clear();
 void FASTCALL gfx_draw_sprite(rct_drawpixelinfo* dpi, int32_t image_id, const ScreenCoordsXY& coords, uint32_t tertiary_colour);
 void FASTCALL
     gfx_draw_glyph(rct_drawpixelinfo* dpi, int32_t image_id, const ScreenCoordsXY& coords, const PaletteMap& paletteMap);
@@ -693,9 +706,11 @@ void ttf_draw_string(rct_drawpixelinfo* dpi, const_utf8string text, int32_t colo
 
 // scrolling text
 void scrolling_text_initialise_bitmaps();
+void scrolling_text_dispose();
 void scrolling_text_invalidate();
 int32_t scrolling_text_setup(
-    struct paint_session* session, rct_string_id stringId, uint16_t scroll, uint16_t scrollingMode, colour_t colour);
+    struct paint_session* session, rct_string_id stringId, Formatter& ft, uint16_t scroll, uint16_t scrollingMode,
+    colour_t colour);
 
 rct_size16 FASTCALL gfx_get_sprite_size(uint32_t image_id);
 size_t g1_calculate_data_size(const rct_g1_element* g1);
@@ -711,6 +726,53 @@ void mask_avx2(
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 void mask_init();
 
+// 256 palette entries followed by padding so that SIMD lookups can read whole 32-bit words
+constexpr size_t RLE_LOOKUP_TABLE_SIZE = 256 + 4;
+
+void rle_copy_run_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count);
+void rle_copy_run_sse4_1(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count);
+void rle_copy_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count);
+void rle_remap_run_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, const uint8_t* RESTRICT lut, int32_t count);
+void rle_remap_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, const uint8_t* RESTRICT lut, int32_t count);
+void rle_transparent_run_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT lut, int32_t count);
+void rle_transparent_run_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT lut, int32_t count);
+
+/**
+ * The run copies used when drawing RLE images for the plain, remapped and transparent (glass) blend operations.
+ */
+struct RLERunKernels
+{
+    const char* Name;
+    void (*CopyRun)(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count);
+    void (*RemapRun)(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, const uint8_t* RESTRICT lut, int32_t count);
+    void (*TransparentRun)(uint8_t* RESTRICT dst, const uint8_t* RESTRICT lut, int32_t count);
+};
+
+void rle_run_kernels_init();
+const RLERunKernels& rle_get_run_kernels();
+void rle_set_run_kernels(const RLERunKernels& kernels);
+std::vector<RLERunKernels> rle_get_available_run_kernels();
+
+struct RLEBlendOpBenchmark
+{
+    const char* Kernels;
+    const char* BlendOp;
+    size_t Sprites;
+    uint64_t Pixels;
+    double Seconds;
+};
+
+/**
+ * Starts recording the RLE images drawn with the plain, remap and transparent blend operations, drawing must happen on a
+ * single thread while recording.
+ */
+void rle_benchmark_start_recording();
+
+/**
+ * Stops recording and redraws the recorded images the given number of times with every available set of run functions.
+ */
+std::vector<RLEBlendOpBenchmark> rle_benchmark_run(int32_t iterations);
+
 extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
@@ -36,6 +36,19 @@ enum DRAWING_ENGINE_FLAGS
 struct rct_drawpixelinfo;
 struct GamePalette;
 
+/**
+ * Timings and counters of the last frame drawn by an engine that only redraws dirty parts of the screen.
+ */
+struct DrawingEngineFrameStats
+{
+    uint32_t DirtyBlocks;
+    uint32_t DrawnBlocks;
+    uint32_t DirtyRects;
+    // Milliseconds spent painting viewports ahead of the windows and drawing the windows
+    double ViewportTime;
+    double WindowTime;
+};
+
 namespace OpenRCT2::Ui
 {
     interface IUiContext;
@@ -73,6 +86,11 @@ namespace OpenRCT2::Drawing
         virtual DRAWING_ENGINE_FLAGS GetFlags() abstract;
 
         virtual void InvalidateImage(uint32_t image) abstract;
+
+        virtual const DrawingEngineFrameStats* GetFrameStats()
+        {
+            return nullptr;
+        }
     };
 
     interface IDrawingEngineFactory
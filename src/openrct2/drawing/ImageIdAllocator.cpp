@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ImageIdAllocator.h"
+
+#include <iterator>
+
+ImageIdAllocator::ImageIdAllocator(uint32_t baseId, uint32_t capacity)
+    : _baseId(baseId)
+    , _capacity(capacity)
+{
+    Reset();
+}
+
+uint32_t ImageIdAllocator::Allocate(uint32_t count)
+{
+    if (count == 0)
+    {
+        return INVALID_ID;
+    }
+
+    // Smallest free range that fits, the one with the lowest id if there are several
+    auto fit = _freeRangesBySize.lower_bound({ count, 0 });
+    if (fit == _freeRangesBySize.end())
+    {
+        return INVALID_ID;
+    }
+
+    const auto [rangeCount, rangeBaseId] = *fit;
+    RemoveFreeRange(_freeRanges.find(rangeBaseId));
+    if (rangeCount > count)
+    {
+        AddFreeRange(rangeBaseId + count, rangeCount - count);
+    }
+
+    _allocatedRanges.emplace(rangeBaseId, count);
+    _allocatedCount += count;
+    return rangeBaseId;
+}
+
+bool ImageIdAllocator::Free(uint32_t baseId, uint32_t count)
+{
+    auto allocated = _allocatedRanges.find(baseId);
+    if (allocated == _allocatedRanges.end() || allocated->second != count)
+    {
+        return false;
+    }
+    _allocatedRanges.erase(allocated);
+    _allocatedCount -= count;
+
+    // Merge with the free ranges directly before and after
+    auto next = _freeRanges.lower_bound(baseId);
+    if (next != _freeRanges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == baseId)
+        {
+            baseId = previous->first;
+            count += previous->second;
+            RemoveFreeRange(previous);
+        }
+    }
+    if (next != _freeRanges.end() && baseId + count == next->first)
+    {
+        count += next->second;
+        RemoveFreeRange(next);
+    }
+
+    AddFreeRange(baseId, count);
+    return true;
+}
+
+void ImageIdAllocator::Reset()
+{
+    _freeRanges.clear();
+    _freeRangesBySize.clear();
+    _allocatedRanges.clear();
+    _allocatedCount = 0;
+    if (_capacity > 0)
+    {
+        AddFreeRange(_baseId, _capacity);
+    }
+}
+
+ImageIdAllocator::Stats ImageIdAllocator::GetStats() const
+{
+    Stats stats;
+    stats.Capacity = _capacity;
+    stats.Allocated = _allocatedCount;
+    stats.Allocations = static_cast<uint32_t>(_allocatedRanges.size());
+    stats.FreeRanges = static_cast<uint32_t>(_freeRanges.size());
+    if (!_freeRangesBySize.empty())
+    {
+        stats.LargestFreeRange = _freeRangesBySize.rbegin()->first;
+    }
+    return stats;
+}
+
+void ImageIdAllocator::AddFreeRange(uint32_t baseId, uint32_t count)
+{
+    _freeRanges.emplace(baseId, count);
+    _freeRangesBySize.emplace(count, baseId);
+}
+
+void ImageIdAllocator::RemoveFreeRange(std::map<uint32_t, uint32_t>::iterator it)
+{
+    _freeRangesBySize.erase({ it->second, it->first });
+    _freeRanges.erase(it);
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Allocates contiguous ranges of ids from a fixed range of ids, such as the image ids used for object images.
+ * Free ranges are indexed both by their first id, so that freed ranges are merged with their neighbours straight away,
+ * and by their size, so that allocating picks the smallest range that fits. Both take O(log n) in the number of free
+ * ranges.
+ */
+class ImageIdAllocator
+{
+public:
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    struct Stats
+    {
+        uint32_t Capacity{};
+        uint32_t Allocated{};
+        uint32_t Allocations{};
+        uint32_t FreeRanges{};
+        uint32_t LargestFreeRange{};
+
+        /**
+         * Gets the share of free ids that are not part of the largest free range, from 0 (all free ids are in one
+         * range) to 1.
+         */
+        double GetFragmentation() const
+        {
+            const auto free = Capacity - Allocated;
+            return free == 0 ? 0.0 : 1.0 - static_cast<double>(LargestFreeRange) / free;
+        }
+    };
+
+private:
+    uint32_t const _baseId;
+    uint32_t const _capacity;
+    uint32_t _allocatedCount = 0;
+
+    // First id -> count
+    std::map<uint32_t, uint32_t> _freeRanges;
+    // (count, first id)
+    std::set<std::pair<uint32_t, uint32_t>> _freeRangesBySize;
+    // First id -> count, to validate frees
+    std::unordered_map<uint32_t, uint32_t> _allocatedRanges;
+
+public:
+    ImageIdAllocator(uint32_t baseId, uint32_t capacity);
+
+    /**
+     * Allocates count contiguous ids and returns the first one, or INVALID_ID if there is no free range large enough.
+     */
+    uint32_t Allocate(uint32_t count);
+
+    /**
+     * Frees a range returned by Allocate. Returns false, without freeing anything, if the range was not allocated.
+     */
+    bool Free(uint32_t baseId, uint32_t count);
+
+    void Reset();
+
+    Stats GetStats() const;
+
+private:
+    void AddFreeRange(uint32_t baseId, uint32_t count);
+    void RemoveFreeRange(std::map<uint32_t, uint32_t>::iterator it);
+};
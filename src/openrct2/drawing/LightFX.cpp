@@ -14,6 +14,7 @@
 #    include "../Game.h"
 #    include "../common.h"
 #    include "../config/Config.h"
+#    include "../core/JobPool.hpp"
 #    include "../interface/Viewport.h"
 #    include "../interface/Window.h"
 #    include "../interface/Window_internal.h"
@@ -26,8 +27,11 @@
 #    include "Drawing.h"
 
 #    include <algorithm>
+#    include <chrono>
 #    include <cmath>
 #    include <cstring>
+#    include <functional>
+#    include <thread>
 
 static uint8_t _bakedLightTexture_lantern_0[32 * 32];
 static uint8_t _bakedLightTexture_lantern_1[64 * 64];
@@ -79,6 +83,109 @@ static ZoomLevel _current_view_zoom_back_delay = 0;
 
 static GamePalette gPalette_light;
 
+/**
+ * The part of a light texture that is visible on screen.
+ */
+struct LightFXRect
+{
+    const uint8_t* Source;
+    int32_t SourcePitch;
+    int32_t X;
+    int32_t Y;
+    int32_t Width;
+    int32_t Height;
+    uint8_t Intensity;
+};
+
+// Bands smaller than this are not worth handing to another thread
+constexpr int32_t LIGHTFX_MIN_BAND_HEIGHT = 32;
+
+static std::vector<LightFXRect> _lightRects;
+static std::unique_ptr<JobPool> _lightJobs;
+
+static constexpr LightFXKernels LightFXKernelsScalar = { "Scalar", lightfx_add_row_scalar, lightfx_compose_row_scalar };
+static constexpr LightFXKernels LightFXKernelsSSE41 = { "SSE4.1", lightfx_add_row_sse4_1, lightfx_compose_row_sse4_1 };
+static constexpr LightFXKernels LightFXKernelsAVX2 = { "AVX2", lightfx_add_row_avx2, lightfx_compose_row_avx2 };
+
+static const LightFXKernels* _lightKernels = &LightFXKernelsScalar;
+
+void lightfx_kernels_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 light functions");
+        _lightKernels = &LightFXKernelsAVX2;
+    }
+    else if (sse41_available())
+    {
+        log_verbose("registering SSE4.1 light functions");
+        _lightKernels = &LightFXKernelsSSE41;
+    }
+    else
+    {
+        log_verbose("registering scalar light functions");
+        _lightKernels = &LightFXKernelsScalar;
+    }
+}
+
+const LightFXKernels& lightfx_get_kernels()
+{
+    return *_lightKernels;
+}
+
+void lightfx_set_kernels(const LightFXKernels& kernels)
+{
+    for (auto available : { &LightFXKernelsScalar, &LightFXKernelsSSE41, &LightFXKernelsAVX2 })
+    {
+        if (std::strcmp(available->Name, kernels.Name) == 0)
+        {
+            _lightKernels = available;
+        }
+    }
+}
+
+std::vector<LightFXKernels> lightfx_get_available_kernels()
+{
+    std::vector<LightFXKernels> result = { LightFXKernelsScalar };
+    if (sse41_available())
+        result.push_back(LightFXKernelsSSE41);
+    if (avx2_available())
+        result.push_back(LightFXKernelsAVX2);
+    return result;
+}
+
+/**
+ * Calls fn for bands of rows covering the given height, spread across the light job pool when multithreading is
+ * enabled. Bands never overlap, so fn may write to its own rows of a shared buffer.
+ */
+static void lightfx_for_each_band(int32_t height, const std::function<void(int32_t top, int32_t bottom)>& fn)
+{
+    bool useMultithreading = gConfigGeneral.multithreading;
+    if (useMultithreading && _lightJobs == nullptr)
+    {
+        _lightJobs = std::make_unique<JobPool>();
+    }
+    else if (useMultithreading == false && _lightJobs != nullptr)
+    {
+        _lightJobs.reset();
+    }
+
+    const int32_t bandCount = std::min<int32_t>(std::thread::hardware_concurrency(), height / LIGHTFX_MIN_BAND_HEIGHT);
+    if (_lightJobs == nullptr || bandCount <= 1)
+    {
+        fn(0, height);
+        return;
+    }
+
+    const int32_t bandHeight = (height + bandCount - 1) / bandCount;
+    for (int32_t top = 0; top < height; top += bandHeight)
+    {
+        const int32_t bottom = std::min(top + bandHeight, height);
+        _lightJobs->AddTask([&fn, top, bottom]() { fn(top, bottom); });
+    }
+    _lightJobs->Join();
+}
+
 static uint8_t calc_light_intensity_lantern(int32_t x, int32_t y)
 {
     double distance = static_cast<double>(x * x + y * y);
@@ -448,20 +555,17 @@ void lightfx_render_lights_to_frontbuffer()
         return;
     }
 
-    std::memset(_light_rendered_buffer_front, 0, _pixelInfo.width * _pixelInfo.height);
-
     _lightPolution_back = 0;
+    _lightRects.clear();
 
     //  log_warning("%i lights", LightListCurrentCountFront);
 
     for (uint32_t light = 0; light < LightListCurrentCountFront; light++)
     {
         const uint8_t* bufReadBase = nullptr;
-        uint8_t* bufWriteBase = static_cast<uint8_t*>(_light_rendered_buffer_front);
         uint32_t bufReadWidth, bufReadHeight;
         int32_t bufWriteX, bufWriteY;
         int32_t bufWriteWidth, bufWriteHeight;
-        uint32_t bufReadSkip, bufWriteSkip;
 
         lightlist_entry* entry = &_LightListFront[light];
 
@@ -532,10 +636,7 @@ void lightfx_render_lights_to_frontbuffer()
         {
             bufReadBase += -bufWriteX;
             bufWriteWidth += bufWriteX;
-        }
-        else
-        {
-            bufWriteBase += bufWriteX;
+            bufWriteX = 0;
         }
 
         if (bufWriteWidth <= 0)
@@ -545,10 +646,7 @@ void lightfx_render_lights_to_frontbuffer()
         {
             bufReadBase += -bufWriteY * bufReadWidth;
             bufWriteHeight += bufWriteY;
-        }
-        else
-        {
-            bufWriteBase += bufWriteY * _pixelInfo.width;
+            bufWriteY = 0;
         }
 
         if (bufWriteHeight <= 0)
@@ -573,40 +671,28 @@ void lightfx_render_lights_to_frontbuffer()
 
         _lightPolution_back += (bufWriteWidth * bufWriteHeight) / 256;
 
-        bufReadSkip = bufReadWidth - bufWriteWidth;
-        bufWriteSkip = _pixelInfo.width - bufWriteWidth;
-
-        if (entry->lightIntensity == 0xFF)
-        {
-            for (int32_t y = 0; y < bufWriteHeight; y++)
-            {
-                for (int32_t x = 0; x < bufWriteWidth; x++)
-                {
-                    *bufWriteBase = std::min(0xFF, *bufWriteBase + *bufReadBase);
-                    bufWriteBase++;
-                    bufReadBase++;
-                }
+        _lightRects.push_back({ bufReadBase, static_cast<int32_t>(bufReadWidth), bufWriteX, bufWriteY, bufWriteWidth,
+                                bufWriteHeight, entry->lightIntensity });
+    }
 
-                bufWriteBase += bufWriteSkip;
-                bufReadBase += bufReadSkip;
-            }
-        }
-        else
+    // Each band clears its rows and adds the rows of every light that overlaps it
+    const auto& kernels = lightfx_get_kernels();
+    auto bufWriteBase = static_cast<uint8_t*>(_light_rendered_buffer_front);
+    const int32_t bufWritePitch = _pixelInfo.width;
+    lightfx_for_each_band(_pixelInfo.height, [&](int32_t top, int32_t bottom) {
+        std::memset(bufWriteBase + top * bufWritePitch, 0, (bottom - top) * bufWritePitch);
+        for (const auto& rect : _lightRects)
         {
-            for (int32_t y = 0; y < bufWriteHeight; y++)
+            const int32_t rectTop = std::max(top, rect.Y);
+            const int32_t rectBottom = std::min(bottom, rect.Y + rect.Height);
+            for (int32_t y = rectTop; y < rectBottom; y++)
             {
-                for (int32_t x = 0; x < bufWriteWidth; x++)
-                {
-                    *bufWriteBase = std::min(0xFF, *bufWriteBase + (((*bufReadBase) * (1 + entry->lightIntensity)) >> 8));
-                    bufWriteBase++;
-                    bufReadBase++;
-                }
-
-                bufWriteBase += bufWriteSkip;
-                bufReadBase += bufReadSkip;
+                kernels.AddRow(
+                    bufWriteBase + y * bufWritePitch + rect.X, rect.Source + (y - rect.Y) * rect.SourcePitch, rect.Width,
+                    rect.Intensity);
             }
         }
-    }
+    });
 }
 
 void* lightfx_get_front_buffer()
@@ -991,6 +1077,65 @@ static uint8_t mix_light(uint32_t a, uint32_t b, uint32_t intensity)
     return result;
 }
 
+void lightfx_add_row_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity)
+{
+    if (intensity == 0xFF)
+    {
+        for (int32_t x = 0; x < count; x++)
+        {
+            dst[x] = std::min(0xFF, dst[x] + src[x]);
+        }
+    }
+    else
+    {
+        for (int32_t x = 0; x < count; x++)
+        {
+            dst[x] = std::min(0xFF, dst[x] + ((src[x] * (1 + intensity)) >> 8));
+        }
+    }
+}
+
+void lightfx_compose_row_scalar(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    for (int32_t x = 0; x < count; x++)
+    {
+        uint32_t darkColour = palette[bits[x]];
+        uint32_t lightColour = lightPalette[bits[x]];
+        uint8_t lightIntensity = light[x];
+
+        uint32_t colour = 0;
+        if (lightIntensity == 0)
+        {
+            colour = darkColour;
+        }
+        else
+        {
+            colour |= mix_light((darkColour >> 0) & 0xFF, (lightColour >> 0) & 0xFF, lightIntensity);
+            colour |= mix_light((darkColour >> 8) & 0xFF, (lightColour >> 8) & 0xFF, lightIntensity) << 8;
+            colour |= mix_light((darkColour >> 16) & 0xFF, (lightColour >> 16) & 0xFF, lightIntensity) << 16;
+            colour |= mix_light((darkColour >> 24) & 0xFF, (lightColour >> 24) & 0xFF, lightIntensity) << 24;
+        }
+        dst[x] = colour;
+    }
+}
+
+static void lightfx_compose(
+    void* dstPixels, uint32_t dstPitch, const uint8_t* bits, const uint8_t* lightBits, uint32_t width, uint32_t height,
+    const uint32_t* palette, const uint32_t* lightPalette)
+{
+    const auto& kernels = lightfx_get_kernels();
+    lightfx_for_each_band(height, [&](int32_t top, int32_t bottom) {
+        for (int32_t y = top; y < bottom; y++)
+        {
+            uintptr_t dstOffset = static_cast<uintptr_t>(y * dstPitch);
+            uint32_t* dst = reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(dstPixels) + dstOffset);
+            kernels.ComposeRow(dst, &bits[y * width], &lightBits[y * width], width, palette, lightPalette);
+        }
+    });
+}
+
 void lightfx_render_to_texture(
     void* dstPixels, uint32_t dstPitch, uint8_t* bits, uint32_t width, uint32_t height, const uint32_t* palette,
     const uint32_t* lightPalette)
@@ -1006,32 +1151,87 @@ void lightfx_render_to_texture(
         return;
     }
 
-    for (uint32_t y = 0; y < height; y++)
+    lightfx_compose(dstPixels, dstPitch, bits, lightBits, width, height, palette, lightPalette);
+}
+
+void lightfx_benchmark_start(rct_drawpixelinfo* dpi, const rct_viewport& viewport)
+{
+    lightfx_update_buffers(dpi);
+
+    _current_view_x_back = viewport.viewPos.x;
+    _current_view_y_back = viewport.viewPos.y;
+    _current_view_rotation_back = get_current_rotation();
+    _current_view_zoom_back = viewport.zoom;
+    LightListCurrentCountBack = 0;
+}
+
+std::vector<LightFXBenchmark> lightfx_benchmark_run(int32_t iterations)
+{
+    // Move the lights collected while painting to the front, skipping the frame of delay for the zoom
+    std::swap(_LightListBack, _LightListFront);
+    LightListCurrentCountFront = LightListCurrentCountBack;
+    LightListCurrentCountBack = 0;
+    _current_view_x_front = _current_view_x_back;
+    _current_view_y_front = _current_view_y_back;
+    _current_view_rotation_front = _current_view_rotation_back;
+    _current_view_zoom_front = _current_view_zoom_back;
+
+    // Night time palettes, the same conversion as the hardware display engine
+    uint32_t palette[256];
+    uint32_t lightPalette[256];
+    const auto originalDayNightCycle = gDayNightCycle;
+    gDayNightCycle = 1.0f;
+    for (int32_t i = 0; i < 256; i++)
     {
-        uintptr_t dstOffset = static_cast<uintptr_t>(y * dstPitch);
-        uint32_t* dst = reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(dstPixels) + dstOffset);
-        for (uint32_t x = 0; x < width; x++)
+        uint8_t r = gPalette[i].Red;
+        uint8_t g = gPalette[i].Green;
+        uint8_t b = gPalette[i].Blue;
+        lightfx_apply_palette_filter(i, &r, &g, &b);
+        palette[i] = (0xFF << 24) | (r << 16) | (g << 8) | b;
+        const auto& lightEntry = gPalette_light[i];
+        lightPalette[i] = (0xFF << 24) | (lightEntry.Red << 16) | (lightEntry.Green << 8) | lightEntry.Blue;
+    }
+
+    const uint32_t width = _pixelInfo.width;
+    const uint32_t height = _pixelInfo.height;
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+
+    // Preparing the lights occludes and dims them in place, so every iteration starts from the collected lights
+    const std::vector<lightlist_entry> lights(_LightListFront, _LightListFront + LightListCurrentCountFront);
+
+    const auto originalKernels = lightfx_get_kernels();
+    const auto originalMultithreading = gConfigGeneral.multithreading;
+    std::vector<LightFXBenchmark> results;
+    for (const auto& kernels : lightfx_get_available_kernels())
+    {
+        lightfx_set_kernels(kernels);
+        for (bool multithreaded : { false, true })
         {
-            uint8_t* src = &bits[y * width + x];
-            uint32_t darkColour = palette[*src];
-            uint32_t lightColour = lightPalette[*src];
-            uint8_t lightIntensity = lightBits[y * width + x];
+            gConfigGeneral.multithreading = multithreaded;
 
-            uint32_t colour = 0;
-            if (lightIntensity == 0)
-            {
-                colour = darkColour;
-            }
-            else
+            double time = 0;
+            for (int32_t i = 0; i < iterations; i++)
             {
-                colour |= mix_light((darkColour >> 0) & 0xFF, (lightColour >> 0) & 0xFF, lightIntensity);
-                colour |= mix_light((darkColour >> 8) & 0xFF, (lightColour >> 8) & 0xFF, lightIntensity) << 8;
-                colour |= mix_light((darkColour >> 16) & 0xFF, (lightColour >> 16) & 0xFF, lightIntensity) << 16;
-                colour |= mix_light((darkColour >> 24) & 0xFF, (lightColour >> 24) & 0xFF, lightIntensity) << 24;
+                std::copy(lights.begin(), lights.end(), _LightListFront);
+
+                const auto startTime = std::chrono::high_resolution_clock::now();
+                lightfx_prepare_light_list();
+                lightfx_render_lights_to_frontbuffer();
+                lightfx_compose(
+                    pixels.data(), width * sizeof(uint32_t), _pixelInfo.bits,
+                    static_cast<const uint8_t*>(_light_rendered_buffer_front), width, height, palette, lightPalette);
+                const auto endTime = std::chrono::high_resolution_clock::now();
+                time += std::chrono::duration<double>(endTime - startTime).count();
             }
-            *dst++ = colour;
+
+            results.push_back({ kernels.Name, multithreaded, static_cast<uint32_t>(_lightRects.size()), time });
         }
     }
+    lightfx_set_kernels(originalKernels);
+    gConfigGeneral.multithreading = originalMultithreading;
+    gDayNightCycle = originalDayNightCycle;
+    _lightJobs.reset();
+    return results;
 }
 
 #endif // __ENABLE_LIGHTFX__
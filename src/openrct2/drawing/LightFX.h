@@ -14,9 +14,12 @@
 
 #    include "../common.h"
 
+#    include <vector>
+
 struct CoordsXY;
 struct Vehicle;
 struct rct_drawpixelinfo;
+struct rct_viewport;
 struct GamePalette;
 
 enum LIGHTFX_LIGHT_TYPE
@@ -73,6 +76,57 @@ void lightfx_render_to_texture(
     void* dstPixels, uint32_t dstPitch, uint8_t* bits, uint32_t width, uint32_t height, const uint32_t* palette,
     const uint32_t* lightPalette);
 
+void lightfx_add_row_scalar(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity);
+void lightfx_add_row_sse4_1(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity);
+void lightfx_add_row_avx2(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity);
+void lightfx_compose_row_scalar(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette);
+void lightfx_compose_row_sse4_1(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette);
+void lightfx_compose_row_avx2(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette);
+
+/**
+ * The row functions used to accumulate lights into the light buffer and to mix the light buffer into the screen.
+ */
+struct LightFXKernels
+{
+    const char* Name;
+    // Adds a row of a light texture to the light buffer, scaled by (intensity + 1) / 256 and saturating at 0xFF
+    void (*AddRow)(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity);
+    // Converts a row of palette indices to 32-bit colours, mixing in the light palette by the light buffer
+    void (*ComposeRow)(
+        uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+        const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette);
+};
+
+void lightfx_kernels_init();
+const LightFXKernels& lightfx_get_kernels();
+void lightfx_set_kernels(const LightFXKernels& kernels);
+std::vector<LightFXKernels> lightfx_get_available_kernels();
+
+struct LightFXBenchmark
+{
+    const char* Kernels;
+    bool Multithreaded;
+    uint32_t Lights;
+    double Seconds;
+};
+
+/**
+ * Starts collecting the lights of the given viewport, which must then be painted into dpi.
+ */
+void lightfx_benchmark_start(rct_drawpixelinfo* dpi, const rct_viewport& viewport);
+
+/**
+ * Occludes and renders the collected lights and mixes them into a 32-bit copy of dpi the given number of times, with
+ * every available set of row functions both on a single thread and split into bands across worker threads.
+ */
+std::vector<LightFXBenchmark> lightfx_benchmark_run(int32_t iterations);
+
 #endif // __ENABLE_LIGHTFX__
 
 #endif
@@ -10,9 +10,11 @@
 #include "../common.h"
 #include "../core/Guard.hpp"
 #include "Drawing.h"
+#include "LightFX.h"
 
 #ifdef __SSE4_1__
 
+#    include <cstring>
 #    include <immintrin.h>
 
 void mask_sse4_1(
@@ -56,6 +58,102 @@ void mask_sse4_1(
     }
 }
 
+void rle_copy_run_sse4_1(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count)
+{
+    if (count < 16)
+    {
+        rle_copy_run_scalar(dst, src, count);
+        return;
+    }
+
+    int32_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pixels);
+    }
+    if (i < count)
+    {
+        // Finish with an overlapping copy of the last 16 pixels
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + count - 16), pixels);
+    }
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_row_sse4_1(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity)
+{
+    int32_t i = 0;
+    if (intensity == 0xFF)
+    {
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i light = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i buffer = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_adds_epu8(buffer, light));
+        }
+    }
+    else
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i scale = _mm_set1_epi16(1 + intensity);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i light = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(light, zero), scale), 8);
+            const __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(light, zero), scale), 8);
+            const __m128i buffer = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_adds_epu8(buffer, _mm_packus_epi16(lo, hi)));
+        }
+    }
+    lightfx_add_row_scalar(dst + i, src + i, count - i, intensity);
+}
+
+// Adds (lit * k) >> 8 to dark for 16-bit channels, the product needs up to 19 bits
+static __m128i lightfx_mix_sse4_1(__m128i dark, __m128i lit, __m128i k)
+{
+    const __m128i lo = _mm_mullo_epi16(lit, k);
+    const __m128i hi = _mm_mulhi_epu16(lit, k);
+    return _mm_add_epi16(dark, _mm_or_si128(_mm_slli_epi16(hi, 8), _mm_srli_epi16(lo, 8)));
+}
+
+void lightfx_compose_row_sse4_1(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i six = _mm_set1_epi32(6);
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int32_t intensities;
+        std::memcpy(&intensities, light + i, sizeof(intensities));
+        const __m128i dark = _mm_set_epi32(
+            palette[bits[i + 3]], palette[bits[i + 2]], palette[bits[i + 1]], palette[bits[i]]);
+        if (intensities == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), dark);
+            continue;
+        }
+        const __m128i lit = _mm_set_epi32(
+            lightPalette[bits[i + 3]], lightPalette[bits[i + 2]], lightPalette[bits[i + 1]], lightPalette[bits[i]]);
+
+        // Spread the intensity of each pixel over its four channels
+        __m128i k = _mm_mullo_epi16(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(intensities)), six);
+        k = _mm_or_si128(k, _mm_slli_epi32(k, 16));
+
+        const __m128i lo = lightfx_mix_sse4_1(
+            _mm_unpacklo_epi8(dark, zero), _mm_unpacklo_epi8(lit, zero), _mm_unpacklo_epi32(k, k));
+        const __m128i hi = lightfx_mix_sse4_1(
+            _mm_unpackhi_epi8(dark, zero), _mm_unpackhi_epi8(lit, zero), _mm_unpackhi_epi32(k, k));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    lightfx_compose_row_scalar(dst + i, bits + i, light + i, count - i, palette, lightPalette);
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -69,4 +167,25 @@ void mask_sse4_1(
     openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
 }
 
+void rle_copy_run_sse4_1(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_row_sse4_1(uint8_t* RESTRICT dst, const uint8_t* RESTRICT src, int32_t count, uint8_t intensity)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void lightfx_compose_row_sse4_1(
+    uint32_t* RESTRICT dst, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT light, int32_t count,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #endif // __SSE4_1__
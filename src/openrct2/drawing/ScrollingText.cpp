@@ -17,24 +17,66 @@
 #include "TTF.h"
 
 #include <algorithm>
+#include <array>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+
+struct ScrollingTextKey
+{
+    rct_string_id StringId;
+    std::array<uint8_t, 32> Args;
+    colour_t Colour;
+    uint16_t Position;
+    uint16_t Mode;
+
+    bool operator==(const ScrollingTextKey& other) const
+    {
+        return StringId == other.StringId && Args == other.Args && Colour == other.Colour && Position == other.Position
+            && Mode == other.Mode;
+    }
+};
+
+struct ScrollingTextKeyHash
+{
+    size_t operator()(const ScrollingTextKey& key) const
+    {
+        // FNV-1a
+        uint32_t hash = 0x811C9DC5;
+        auto add = [&hash](uint32_t value) { hash = (hash ^ value) * 0x01000193; };
+        add(key.StringId);
+        for (auto b : key.Args)
+        {
+            add(b);
+        }
+        add(key.Colour);
+        add(key.Position);
+        add(key.Mode);
+        return hash;
+    }
+};
 
 struct rct_draw_scroll_text
 {
-    rct_string_id string_id;
-    uint8_t string_args[32];
-    colour_t colour;
-    uint16_t position;
-    uint16_t mode;
-    uint32_t id;
+    ScrollingTextKey Key;
+    bool InUse;
+    uint32_t ImageId;
+    std::list<size_t>::iterator LruPosition;
     uint8_t bitmap[64 * 40];
 };
 
-constexpr int32_t MAX_SCROLLING_TEXT_ENTRIES = 32;
+// The first entries use the scrolling text images of g1.dat, the rest are allocated from the image list
+constexpr int32_t MIN_SCROLLING_TEXT_ENTRIES = SPR_SCROLLING_TEXT_END - SPR_SCROLLING_TEXT_START;
+constexpr int32_t MAX_SCROLLING_TEXT_ENTRIES = 4096;
 
-static rct_draw_scroll_text _drawScrollTextList[MAX_SCROLLING_TEXT_ENTRIES];
+static std::unique_ptr<rct_draw_scroll_text[]> _drawScrollTextList;
+static size_t _drawScrollTextCount;
+static uint32_t _drawScrollTextImageBase = UINT32_MAX;
+// Indices into _drawScrollTextList, most recently used first
+static std::list<size_t> _drawScrollTextLru;
+static std::unordered_map<ScrollingTextKey, size_t, ScrollingTextKeyHash> _drawScrollTextIndex;
 static uint8_t _characterBitmaps[FONT_SPRITE_GLYPH_COUNT + SPR_G2_GLYPH_COUNT][8];
-static uint32_t _drawSCrollNextIndex = 0;
 static std::mutex _scrollingTextMutex;
 
 static void scrolling_text_set_bitmap_for_sprite(
@@ -93,25 +135,74 @@ void scrolling_text_initialise_bitmaps()
         }
     }
 
-    for (int32_t i = 0; i < MAX_SCROLLING_TEXT_ENTRIES; i++)
+    scrolling_text_dispose();
+
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+
+    const rct_g1_element* g1original = gfx_get_g1_element(SPR_SCROLLING_TEXT_START);
+    if (g1original == nullptr)
+        return;
+
+    auto count = std::clamp<int32_t>(
+        gConfigGeneral.scrolling_text_cache_size, MIN_SCROLLING_TEXT_ENTRIES, MAX_SCROLLING_TEXT_ENTRIES);
+    _drawScrollTextList = std::make_unique<rct_draw_scroll_text[]>(count);
+
+    std::vector<rct_g1_element> elements(count);
+    for (int32_t i = 0; i < count; i++)
     {
-        int32_t imageId = SPR_SCROLLING_TEXT_START + i;
-        const rct_g1_element* g1original = gfx_get_g1_element(imageId);
-        if (g1original != nullptr)
+        rct_g1_element& g1 = elements[i];
+        g1 = *g1original;
+        g1.offset = _drawScrollTextList[i].bitmap;
+        g1.width = 64;
+        g1.height = 40;
+        g1.offset[0] = 0xFF;
+        g1.offset[1] = 0xFF;
+        g1.offset[14] = 0;
+        g1.offset[15] = 0;
+        g1.offset[16] = 0;
+        g1.offset[17] = 0;
+    }
+
+    for (int32_t i = 0; i < MIN_SCROLLING_TEXT_ENTRIES; i++)
+    {
+        _drawScrollTextList[i].ImageId = SPR_SCROLLING_TEXT_START + i;
+        gfx_set_g1_element(SPR_SCROLLING_TEXT_START + i, &elements[i]);
+    }
+    if (count > MIN_SCROLLING_TEXT_ENTRIES)
+    {
+        _drawScrollTextImageBase = gfx_object_allocate_images(
+            &elements[MIN_SCROLLING_TEXT_ENTRIES], count - MIN_SCROLLING_TEXT_ENTRIES);
+        if (_drawScrollTextImageBase == UINT32_MAX)
         {
-            rct_g1_element g1 = *g1original;
-            g1.offset = _drawScrollTextList[i].bitmap;
-            g1.width = 64;
-            g1.height = 40;
-            g1.offset[0] = 0xFF;
-            g1.offset[1] = 0xFF;
-            g1.offset[14] = 0;
-            g1.offset[15] = 0;
-            g1.offset[16] = 0;
-            g1.offset[17] = 0;
-            gfx_set_g1_element(imageId, &g1);
+            count = MIN_SCROLLING_TEXT_ENTRIES;
         }
     }
+    for (int32_t i = MIN_SCROLLING_TEXT_ENTRIES; i < count; i++)
+    {
+        _drawScrollTextList[i].ImageId = _drawScrollTextImageBase + (i - MIN_SCROLLING_TEXT_ENTRIES);
+    }
+
+    _drawScrollTextCount = count;
+    for (int32_t i = 0; i < count; i++)
+    {
+        _drawScrollTextList[i].LruPosition = _drawScrollTextLru.insert(_drawScrollTextLru.end(), i);
+    }
+}
+
+void scrolling_text_dispose()
+{
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+
+    if (_drawScrollTextImageBase != UINT32_MAX)
+    {
+        gfx_object_free_images(
+            _drawScrollTextImageBase, static_cast<uint32_t>(_drawScrollTextCount - MIN_SCROLLING_TEXT_ENTRIES));
+        _drawScrollTextImageBase = UINT32_MAX;
+    }
+    _drawScrollTextIndex.clear();
+    _drawScrollTextLru.clear();
+    _drawScrollTextList.reset();
+    _drawScrollTextCount = 0;
 }
 
 static uint8_t* font_sprite_get_codepoint_bitmap(int32_t codepoint)
@@ -127,41 +218,38 @@ static uint8_t* font_sprite_get_codepoint_bitmap(int32_t codepoint)
     }
 }
 
-static int32_t scrolling_text_get_matching_or_oldest(
-    rct_string_id stringId, uint16_t scroll, uint16_t scrollingMode, colour_t colour)
+/**
+ * Returns the entry for the given text, or the least recently used entry with matching set to false. Either way the
+ * entry becomes the most recently used one.
+ */
+static rct_draw_scroll_text* scrolling_text_get_matching_or_oldest(const ScrollingTextKey& key, bool& matching)
 {
-    uint32_t oldestId = 0xFFFFFFFF;
-    int32_t scrollIndex = -1;
-    for (int32_t i = 0; i < MAX_SCROLLING_TEXT_ENTRIES; i++)
+    size_t index;
+    auto it = _drawScrollTextIndex.find(key);
+    matching = it != _drawScrollTextIndex.end();
+    if (matching)
     {
-        rct_draw_scroll_text* scrollText = &_drawScrollTextList[i];
-        if (oldestId >= scrollText->id)
-        {
-            oldestId = scrollText->id;
-            scrollIndex = i;
-        }
-
-        // If exact match return the matching index
-        if (scrollText->string_id == stringId
-            && std::memcmp(scrollText->string_args, gCommonFormatArgs, sizeof(scrollText->string_args)) == 0
-            && scrollText->colour == colour && scrollText->position == scroll && scrollText->mode == scrollingMode)
-        {
-            scrollText->id = _drawSCrollNextIndex;
-            return i + SPR_SCROLLING_TEXT_START;
-        }
+        index = it->second;
+    }
+    else
+    {
+        index = _drawScrollTextLru.back();
     }
-    return scrollIndex;
+
+    auto scrollText = &_drawScrollTextList[index];
+    _drawScrollTextLru.splice(_drawScrollTextLru.begin(), _drawScrollTextLru, scrollText->LruPosition);
+    return scrollText;
 }
 
 static void scrolling_text_format(utf8* dst, size_t size, rct_draw_scroll_text* scrollText)
 {
     if (gConfigGeneral.upper_case_banners)
     {
-        format_string_to_upper(dst, size, scrollText->string_id, scrollText->string_args);
+        format_string_to_upper(dst, size, scrollText->Key.StringId, scrollText->Key.Args.data());
     }
     else
     {
-        format_string(dst, size, scrollText->string_id, scrollText->string_args);
+        format_string(dst, size, scrollText->Key.StringId, scrollText->Key.Args.data());
     }
 }
 
@@ -1433,16 +1521,17 @@ static constexpr const int16_t* _scrollPositions[MAX_SCROLLING_TEXT_MODES] = {
 
 void scrolling_text_invalidate()
 {
-    for (int32_t i = 0; i < MAX_SCROLLING_TEXT_ENTRIES; i++)
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+
+    _drawScrollTextIndex.clear();
+    for (size_t i = 0; i < _drawScrollTextCount; i++)
     {
-        rct_draw_scroll_text& scrollText = _drawScrollTextList[i];
-        scrollText.string_id = 0;
-        std::memset(scrollText.string_args, 0, sizeof(scrollText.string_args));
+        _drawScrollTextList[i].InUse = false;
     }
 }
 
 int32_t scrolling_text_setup(
-    paint_session* session, rct_string_id stringId, uint16_t scroll, uint16_t scrollingMode, colour_t colour)
+    paint_session* session, rct_string_id stringId, Formatter& ft, uint16_t scroll, uint16_t scrollingMode, colour_t colour)
 {
     std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
 
@@ -1450,23 +1539,29 @@ int32_t scrolling_text_setup(
 
     rct_drawpixelinfo* dpi = &session->DPI;
 
-    if (dpi->zoom_level > 0)
+    if (dpi->zoom_level > 0 || _drawScrollTextCount == 0)
         return SPR_SCROLLING_TEXT_DEFAULT;
 
-    _drawSCrollNextIndex++;
+    ScrollingTextKey key{};
+    key.StringId = stringId;
+    std::memcpy(key.Args.data(), ft.Data(), std::min(ft.NumBytes(), key.Args.size()));
+    key.Colour = colour;
+    key.Position = scroll;
+    key.Mode = scrollingMode;
 
-    int32_t scrollIndex = scrolling_text_get_matching_or_oldest(stringId, scroll, scrollingMode, colour);
-    if (scrollIndex >= SPR_SCROLLING_TEXT_START)
-        return scrollIndex;
+    bool matching;
+    auto scrollText = scrolling_text_get_matching_or_oldest(key, matching);
+    if (matching)
+        return scrollText->ImageId;
 
     // Setup scrolling text
-    auto scrollText = &_drawScrollTextList[scrollIndex];
-    scrollText->string_id = stringId;
-    std::memcpy(scrollText->string_args, gCommonFormatArgs, sizeof(scrollText->string_args));
-    scrollText->colour = colour;
-    scrollText->position = scroll;
-    scrollText->mode = scrollingMode;
-    scrollText->id = _drawSCrollNextIndex;
+    if (scrollText->InUse)
+    {
+        _drawScrollTextIndex.erase(scrollText->Key);
+    }
+    scrollText->Key = key;
+    scrollText->InUse = true;
+    _drawScrollTextIndex.emplace(key, scrollText - _drawScrollTextList.get());
 
     // Create the string to draw
     utf8 scrollString[256];
@@ -1484,9 +1579,8 @@ int32_t scrolling_text_setup(
         scrolling_text_set_bitmap_for_sprite(scrollString, scroll, scrollText->bitmap, scrollingModePositions, colour);
     }
 
-    uint32_t imageId = SPR_SCROLLING_TEXT_START + scrollIndex;
-    drawing_engine_invalidate_image(imageId);
-    return imageId;
+    drawing_engine_invalidate_image(scrollText->ImageId);
+    return scrollText->ImageId;
 }
 
 static void scrolling_text_set_bitmap_for_sprite(
@@ -1588,7 +1682,7 @@ static void scrolling_text_set_bitmap_for_ttf(
     }
     *dstCh = 0;
 
-    TTFSurface* surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
+    auto surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
     if (surface == nullptr)
     {
         return;
@@ -9,8 +9,12 @@
 
 #ifndef NO_TTF
 
-#    include <atomic>
+#    include <array>
+#    include <list>
+#    include <memory>
 #    include <mutex>
+#    include <string>
+#    include <unordered_map>
 #    pragma clang diagnostic push
 #    pragma clang diagnostic ignored "-Wdocumentation"
 #    include <ft2build.h>
@@ -26,43 +30,167 @@
 
 static bool _ttfInitialised = false;
 
-#    define TTF_SURFACE_CACHE_SIZE 256
-#    define TTF_GETWIDTH_CACHE_SIZE 1024
+#    define TTF_SURFACE_CACHE_SIZE (4 * 1024 * 1024)
+#    define TTF_GETWIDTH_CACHE_SIZE (256 * 1024)
+#    define TTF_CACHE_SHARD_COUNT 16
 
-struct ttf_cache_entry
+/**
+ * Cache of values rendered from a font and string, bounded by the total size of its entries in bytes. The entries are
+ * spread over independently locked shards by hash, so threads painting different strings rarely wait on each other.
+ * Each shard evicts its least recently used entries once it goes over its share of the size limit.
+ */
+template<typename TValue> class TTFCache
 {
-    TTFSurface* surface;
-    TTF_Font* font;
-    utf8* text;
-    uint32_t lastUseTick;
-};
+private:
+    struct Entry
+    {
+        uint64_t Hash;
+        TTF_Font* Font;
+        std::string Text;
+        TValue Value;
+        size_t Size;
+    };
+
+    struct Shard
+    {
+        std::mutex Mutex;
+        // Most recently used first
+        std::list<Entry> Entries;
+        std::unordered_multimap<uint64_t, typename std::list<Entry>::iterator> Index;
+        size_t Size{};
+        size_t HitCount{};
+        size_t MissCount{};
+    };
+
+    std::array<Shard, TTF_CACHE_SHARD_COUNT> _shards;
+    const size_t _maxShardSize;
 
-struct ttf_getwidth_cache_entry
-{
-    uint32_t width;
-    TTF_Font* font;
-    utf8* text;
-    uint32_t lastUseTick;
-};
+public:
+    explicit TTFCache(size_t maxSize)
+        : _maxShardSize(maxSize / TTF_CACHE_SHARD_COUNT)
+    {
+    }
+
+    /**
+     * Returns the cached value for the given font and text, or creates one with the given function. The function is
+     * called without any shard locked and returns false if no value could be created, which is not cached.
+     */
+    template<typename TCreate> bool GetOrAdd(TTF_Font* font, const utf8* text, TValue& value, TCreate create)
+    {
+        const auto hash = Hash(font, text);
+        auto& shard = _shards[hash % TTF_CACHE_SHARD_COUNT];
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            auto it = Find(shard, hash, font, text);
+            if (it != shard.Entries.end())
+            {
+                shard.HitCount++;
+                shard.Entries.splice(shard.Entries.begin(), shard.Entries, it);
+                value = it->Value;
+                return true;
+            }
+            shard.MissCount++;
+        }
+
+        size_t size = 0;
+        if (!create(value, size))
+            return false;
 
-static ttf_cache_entry _ttfSurfaceCache[TTF_SURFACE_CACHE_SIZE] = {};
-static int32_t _ttfSurfaceCacheCount = 0;
-static int32_t _ttfSurfaceCacheHitCount = 0;
-static int32_t _ttfSurfaceCacheMissCount = 0;
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        if (Find(shard, hash, font, text) != shard.Entries.end())
+        {
+            // Another thread created the same entry in the meantime
+            return true;
+        }
+
+        std::string textCopy = text;
+        size += sizeof(Entry) + textCopy.size();
+        shard.Entries.push_front({ hash, font, std::move(textCopy), value, size });
+        shard.Index.emplace(hash, shard.Entries.begin());
+        shard.Size += size;
+        while (shard.Size > _maxShardSize && shard.Entries.size() > 1)
+        {
+            Evict(shard, std::prev(shard.Entries.end()));
+        }
+        return true;
+    }
 
-static ttf_getwidth_cache_entry _ttfGetWidthCache[TTF_GETWIDTH_CACHE_SIZE] = {};
-static int32_t _ttfGetWidthCacheCount = 0;
-static int32_t _ttfGetWidthCacheHitCount = 0;
-static int32_t _ttfGetWidthCacheMissCount = 0;
+    void Clear()
+    {
+        for (auto& shard : _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            shard.Index.clear();
+            shard.Entries.clear();
+            shard.Size = 0;
+        }
+    }
 
+    TTFCacheStats GetStats()
+    {
+        TTFCacheStats stats{};
+        for (auto& shard : _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            stats.HitCount += shard.HitCount;
+            stats.MissCount += shard.MissCount;
+            stats.EntryCount += shard.Entries.size();
+            stats.Size += shard.Size;
+        }
+        stats.MaxSize = _maxShardSize * TTF_CACHE_SHARD_COUNT;
+        return stats;
+    }
+
+private:
+    static uint64_t Hash(TTF_Font* font, const utf8* text)
+    {
+        // FNV-1a
+        uint64_t hash = 0xCBF29CE484222325 ^ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(font));
+        for (const utf8* ch = text; *ch != 0; ch++)
+        {
+            hash = (hash ^ static_cast<uint8_t>(*ch)) * 0x100000001B3;
+        }
+        return hash;
+    }
+
+    static typename std::list<Entry>::iterator Find(Shard& shard, uint64_t hash, TTF_Font* font, const utf8* text)
+    {
+        auto range = shard.Index.equal_range(hash);
+        for (auto it = range.first; it != range.second; it++)
+        {
+            auto entry = it->second;
+            if (entry->Font == font && entry->Text == text)
+            {
+                return entry;
+            }
+        }
+        return shard.Entries.end();
+    }
+
+    static void Evict(Shard& shard, typename std::list<Entry>::iterator entry)
+    {
+        auto range = shard.Index.equal_range(entry->Hash);
+        for (auto it = range.first; it != range.second; it++)
+        {
+            if (it->second == entry)
+            {
+                shard.Index.erase(it);
+                break;
+            }
+        }
+        shard.Size -= entry->Size;
+        shard.Entries.erase(entry);
+    }
+};
+
+static TTFCache<std::shared_ptr<const TTFSurface>> _ttfSurfaceCache(TTF_SURFACE_CACHE_SIZE);
+static TTFCache<uint32_t> _ttfGetWidthCache(TTF_GETWIDTH_CACHE_SIZE);
+
+// FreeType faces and the glyph cache of each font must only be used by one thread at a time
 static std::mutex _mutex;
 
 static TTF_Font* ttf_open_font(const utf8* fontPath, int32_t ptSize);
 static void ttf_close_font(TTF_Font* font);
-static uint32_t ttf_surface_cache_hash(TTF_Font* font, const utf8* text);
-static void ttf_surface_cache_dispose(ttf_cache_entry* entry);
-static void ttf_surface_cache_dispose_all();
-static void ttf_getwidth_cache_dispose_all();
 static bool ttf_get_size(TTF_Font* font, const utf8* text, int32_t* width, int32_t* height);
 static void ttf_toggle_hinting(bool);
 static TTFSurface* ttf_render(TTF_Font* font, const utf8* text);
@@ -101,10 +229,7 @@ static void ttf_toggle_hinting(bool)
         TTF_SetFontHinting(fontDesc->font, use_hinting ? 1 : 0);
     }
 
-    if (_ttfSurfaceCacheCount)
-    {
-        ttf_surface_cache_dispose_all();
-    }
+    _ttfSurfaceCache.Clear();
 }
 
 bool ttf_initialise()
@@ -153,8 +278,8 @@ void ttf_dispose()
     if (!_ttfInitialised)
         return;
 
-    ttf_surface_cache_dispose_all();
-    ttf_getwidth_cache_dispose_all();
+    _ttfSurfaceCache.Clear();
+    _ttfGetWidthCache.Clear();
 
     for (int32_t i = 0; i < FONT_SIZE_COUNT; i++)
     {
@@ -181,169 +306,57 @@ static void ttf_close_font(TTF_Font* font)
     TTF_CloseFont(font);
 }
 
-static uint32_t ttf_surface_cache_hash(TTF_Font* font, const utf8* text)
-{
-    uint32_t hash = static_cast<uint32_t>(((reinterpret_cast<uintptr_t>(font) * 23) ^ 0xAAAAAAAA) & 0xFFFFFFFF);
-    for (const utf8* ch = text; *ch != 0; ch++)
-    {
-        hash = ror32(hash, 3) ^ (*ch * 13);
-    }
-    return hash;
-}
-
-static void ttf_surface_cache_dispose(ttf_cache_entry* entry)
-{
-    if (entry->surface != nullptr)
-    {
-        ttf_free_surface(entry->surface);
-        free(entry->text);
-
-        entry->surface = nullptr;
-        entry->font = nullptr;
-        entry->text = nullptr;
-    }
-}
-
-static void ttf_surface_cache_dispose_all()
-{
-    for (int32_t i = 0; i < TTF_SURFACE_CACHE_SIZE; i++)
-    {
-        ttf_surface_cache_dispose(&_ttfSurfaceCache[i]);
-        _ttfSurfaceCacheCount--;
-    }
-}
-
 void ttf_toggle_hinting()
 {
     FontLockHelper<std::mutex> lock(_mutex);
     ttf_toggle_hinting(true);
 }
 
-TTFSurface* ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text)
+std::shared_ptr<const TTFSurface> ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text)
 {
-    ttf_cache_entry* entry;
-
-    uint32_t hash = ttf_surface_cache_hash(font, text);
-    int32_t index = hash % TTF_SURFACE_CACHE_SIZE;
+    using SurfacePtr = std::shared_ptr<const TTFSurface>;
 
-    FontLockHelper<std::mutex> lock(_mutex);
-
-    for (int32_t i = 0; i < TTF_SURFACE_CACHE_SIZE; i++)
-    {
-        entry = &_ttfSurfaceCache[index];
-
-        // Check if entry is a hit
-        if (entry->surface == nullptr)
-            break;
-        if (entry->font == font && strcmp(entry->text, text) == 0)
-        {
-            _ttfSurfaceCacheHitCount++;
-            entry->lastUseTick = gCurrentDrawCount;
-            return entry->surface;
-        }
-
-        // If entry hasn't been used for a while, replace it
-        if (entry->lastUseTick < gCurrentDrawCount - 64)
+    SurfacePtr surface;
+    _ttfSurfaceCache.GetOrAdd(font, text, surface, [font, text](SurfacePtr& value, size_t& size) {
+        TTFSurface* rendered;
         {
-            break;
+            FontLockHelper<std::mutex> lock(_mutex);
+            rendered = ttf_render(font, text);
         }
+        if (rendered == nullptr)
+            return false;
 
-        // Check if next entry is a hit
-        if (++index >= TTF_SURFACE_CACHE_SIZE)
-            index = 0;
-    }
-
-    // Cache miss, replace entry with new surface
-    entry = &_ttfSurfaceCache[index];
-    ttf_surface_cache_dispose(entry);
-
-    TTFSurface* surface = ttf_render(font, text);
-    if (surface == nullptr)
-    {
-        return nullptr;
-    }
-
-    _ttfSurfaceCacheMissCount++;
-    // printf("CACHE HITS: %d   MISSES: %d)\n", _ttfSurfaceCacheHitCount, _ttfSurfaceCacheMissCount);
-
-    _ttfSurfaceCacheCount++;
-    entry->surface = surface;
-    entry->font = font;
-    entry->text = _strdup(text);
-    entry->lastUseTick = gCurrentDrawCount;
-    return entry->surface;
+        size = sizeof(TTFSurface) + static_cast<size_t>(rendered->pitch) * rendered->h;
+        value = SurfacePtr(rendered, [](const TTFSurface* s) { ttf_free_surface(const_cast<TTFSurface*>(s)); });
+        return true;
+    });
+    return surface;
 }
 
-static void ttf_getwidth_cache_dispose(ttf_getwidth_cache_entry* entry)
+uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, const utf8* text)
 {
-    if (entry->text != nullptr)
-    {
-        free(entry->text);
-
-        entry->width = 0;
-        entry->font = nullptr;
-        entry->text = nullptr;
-    }
+    uint32_t width = 0;
+    _ttfGetWidthCache.GetOrAdd(font, text, width, [font, text](uint32_t& value, size_t& size) {
+        int32_t w = 0, h = 0;
+        {
+            FontLockHelper<std::mutex> lock(_mutex);
+            ttf_get_size(font, text, &w, &h);
+        }
+        value = w;
+        size = 0;
+        return true;
+    });
+    return width;
 }
 
-static void ttf_getwidth_cache_dispose_all()
+TTFCacheStats ttf_surface_cache_get_stats()
 {
-    for (int32_t i = 0; i < TTF_GETWIDTH_CACHE_SIZE; i++)
-    {
-        ttf_getwidth_cache_dispose(&_ttfGetWidthCache[i]);
-        _ttfGetWidthCacheCount--;
-    }
+    return _ttfSurfaceCache.GetStats();
 }
 
-uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, const utf8* text)
+TTFCacheStats ttf_getwidth_cache_get_stats()
 {
-    ttf_getwidth_cache_entry* entry;
-
-    uint32_t hash = ttf_surface_cache_hash(font, text);
-    int32_t index = hash % TTF_GETWIDTH_CACHE_SIZE;
-
-    FontLockHelper<std::mutex> lock(_mutex);
-
-    for (int32_t i = 0; i < TTF_GETWIDTH_CACHE_SIZE; i++)
-    {
-        entry = &_ttfGetWidthCache[index];
-
-        // Check if entry is a hit
-        if (entry->text == nullptr)
-            break;
-        if (entry->font == font && strcmp(entry->text, text) == 0)
-        {
-            _ttfGetWidthCacheHitCount++;
-            entry->lastUseTick = gCurrentDrawCount;
-            return entry->width;
-        }
-
-        // If entry hasn't been used for a while, replace it
-        if (entry->lastUseTick < gCurrentDrawCount - 64)
-        {
-            break;
-        }
-
-        // Check if next entry is a hit
-        if (++index >= TTF_GETWIDTH_CACHE_SIZE)
-            index = 0;
-    }
-
-    // Cache miss, replace entry with new width
-    entry = &_ttfGetWidthCache[index];
-    ttf_getwidth_cache_dispose(entry);
-
-    int32_t width, height;
-    ttf_get_size(font, text, &width, &height);
-
-    _ttfGetWidthCacheMissCount++;
-
-    _ttfGetWidthCacheCount++;
-    entry->width = width;
-    entry->font = font;
-    entry->text = _strdup(text);
-    entry->lastUseTick = gCurrentDrawCount;
-    return entry->width;
+    return _ttfGetWidthCache.GetStats();
 }
 
 TTFFontDescriptor* ttf_get_font_from_sprite_base(uint16_t spriteBase)
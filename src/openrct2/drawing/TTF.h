@@ -11,6 +11,8 @@
 
 #include "Font.h"
 
+#include <memory>
+
 bool ttf_initialise();
 void ttf_dispose();
 
@@ -24,10 +26,21 @@ struct TTFSurface
     int32_t pitch;
 };
 
+struct TTFCacheStats
+{
+    size_t HitCount;
+    size_t MissCount;
+    size_t EntryCount;
+    size_t Size;
+    size_t MaxSize;
+};
+
 TTFFontDescriptor* ttf_get_font_from_sprite_base(uint16_t spriteBase);
 void ttf_toggle_hinting();
-TTFSurface* ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text);
+std::shared_ptr<const TTFSurface> ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text);
 uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, const utf8* text);
+TTFCacheStats ttf_surface_cache_get_stats();
+TTFCacheStats ttf_getwidth_cache_get_stats();
 bool ttf_provides_glyph(const TTF_Font* font, codepoint_t codepoint);
 void ttf_free_surface(TTFSurface* surface);
 
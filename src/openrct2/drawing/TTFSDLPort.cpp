@@ -37,6 +37,7 @@ misrepresented as being the original software.
 #    include <stdio.h>
 #    include <stdlib.h>
 #    include <string.h>
+#    include <unordered_map>
 
 #    pragma clang diagnostic push
 #    pragma clang diagnostic ignored "-Wdocumentation"
@@ -82,6 +83,9 @@ in the result FT_Bitmap after the FT_Render_Glyph() call. */
 #    define CACHED_BITMAP 0x01
 #    define CACHED_PIXMAP 0x02
 
+/* Bytes of glyph bitmaps kept per font before the glyph cache is flushed */
+#    define TTF_GLYPH_CACHE_SIZE (2 * 1024 * 1024)
+
 /* Cached glyph information */
 struct c_glyph
 {
@@ -126,9 +130,10 @@ struct _TTF_Font
     int underline_offset;
     int underline_height;
 
-    /* Cache for style-transformed glyphs */
+    /* Cache for style-transformed glyphs, by character */
     c_glyph* current;
-    c_glyph cache[257]; /* 257 is a prime */
+    std::unordered_map<uint16_t, c_glyph>* cache;
+    size_t cache_size;
 
     /* We are responsible for closing the font stream */
     FILE* src;
@@ -395,6 +400,7 @@ static TTF_Font* TTF_OpenFontIndexRW(FILE* src, int freesrc, int ptsize, long in
         return NULL;
     }
     std::fill_n(reinterpret_cast<uint8_t*>(font), sizeof(*font), 0x00);
+    font->cache = new std::unordered_map<uint16_t, c_glyph>();
 
     font->src = src;
     font->freesrc = freesrc;
@@ -561,16 +567,27 @@ static void Flush_Glyph(c_glyph* glyph)
 
 static void Flush_Cache(TTF_Font* font)
 {
-    int i;
-    int size = sizeof(font->cache) / sizeof(font->cache[0]);
+    for (auto& entry : *font->cache)
+    {
+        Flush_Glyph(&entry.second);
+    }
+    font->cache->clear();
+    font->cache_size = 0;
+    font->current = NULL;
+}
 
-    for (i = 0; i < size; ++i)
+static size_t Glyph_Size(const c_glyph* glyph)
+{
+    size_t size = sizeof(*glyph);
+    if (glyph->bitmap.buffer)
     {
-        if (font->cache[i].cached)
-        {
-            Flush_Glyph(&font->cache[i]);
-        }
+        size += glyph->bitmap.pitch * glyph->bitmap.rows;
     }
+    if (glyph->pixmap.buffer)
+    {
+        size += glyph->pixmap.pitch * glyph->pixmap.rows;
+    }
+    return size;
 }
 
 static FT_Error Load_Glyph(TTF_Font* font, uint16_t ch, c_glyph* cached, int want)
@@ -966,17 +983,24 @@ static FT_Error Load_Glyph(TTF_Font* font, uint16_t ch, c_glyph* cached, int wan
 static FT_Error Find_Glyph(TTF_Font* font, uint16_t ch, int want)
 {
     int retval = 0;
-    int hsize = sizeof(font->cache) / sizeof(font->cache[0]);
-
-    int h = ch % hsize;
-    font->current = &font->cache[h];
 
-    if (font->current->cached != ch)
-        Flush_Glyph(font->current);
+    auto it = font->cache->find(ch);
+    if (it == font->cache->end())
+    {
+        if (font->cache_size > TTF_GLYPH_CACHE_SIZE)
+        {
+            Flush_Cache(font);
+        }
+        it = font->cache->emplace(ch, c_glyph{}).first;
+        font->cache_size += Glyph_Size(&it->second);
+    }
+    font->current = &it->second;
 
     if ((font->current->stored & want) != want)
     {
+        size_t size = Glyph_Size(font->current);
         retval = Load_Glyph(font, ch, font->current, want);
+        font->cache_size += Glyph_Size(font->current) - size;
     }
     return retval;
 }
@@ -986,6 +1010,7 @@ void TTF_CloseFont(TTF_Font* font)
     if (font)
     {
         Flush_Cache(font);
+        delete font->cache;
         if (font->face)
         {
             FT_Done_Face(font->face);
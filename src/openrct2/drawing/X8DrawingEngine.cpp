@@ -15,6 +15,7 @@
 #include "../config/Config.h"
 #include "../interface/Screenshot.h"
 #include "../interface/Viewport.h"
+#include "../interface/ViewportCache.h"
 #include "../interface/Window.h"
 #include "../ui/UiContext.h"
 #include "Drawing.h"
@@ -24,6 +25,7 @@
 #include "Rain.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 using namespace OpenRCT2;
@@ -208,6 +210,7 @@ void X8DrawingEngine::EndDraw()
 
 void X8DrawingEngine::PaintWindows()
 {
+    _frameStats = {};
     window_reset_visibilities();
 
     // Redraw dirty regions before updating the viewports, otherwise
@@ -288,6 +291,11 @@ DRAWING_ENGINE_FLAGS X8DrawingEngine::GetFlags()
     return DEF_DIRTY_OPTIMISATIONS;
 }
 
+const DrawingEngineFrameStats* X8DrawingEngine::GetFrameStats()
+{
+    return &_frameStats;
+}
+
 void X8DrawingEngine::InvalidateImage([[maybe_unused]] uint32_t image)
 {
     // Not applicable for this engine
@@ -377,12 +385,62 @@ void X8DrawingEngine::ConfigureDirtyGrid()
 
 void X8DrawingEngine::DrawAllDirtyBlocks()
 {
-    for (uint32_t x = 0; x < _dirtyGrid.BlockColumns; x++)
+    CoalesceDirtyBlocks();
+    if (_dirtyRects.empty())
+    {
+        return;
+    }
+
+    std::vector<ScreenRect> rects;
+    rects.reserve(_dirtyRects.size());
+    for (const auto& rect : _dirtyRects)
     {
-        for (uint32_t y = 0; y < _dirtyGrid.BlockRows; y++)
+        rects.push_back(GetDirtyRectBounds(rect));
+    }
+
+    // Paint the viewports under all rectangles in one go, drawing the windows is not thread safe so has to be done one
+    // rectangle at a time
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    viewport_cache_prepare(&_bitsDPI, rects);
+    const auto viewportTime = std::chrono::high_resolution_clock::now();
+
+    for (size_t i = 0; i < _dirtyRects.size(); i++)
+    {
+        const auto& rect = _dirtyRects[i];
+        const auto& bounds = rects[i];
+        if (bounds.GetRight() <= bounds.GetLeft() || bounds.GetBottom() <= bounds.GetTop())
         {
-            uint32_t yOffset = y * _dirtyGrid.BlockColumns;
-            if (_dirtyGrid.Blocks[yOffset + x] == 0)
+            continue;
+        }
+
+        OnDrawDirtyBlock(rect.X, rect.Y, rect.Columns, rect.Rows);
+        window_draw_all(&_bitsDPI, bounds.GetLeft(), bounds.GetTop(), bounds.GetRight(), bounds.GetBottom());
+        _frameStats.DrawnBlocks += rect.Columns * rect.Rows;
+    }
+    const auto endTime = std::chrono::high_resolution_clock::now();
+
+    _frameStats.DirtyRects += static_cast<uint32_t>(_dirtyRects.size());
+    _frameStats.ViewportTime += std::chrono::duration<double, std::milli>(viewportTime - startTime).count();
+    _frameStats.WindowTime += std::chrono::duration<double, std::milli>(endTime - viewportTime).count();
+}
+
+/**
+ * Turns the dirty blocks into a small set of rectangles and clears them from the grid. Each row is split into runs of
+ * dirty blocks which are extended downwards as far as the rows below are dirty across the whole run. Rectangles are then
+ * merged where their bounds would not redraw too many clean blocks, as every rectangle redraws all windows it touches.
+ */
+void X8DrawingEngine::CoalesceDirtyBlocks()
+{
+    constexpr size_t MaxMergeRects = 64;
+
+    _dirtyRects.clear();
+    uint8_t* screenDirtyBlocks = _dirtyGrid.Blocks;
+    for (uint32_t y = 0; y < _dirtyGrid.BlockRows; y++)
+    {
+        uint32_t yOffset = y * _dirtyGrid.BlockColumns;
+        for (uint32_t x = 0; x < _dirtyGrid.BlockColumns; x++)
+        {
+            if (screenDirtyBlocks[yOffset + x] == 0)
             {
                 continue;
             }
@@ -391,7 +449,7 @@ void X8DrawingEngine::DrawAllDirtyBlocks()
             uint32_t xx;
             for (xx = x; xx < _dirtyGrid.BlockColumns; xx++)
             {
-                if (_dirtyGrid.Blocks[yOffset + xx] == 0)
+                if (screenDirtyBlocks[yOffset + xx] == 0)
                 {
                     break;
                 }
@@ -400,9 +458,79 @@ void X8DrawingEngine::DrawAllDirtyBlocks()
             // Check rows
             uint32_t columns = xx - x;
             auto rows = GetNumDirtyRows(x, y, columns);
-            DrawDirtyBlocks(x, y, columns, rows);
+
+            // Unset dirty blocks
+            for (uint32_t top = y; top < y + rows; top++)
+            {
+                std::fill_n(screenDirtyBlocks + top * _dirtyGrid.BlockColumns + x, columns, 0);
+            }
+
+            _dirtyRects.push_back({ x, y, columns, rows });
+            _frameStats.DirtyBlocks += columns * rows;
+            x = xx - 1;
         }
     }
+
+    // Merging is quadratic in the number of rectangles, leave scattered blocks as they are
+    if (_dirtyRects.size() > MaxMergeRects)
+    {
+        return;
+    }
+
+    auto area = [](const DirtyRect& rect) { return rect.Columns * rect.Rows; };
+    auto contains = [](const DirtyRect& outer, const DirtyRect& inner) {
+        return inner.X >= outer.X && inner.Y >= outer.Y && inner.X + inner.Columns <= outer.X + outer.Columns
+            && inner.Y + inner.Rows <= outer.Y + outer.Rows;
+    };
+    auto overlaps = [](const DirtyRect& a, const DirtyRect& b) {
+        return a.X < b.X + b.Columns && b.X < a.X + a.Columns && a.Y < b.Y + b.Rows && b.Y < a.Y + a.Rows;
+    };
+
+    bool merged;
+    do
+    {
+        merged = false;
+        for (size_t i = 0; i < _dirtyRects.size() && !merged; i++)
+        {
+            for (size_t j = i + 1; j < _dirtyRects.size() && !merged; j++)
+            {
+                const auto& a = _dirtyRects[i];
+                const auto& b = _dirtyRects[j];
+                const uint32_t left = std::min(a.X, b.X);
+                const uint32_t top = std::min(a.Y, b.Y);
+                const DirtyRect bounds = { left, top, std::max(a.X + a.Columns, b.X + b.Columns) - left,
+                                           std::max(a.Y + a.Rows, b.Y + b.Rows) - top };
+
+                // The rectangles never overlap, so the dirty area of the bounds is the area of the rectangles within
+                uint32_t dirtyArea = 0;
+                bool valid = true;
+                for (const auto& other : _dirtyRects)
+                {
+                    if (contains(bounds, other))
+                    {
+                        dirtyArea += area(other);
+                    }
+                    else if (overlaps(bounds, other))
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+                if (!valid || (area(bounds) - dirtyArea) * 4 > dirtyArea)
+                {
+                    continue;
+                }
+
+                _dirtyRects.erase(
+                    std::remove_if(
+                        _dirtyRects.begin(), _dirtyRects.end(),
+                        [&](const DirtyRect& other) { return contains(bounds, other); }),
+                    _dirtyRects.end());
+                _dirtyRects.push_back(bounds);
+                merged = true;
+            }
+        }
+    } while (merged);
 }
 
 uint32_t X8DrawingEngine::GetNumDirtyRows(const uint32_t x, const uint32_t y, const uint32_t columns)
@@ -423,34 +551,14 @@ uint32_t X8DrawingEngine::GetNumDirtyRows(const uint32_t x, const uint32_t y, co
     return yy - y;
 }
 
-void X8DrawingEngine::DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows)
+ScreenRect X8DrawingEngine::GetDirtyRectBounds(const DirtyRect& rect) const
 {
-    uint32_t dirtyBlockColumns = _dirtyGrid.BlockColumns;
-    uint8_t* screenDirtyBlocks = _dirtyGrid.Blocks;
-
-    // Unset dirty blocks
-    for (uint32_t top = y; top < y + rows; top++)
-    {
-        uint32_t topOffset = top * dirtyBlockColumns;
-        for (uint32_t left = x; left < x + columns; left++)
-        {
-            screenDirtyBlocks[topOffset + left] = 0;
-        }
-    }
-
     // Determine region in pixels
-    uint32_t left = std::max<uint32_t>(0, x * _dirtyGrid.BlockWidth);
-    uint32_t top = std::max<uint32_t>(0, y * _dirtyGrid.BlockHeight);
-    uint32_t right = std::min(_width, left + (columns * _dirtyGrid.BlockWidth));
-    uint32_t bottom = std::min(_height, top + (rows * _dirtyGrid.BlockHeight));
-    if (right <= left || bottom <= top)
-    {
-        return;
-    }
-
-    // Draw region
-    OnDrawDirtyBlock(x, y, columns, rows);
-    window_draw_all(&_bitsDPI, left, top, right, bottom);
+    int32_t left = rect.X * _dirtyGrid.BlockWidth;
+    int32_t top = rect.Y * _dirtyGrid.BlockHeight;
+    int32_t right = std::min(_width, (rect.X + rect.Columns) * _dirtyGrid.BlockWidth);
+    int32_t bottom = std::min(_height, (rect.Y + rect.Rows) * _dirtyGrid.BlockHeight);
+    return { { left, top }, { right, bottom } };
 }
 
 #ifdef __WARN_SUGGEST_FINAL_METHODS__
@@ -13,6 +13,10 @@
 #include "IDrawingContext.h"
 #include "IDrawingEngine.h"
 
+#include <vector>
+
+struct ScreenRect;
+
 namespace OpenRCT2
 {
     namespace Ui
@@ -35,6 +39,17 @@ namespace OpenRCT2
             uint8_t* Blocks;
         };
 
+        /**
+         * A rectangle of blocks of the dirty grid.
+         */
+        struct DirtyRect
+        {
+            uint32_t X;
+            uint32_t Y;
+            uint32_t Columns;
+            uint32_t Rows;
+        };
+
         class X8RainDrawer final : public IRainDrawer
         {
         private:
@@ -73,6 +88,8 @@ namespace OpenRCT2
             uint8_t* _bits = nullptr;
 
             DirtyGrid _dirtyGrid = {};
+            std::vector<DirtyRect> _dirtyRects;
+            DrawingEngineFrameStats _frameStats = {};
 
             rct_drawpixelinfo _bitsDPI = {};
 
@@ -112,6 +129,7 @@ namespace OpenRCT2
             rct_drawpixelinfo* GetDrawingPixelInfo() override;
             DRAWING_ENGINE_FLAGS GetFlags() override;
             void InvalidateImage(uint32_t image) override;
+            const DrawingEngineFrameStats* GetFrameStats() override;
 
             rct_drawpixelinfo* GetDPI();
 
@@ -123,8 +141,9 @@ namespace OpenRCT2
             void ConfigureDirtyGrid();
             static void ResetWindowVisbilities();
             void DrawAllDirtyBlocks();
+            void CoalesceDirtyBlocks();
             uint32_t GetNumDirtyRows(const uint32_t x, const uint32_t y, const uint32_t columns);
-            void DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows);
+            ScreenRect GetDirtyRectBounds(const DirtyRect& rect) const;
         };
 #ifdef __WARN_SUGGEST_FINAL_TYPES__
 #    pragma GCC diagnostic pop
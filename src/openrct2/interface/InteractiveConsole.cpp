@@ -57,6 +57,7 @@
 #include <cstdlib>
 #include <deque>
 #include <exception>
+#include <iterator>
 #include <string>
 #include <thread>
 #include <vector>
@@ -1143,6 +1144,45 @@ static int32_t cc_object_count(InteractiveConsole& console, [[maybe_unused]] con
     return 0;
 }
 
+static int32_t cc_object_memory(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    const utf8* objectTypeNames[] = {
+        "Rides",         "Small scenery",    "Large scenery",  "Walls",          "Banners",
+        "Paths",         "Path Additions",   "Scenery groups", "Park entrances", "Water",
+        "Scenario text", "Terrain surfaces", "Terrain edges",  "Stations",       "Music",
+    };
+    static_assert(std::size(objectTypeNames) == OBJECT_TYPE_COUNT);
+
+    auto& objectManager = OpenRCT2::GetContext()->GetObjectManager();
+    size_t totalStrings = 0;
+    size_t totalImages = 0;
+    for (int32_t i = 0; i < OBJECT_TYPE_COUNT; i++)
+    {
+        size_t count = 0;
+        size_t strings = 0;
+        size_t images = 0;
+        for (int32_t entryIndex = 0; entryIndex < object_entry_group_counts[i]; entryIndex++)
+        {
+            const auto* object = objectManager.GetLoadedObject(i, entryIndex);
+            if (object != nullptr)
+            {
+                count++;
+                strings += object->GetStringTableMemoryUsage();
+                images += object->GetImageTable().GetMemoryUsage();
+            }
+        }
+        if (count != 0)
+        {
+            console.WriteFormatLine(
+                "%s: %zu objects, strings %zu KiB, images %zu KiB", objectTypeNames[i], count, strings / 1024, images / 1024);
+        }
+        totalStrings += strings;
+        totalImages += images;
+    }
+    console.WriteFormatLine("Total: strings %zu KiB, images %zu KiB", totalStrings / 1024, totalImages / 1024);
+    return 0;
+}
+
 static int32_t cc_open(InteractiveConsole& console, const arguments_t& argv)
 {
     if (!argv.empty())
@@ -1257,6 +1297,24 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     console.WriteFormatLine("Rides: %d/%d", rideCount, MAX_RIDES);
     console.WriteFormatLine("Staff: %d/%d", staffCount, STAFF_MAX_COUNT);
     console.WriteFormatLine("Images: %zu/%zu", ImageListGetUsedCount(), ImageListGetMaximum());
+    console.WriteFormatLine(
+        "Free image ranges: %zu, largest %zu", ImageListGetFreeRangeCount(), ImageListGetLargestFreeRange());
+    return 0;
+}
+
+static int32_t cc_font_cache(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+#ifndef NO_TTF
+    auto printStats = [&console](const char* name, const TTFCacheStats& stats) {
+        console.WriteFormatLine(
+            "%s: %zu entries, %zu/%zu KiB, %zu hits, %zu misses", name, stats.EntryCount, stats.Size / 1024,
+            stats.MaxSize / 1024, stats.HitCount, stats.MissCount);
+    };
+    printStats("Text surfaces", ttf_surface_cache_get_stats());
+    printStats("Text widths", ttf_getwidth_cache_get_stats());
+#else
+    console.WriteLine("TrueType fonts are not available in this build.");
+#endif
     return 0;
 }
 
@@ -1317,6 +1375,22 @@ static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe
     return 1;
 }
 
+static void console_write_park_load_progress(InteractiveConsole& console, const OpenRCT2::ParkLoadProgress& progress)
+{
+    switch (progress.Stage)
+    {
+        case OpenRCT2::ParkLoadStage::Reading:
+            console.WriteLine("Reading park");
+            break;
+        case OpenRCT2::ParkLoadStage::ReadingObjects:
+            console.WriteFormatLine("Reading objects, %zu/%zu read", progress.ObjectsRead, progress.ObjectCount);
+            break;
+        case OpenRCT2::ParkLoadStage::Ready:
+            console.WriteLine("Park has been read and will replace the current park on the next tick");
+            break;
+    }
+}
+
 static int32_t cc_load_park([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     if (argv.size() < 1)
@@ -1325,6 +1399,21 @@ static int32_t cc_load_park([[maybe_unused]] InteractiveConsole& console, [[mayb
         return 0;
     }
 
+    auto context = OpenRCT2::GetContext();
+    if (argv[0] == "status")
+    {
+        auto progress = context->GetParkLoadProgress();
+        if (progress.has_value())
+        {
+            console_write_park_load_progress(console, *progress);
+        }
+        else
+        {
+            console.WriteLine("No park is being loaded");
+        }
+        return 1;
+    }
+
     char savePath[MAX_PATH];
     if (String::IndexOf(argv[0].c_str(), '/') == SIZE_MAX && String::IndexOf(argv[0].c_str(), '\\') == SIZE_MAX)
     {
@@ -1340,13 +1429,31 @@ static int32_t cc_load_park([[maybe_unused]] InteractiveConsole& console, [[mayb
     {
         path_append_extension(savePath, ".sv6", sizeof(savePath));
     }
-    if (context_load_park_from_file(savePath))
+
+    // Load the park in the background so that the game, and a server's clients, keep running until it is ready
+    auto path = std::string(savePath);
+    auto started = context->LoadParkFromFileAsync(path, [&console, path](bool success) {
+        if (success)
+        {
+            console.WriteFormatLine("Park %s was loaded successfully", path.c_str());
+        }
+        else
+        {
+            console.WriteFormatLine("Loading Park %s failed", path.c_str());
+        }
+    });
+    if (started)
     {
-        console.WriteFormatLine("Park %s was loaded successfully", savePath);
+        console.WriteFormatLine("Loading park %s, use load_park status to see its progress", savePath);
     }
     else
     {
-        console.WriteFormatLine("Loading Park %s failed", savePath);
+        console.WriteLine("Another park is being loaded");
+        auto progress = context->GetParkLoadProgress();
+        if (progress.has_value())
+        {
+            console_write_park_load_progress(console, *progress);
+        }
     }
     return 1;
 }
@@ -1754,6 +1861,7 @@ static constexpr const console_command console_command_table[] = {
     { "dereference", cc_dereference, "Dereferences a nullptr, for testing purposes only", "dereference" },
     { "echo", cc_echo, "Echoes the text to the console.", "echo <text>" },
     { "exit", cc_close, "Closes the console.", "exit" },
+    { "font_cache", cc_font_cache, "Shows the size and hit rate of the TrueType text caches.", "font_cache" },
     { "get", cc_get, "Gets the value of the specified variable.", "get <variable>" },
     { "help", cc_help, "Lists commands or info about a command.", "help [command]" },
     { "hide", cc_hide, "Hides the console.", "hide" },
@@ -1761,8 +1869,9 @@ static constexpr const console_command console_command_table[] = {
                                     "Loading a scenery group will not load its associated objects.\n"
                                     "This is a safer method opposed to \"open object_selection\".",
                                     "load_object <objectfilenodat>" },
-    { "load_park", cc_load_park, "Load park from save directory or by absolute path", "load_park <filename>" },
+    { "load_park", cc_load_park, "Load park from save directory or by absolute path, or show the progress of the park being loaded", "load_park <filename>|status" },
     { "object_count", cc_object_count, "Shows the number of objects of each type in the scenario.", "object_count" },
+    { "object_memory", cc_object_memory, "Shows the memory used by the loaded object strings and images.", "object_memory" },
     { "open", cc_open, "Opens the window with the give name.", "open <window>." },
     { "quit", cc_close, "Closes the console.", "quit" },
     { "remove_park_fences", cc_remove_park_fences, "Removes all park fences from the surface", "remove_park_fences" },
@@ -16,8 +16,15 @@
 #include "../actions/SetCheatAction.hpp"
 #include "../audio/audio.h"
 #include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/FileScanner.h"
 #include "../core/Imaging.h"
+#include "../core/JobPool.hpp"
+#include "../core/Json.hpp"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
 #include "../drawing/Drawing.h"
+#include "../drawing/LightFX.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Localisation.h"
 #include "../platform/Platform2.h"
@@ -28,12 +35,16 @@
 #include "../world/Surface.h"
 #include "Viewport.h"
 
+#include <algorithm>
+#include <array>
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <exception>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 using namespace OpenRCT2;
@@ -377,9 +388,95 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
     viewport_render(&dpi, &viewport, 0, 0, viewport.width, viewport.height);
 }
 
+/**
+ * Renders the viewport a band of rows at a time and streams the rows into a PNG file, so that only two bands are held in
+ * memory however large the viewport is. While a band is painted the previous one is encoded on another thread.
+ */
+static void RenderViewportToFile(const rct_viewport& viewport, const std::string_view& path)
+{
+    constexpr int32_t BAND_HEIGHT = 256;
+
+    // Ensure sprites appear regardless of rotation
+    reset_all_sprite_quadrant_placements();
+
+    X8DrawingEngine drawingEngine(GetContext()->GetUiContext());
+
+    Image header;
+    header.Width = viewport.width;
+    header.Height = viewport.height;
+    header.Depth = 8;
+    header.Stride = viewport.width;
+    header.Palette = std::make_unique<GamePalette>(gPalette);
+    Imaging::PngFileWriter writer(path, header);
+
+    std::array<std::vector<uint8_t>, 2> bands;
+    std::exception_ptr writeException;
+    auto writeBand = [&writer, &writeException, &viewport](const std::vector<uint8_t>& band, int32_t numRows) {
+        try
+        {
+            writer.WriteRows(band.data(), numRows, viewport.width);
+        }
+        catch (const std::exception&)
+        {
+            writeException = std::current_exception();
+        }
+    };
+
+    // Declared last so that a pending write has finished before the writer and bands are released
+    std::unique_ptr<JobPool> writeJobs;
+    if (gConfigGeneral.multithreading)
+    {
+        writeJobs = std::make_unique<JobPool>(1);
+    }
+
+    for (int32_t top = 0, bandIndex = 0; top < viewport.height; top += BAND_HEIGHT, bandIndex++)
+    {
+        int32_t numRows = std::min(BAND_HEIGHT, viewport.height - top);
+        auto& band = bands[bandIndex % bands.size()];
+        band.assign(static_cast<size_t>(viewport.width) * numRows, PALETTE_INDEX_0);
+
+        rct_drawpixelinfo dpi{};
+        dpi.bits = band.data();
+        dpi.x = 0;
+        dpi.y = top;
+        dpi.width = viewport.width;
+        dpi.height = numRows;
+        dpi.DrawingEngine = &drawingEngine;
+        viewport_render(&dpi, &viewport, 0, top, viewport.width, top + numRows);
+
+        if (writeJobs != nullptr)
+        {
+            // Wait for the previous band, its buffer is painted next
+            writeJobs->Join();
+            if (writeException != nullptr)
+            {
+                std::rethrow_exception(writeException);
+            }
+            writeJobs->AddTask([&writeBand, &band, numRows]() { writeBand(band, numRows); });
+        }
+        else
+        {
+            writeBand(band, numRows);
+            if (writeException != nullptr)
+            {
+                std::rethrow_exception(writeException);
+            }
+        }
+    }
+
+    if (writeJobs != nullptr)
+    {
+        writeJobs->Join();
+    }
+    if (writeException != nullptr)
+    {
+        std::rethrow_exception(writeException);
+    }
+    writer.Finish();
+}
+
 void screenshot_giant()
 {
-    rct_drawpixelinfo dpi{};
     try
     {
         auto path = screenshot_get_next_path();
@@ -408,10 +505,7 @@ void screenshot_giant()
             viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
         }
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(path->c_str(), &dpi, gPalette);
+        RenderViewportToFile(viewport, *path);
 
         // Show user that screenshot saved successfully
         auto ft = Formatter::Common();
@@ -424,8 +518,6 @@ void screenshot_giant()
         log_error("%s", e.what());
         context_show_error(STR_SCREENSHOT_FAILED, STR_NONE);
     }
-
-    ReleaseDPI(dpi);
 }
 
 // TODO: Move this at some point into a more appropriate place.
@@ -457,8 +549,8 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
     {
         for (int32_t rotation = 0; rotation < MAX_ROTATIONS; rotation++)
         {
-            auto& viewport = viewports[zoom * MAX_ZOOM_LEVEL + rotation];
-            auto& dpi = dpis[zoom * MAX_ZOOM_LEVEL + rotation];
+            auto& viewport = viewports[zoom * MAX_ROTATIONS + rotation];
+            auto& dpi = dpis[zoom * MAX_ROTATIONS + rotation];
             viewport = GetGiantViewport(gMapSize, rotation, zoom);
             dpi = CreateDPI(viewport);
         }
@@ -480,11 +572,13 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
             // Render at every rotation.
             for (int32_t rotation = 0; rotation < MAX_ROTATIONS; rotation++)
             {
+                gCurrentRotation = rotation;
+
                 // N iterations.
                 for (uint32_t i = 0; i < iterationCount; i++)
                 {
-                    auto& dpi = dpis[zoom * MAX_ZOOM_LEVEL + rotation];
-                    auto& viewport = viewports[zoom * MAX_ZOOM_LEVEL + rotation];
+                    auto& dpi = dpis[zoom * MAX_ROTATIONS + rotation];
+                    auto& viewport = viewports[zoom * MAX_ROTATIONS + rotation];
                     double elapsed = MeasureFunctionTime([&viewport, &dpi]() { RenderViewport(nullptr, viewport, dpi); });
                     totalTime += elapsed;
                     zoomLevelTime += elapsed;
@@ -516,6 +610,429 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
         ReleaseDPI(dpi);
 }
 
+static void benchgfx_blend_ops(const char* inputPath, std::unique_ptr<IContext>& context, int32_t iterationCount)
+{
+    if (!context->LoadParkFromFile(inputPath))
+    {
+        return;
+    }
+
+    gIntroState = IntroState::None;
+    gScreenFlags = SCREEN_FLAGS_PLAYING;
+
+    // Record the images drawn for every rotation and zoom, then replay them per blend operation. Images are recorded
+    // into a shared list while painting, so paint on a single thread.
+    constexpr int32_t MAX_ROTATIONS = 4;
+    const auto backupRotation = gCurrentRotation;
+    const auto multithreading = gConfigGeneral.multithreading;
+    gConfigGeneral.multithreading = false;
+    rle_benchmark_start_recording();
+    const int32_t maxZoom = static_cast<int8_t>(ZoomLevel::max());
+    for (int32_t zoom = static_cast<int8_t>(ZoomLevel::min()); zoom <= maxZoom; zoom++)
+    {
+        for (int32_t rotation = 0; rotation < MAX_ROTATIONS; rotation++)
+        {
+            gCurrentRotation = rotation;
+            reset_all_sprite_quadrant_placements();
+
+            auto viewport = GetGiantViewport(gMapSize, rotation, zoom);
+            auto dpi = CreateDPI(viewport);
+            RenderViewport(nullptr, viewport, dpi);
+            ReleaseDPI(dpi);
+        }
+    }
+    gConfigGeneral.multithreading = multithreading;
+    gCurrentRotation = backupRotation;
+
+    std::printf("%-8s %-12s %10s %12s %10s\n", "Kernels", "Blend op", "Sprites", "Time", "Mpx/s");
+    for (const auto& result : rle_benchmark_run(iterationCount))
+    {
+        const double megaPixels = static_cast<double>(result.Pixels) / 1000000.0;
+        std::printf(
+            "%-8s %-12s %10zu %11.05fs %10.1f\n", result.Kernels, result.BlendOp, result.Sprites, result.Seconds,
+            result.Seconds > 0.0 ? megaPixels / result.Seconds : 0.0);
+    }
+}
+
+int32_t cmdline_for_gfxbench_blend(const char** argv, int32_t argc)
+{
+    if (argc != 1 && argc != 2)
+    {
+        printf("Usage: openrct2 benchgfx blend <file> [<iteration_count>]\n");
+        return -1;
+    }
+
+    core_init();
+    int32_t iterationCount = 5;
+    if (argc == 2)
+    {
+        iterationCount = atoi(argv[1]);
+        if (iterationCount <= 0)
+        {
+            printf("The iteration count must be a positive number.\n");
+            return -1;
+        }
+    }
+
+    const char* inputPath = argv[0];
+
+    gOpenRCT2Headless = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (context->Initialise())
+    {
+        drawing_engine_init();
+
+        benchgfx_blend_ops(inputPath, context, iterationCount);
+
+        drawing_engine_dispose();
+    }
+
+    return 1;
+}
+
+static void benchgfx_lightfx(const char* inputPath, std::unique_ptr<IContext>& context, int32_t iterationCount)
+{
+#ifdef __ENABLE_LIGHTFX__
+    if (!context->LoadParkFromFile(inputPath))
+    {
+        return;
+    }
+
+    gIntroState = IntroState::None;
+    gScreenFlags = SCREEN_FLAGS_PLAYING;
+
+    // A 1080p view of the middle of the park
+    constexpr int32_t VIEW_WIDTH = 1920;
+    constexpr int32_t VIEW_HEIGHT = 1080;
+    auto giantViewport = GetGiantViewport(gMapSize, get_current_rotation(), 0);
+    rct_viewport viewport{};
+    viewport.viewPos = { giantViewport.viewPos.x + (giantViewport.view_width - VIEW_WIDTH) / 2,
+                         giantViewport.viewPos.y + (giantViewport.view_height - VIEW_HEIGHT) / 2 };
+    viewport.width = VIEW_WIDTH;
+    viewport.height = VIEW_HEIGHT;
+    viewport.view_width = VIEW_WIDTH;
+    viewport.view_height = VIEW_HEIGHT;
+    viewport.zoom = 0;
+    auto dpi = CreateDPI(viewport);
+
+    // Lights are added to a shared list while painting, so collect them on a single thread
+    const auto enableLightFx = gConfigGeneral.enable_light_fx;
+    const auto multithreading = gConfigGeneral.multithreading;
+    gConfigGeneral.enable_light_fx = true;
+    gConfigGeneral.multithreading = false;
+    lightfx_benchmark_start(&dpi, viewport);
+    RenderViewport(nullptr, viewport, dpi);
+    gConfigGeneral.multithreading = multithreading;
+
+    auto results = lightfx_benchmark_run(iterationCount);
+    gConfigGeneral.enable_light_fx = enableLightFx;
+    ReleaseDPI(dpi);
+
+    std::printf("%-8s %-8s %8s %12s %10s\n", "Kernels", "Threads", "Lights", "Time", "ms/frame");
+    for (const auto& result : results)
+    {
+        std::printf(
+            "%-8s %-8s %8u %11.05fs %10.2f\n", result.Kernels, result.Multithreaded ? "bands" : "single", result.Lights,
+            result.Seconds, iterationCount > 0 ? result.Seconds * 1000.0 / iterationCount : 0.0);
+    }
+#else
+    std::printf("This build does not include LightFX.\n");
+#endif
+}
+
+int32_t cmdline_for_gfxbench_lightfx(const char** argv, int32_t argc)
+{
+    if (argc != 1 && argc != 2)
+    {
+        printf("Usage: openrct2 benchgfx lightfx <file> [<iteration_count>]\n");
+        return -1;
+    }
+
+    core_init();
+    int32_t iterationCount = 5;
+    if (argc == 2)
+    {
+        iterationCount = atoi(argv[1]);
+    }
+
+    const char* inputPath = argv[0];
+
+    gOpenRCT2Headless = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (context->Initialise())
+    {
+        drawing_engine_init();
+
+        benchgfx_lightfx(inputPath, context, iterationCount);
+
+        drawing_engine_dispose();
+    }
+
+    return 1;
+}
+
+struct BenchGfxSuiteResult
+{
+    std::string Park;
+    int32_t Zoom{};
+    int32_t Rotation{};
+    int32_t Width{};
+    int32_t Height{};
+    double Render{};
+    ViewportPaintProfile Profile;
+    std::optional<size_t> MismatchedPixels;
+};
+
+static std::vector<std::string> benchgfx_suite_get_parks(const char** argv, int32_t argc)
+{
+    std::vector<std::string> parks;
+    for (int32_t i = 0; i < argc; i++)
+    {
+        if (Path::DirectoryExists(argv[i]))
+        {
+            auto pattern = Path::Combine(argv[i], "*.sv4;*.sv6;*.sc4;*.sc6;*.sea");
+            auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(pattern, false));
+            std::vector<std::string> directoryParks;
+            while (scanner->Next())
+            {
+                directoryParks.emplace_back(scanner->GetPath());
+            }
+            std::sort(directoryParks.begin(), directoryParks.end());
+            parks.insert(parks.end(), directoryParks.begin(), directoryParks.end());
+        }
+        else
+        {
+            parks.emplace_back(argv[i]);
+        }
+    }
+    return parks;
+}
+
+/**
+ * Compares the image drawn to dpi with a PNG written by --save-images. Returns the number of pixels with a different
+ * palette index, or nothing if the reference image does not exist or has a different size.
+ */
+static std::optional<size_t> benchgfx_suite_compare(const std::string& path, const rct_drawpixelinfo& dpi)
+{
+    if (!File::Exists(path))
+    {
+        std::fprintf(stderr, "Reference image not found: %s\n", path.c_str());
+        return std::nullopt;
+    }
+
+    try
+    {
+        auto image = Imaging::ReadFromFile(path, IMAGE_FORMAT::PNG);
+        if (image.Depth != 8 || image.Width != static_cast<uint32_t>(dpi.width)
+            || image.Height != static_cast<uint32_t>(dpi.height))
+        {
+            std::fprintf(stderr, "Reference image has a different size or format: %s\n", path.c_str());
+            return std::nullopt;
+        }
+
+        size_t mismatched = 0;
+        for (int32_t y = 0; y < dpi.height; y++)
+        {
+            const uint8_t* expected = image.Pixels.data() + static_cast<size_t>(y) * image.Stride;
+            const uint8_t* actual = dpi.bits + static_cast<size_t>(y) * (dpi.width + dpi.pitch);
+            for (int32_t x = 0; x < dpi.width; x++)
+            {
+                mismatched += expected[x] != actual[x];
+            }
+        }
+        return mismatched;
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Unable to read reference image %s: %s\n", path.c_str(), e.what());
+        return std::nullopt;
+    }
+}
+
+static void benchgfx_suite_park(
+    const std::string& inputPath, std::unique_ptr<IContext>& context, const BenchGfxSuiteOptions& options,
+    std::vector<BenchGfxSuiteResult>& results)
+{
+    if (!context->LoadParkFromFile(inputPath))
+    {
+        std::fprintf(stderr, "Unable to load park: %s\n", inputPath.c_str());
+        return;
+    }
+
+    gIntroState = IntroState::None;
+    gScreenFlags = SCREEN_FLAGS_PLAYING;
+
+    const auto parkName = Path::GetFileNameWithoutExtension(inputPath);
+    const auto iterationCount = std::max(options.iterations, 1);
+    const auto backupRotation = gCurrentRotation;
+    X8DrawingEngine drawingEngine(GetContext()->GetUiContext());
+
+    constexpr int32_t MAX_ROTATIONS = 4;
+    const int32_t maxZoom = static_cast<int8_t>(ZoomLevel::max());
+    for (int32_t zoom = static_cast<int8_t>(ZoomLevel::min()); zoom <= maxZoom; zoom++)
+    {
+        for (int32_t rotation = 0; rotation < MAX_ROTATIONS; rotation++)
+        {
+            gCurrentRotation = rotation;
+            reset_all_sprite_quadrant_placements();
+
+            auto viewport = GetGiantViewport(gMapSize, rotation, zoom);
+            auto dpi = CreateDPI(viewport);
+            dpi.DrawingEngine = &drawingEngine;
+
+            BenchGfxSuiteResult result;
+            result.Park = parkName;
+            result.Zoom = zoom;
+            result.Rotation = rotation;
+            result.Width = viewport.width;
+            result.Height = viewport.height;
+
+            // The stages are timed on a single thread so that they add up, the whole render uses the paint job pool
+            // like the game does and its output is the one saved and compared.
+            for (int32_t i = 0; i < iterationCount; i++)
+            {
+                viewport_paint_profiled(
+                    &viewport, &dpi, viewport.viewPos.x, viewport.viewPos.y, viewport.viewPos.x + viewport.view_width,
+                    viewport.viewPos.y + viewport.view_height, result.Profile);
+                result.Render += MeasureFunctionTime([&viewport, &dpi]() { RenderViewport(nullptr, viewport, dpi); });
+            }
+            result.Render /= iterationCount;
+            result.Profile.Generate /= iterationCount;
+            result.Profile.Arrange /= iterationCount;
+            result.Profile.Draw /= iterationCount;
+            result.Profile.Columns /= iterationCount;
+
+            const auto imageName = String::StdFormat("%s_z%d_r%d.png", parkName.c_str(), zoom, rotation);
+            if (options.save_images != nullptr)
+            {
+                WriteDpiToFile(Path::Combine(options.save_images, imageName), &dpi, gPalette);
+            }
+            if (options.compare != nullptr)
+            {
+                result.MismatchedPixels = benchgfx_suite_compare(Path::Combine(options.compare, imageName), dpi);
+            }
+
+            ReleaseDPI(dpi);
+            results.push_back(std::move(result));
+        }
+    }
+
+    gCurrentRotation = backupRotation;
+}
+
+static void benchgfx_suite_write_json(
+    const utf8* path, const std::vector<BenchGfxSuiteResult>& results, const BenchGfxSuiteOptions& options)
+{
+    json_t* jsonResults = json_array();
+    for (const auto& result : results)
+    {
+        json_t* jsonResult = json_object();
+        json_object_set_new(jsonResult, "park", json_string(result.Park.c_str()));
+        json_object_set_new(jsonResult, "zoom", json_integer(result.Zoom));
+        json_object_set_new(jsonResult, "rotation", json_integer(result.Rotation));
+        json_object_set_new(jsonResult, "width", json_integer(result.Width));
+        json_object_set_new(jsonResult, "height", json_integer(result.Height));
+        json_object_set_new(jsonResult, "columns", json_integer(result.Profile.Columns));
+        json_object_set_new(jsonResult, "render", json_real(result.Render));
+        json_object_set_new(jsonResult, "generate", json_real(result.Profile.Generate));
+        json_object_set_new(jsonResult, "arrange", json_real(result.Profile.Arrange));
+        json_object_set_new(jsonResult, "draw", json_real(result.Profile.Draw));
+        if (result.MismatchedPixels)
+        {
+            json_object_set_new(jsonResult, "mismatchedPixels", json_integer(*result.MismatchedPixels));
+        }
+        json_array_append_new(jsonResults, jsonResult);
+    }
+
+    json_t* jsonRoot = json_object();
+    json_object_set_new(jsonRoot, "engine", json_string("software"));
+    json_object_set_new(jsonRoot, "multithreading", json_boolean(gConfigGeneral.multithreading));
+    json_object_set_new(jsonRoot, "iterations", json_integer(std::max(options.iterations, 1)));
+    json_object_set_new(jsonRoot, "results", jsonResults);
+
+    try
+    {
+        Json::WriteToFile(path, jsonRoot, JSON_INDENT(4) | JSON_PRESERVE_ORDER);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Unable to write %s: %s\n", path, e.what());
+    }
+    json_decref(jsonRoot);
+}
+
+int32_t cmdline_for_gfxbench_suite(const char** argv, int32_t argc, const BenchGfxSuiteOptions* options)
+{
+    if (argc < 1)
+    {
+        printf("Usage: openrct2 benchgfx suite <file or directory>...\n");
+        return -1;
+    }
+
+    core_init();
+
+    const auto parks = benchgfx_suite_get_parks(argv, argc);
+    if (parks.empty())
+    {
+        std::fprintf(stderr, "No parks found.\n");
+        return -1;
+    }
+
+    if (options->save_images != nullptr)
+    {
+        Path::CreateDirectory(options->save_images);
+    }
+
+    gOpenRCT2Headless = true;
+
+    std::vector<BenchGfxSuiteResult> results;
+    std::unique_ptr<IContext> context(CreateContext());
+    if (context->Initialise())
+    {
+        drawing_engine_init();
+
+        for (const auto& park : parks)
+        {
+            benchgfx_suite_park(park, context, *options, results);
+        }
+
+        drawing_engine_dispose();
+    }
+
+    std::printf(
+        "%-32s %4s %3s %11s %11s %11s %11s %11s %10s\n", "Park", "Zoom", "Rot", "Size", "Render", "Generate", "Arrange",
+        "Draw", "Mismatched");
+    bool mismatched = false;
+    for (const auto& result : results)
+    {
+        const auto size = String::StdFormat("%dx%d", result.Width, result.Height);
+        std::string mismatchedPixels = "-";
+        if (result.MismatchedPixels)
+        {
+            mismatchedPixels = std::to_string(*result.MismatchedPixels);
+        }
+        mismatched |= options->compare != nullptr && result.MismatchedPixels.value_or(1) != 0;
+        std::printf(
+            "%-32s %4d %3d %11s %10.03fms %10.03fms %10.03fms %10.03fms %10s\n", result.Park.c_str(), result.Zoom,
+            result.Rotation, size.c_str(), result.Render * 1000.0, result.Profile.Generate * 1000.0,
+            result.Profile.Arrange * 1000.0, result.Profile.Draw * 1000.0, mismatchedPixels.c_str());
+    }
+
+    if (options->output != nullptr)
+    {
+        benchgfx_suite_write_json(options->output, results, *options);
+    }
+
+    if (mismatched)
+    {
+        std::printf("The rendered images differ from the reference images.\n");
+        return -1;
+    }
+    return 1;
+}
+
 int32_t cmdline_for_gfxbench(const char** argv, int32_t argc)
 {
     if (argc != 1 && argc != 2)
@@ -624,7 +1141,6 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     }
 
     int32_t exitCode = 1;
-    rct_drawpixelinfo dpi;
     try
     {
         core_init();
@@ -726,17 +1242,13 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
 
         ApplyOptions(options, viewport);
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
+        RenderViewportToFile(viewport, outputPath);
     }
     catch (const std::exception& e)
     {
         std::printf("%s\n", e.what());
         exitCode = -1;
     }
-    ReleaseDPI(dpi);
 
     drawing_engine_dispose();
 
@@ -820,10 +1332,7 @@ void CaptureImage(const CaptureOptions& options)
     gCurrentRotation = options.Rotation;
 
     auto outputPath = ResolveFilenameForCapture(options.Filename);
-    auto dpi = CreateDPI(viewport);
-    RenderViewport(nullptr, viewport, dpi);
-    WriteDpiToFile(outputPath, &dpi, gPalette);
-    ReleaseDPI(dpi);
+    RenderViewportToFile(viewport, outputPath);
 
     gCurrentRotation = backupRotation;
 }
@@ -35,6 +35,14 @@ struct ScreenshotOptions
     bool transparent = false;
 };
 
+struct BenchGfxSuiteOptions
+{
+    int32_t iterations = 1;
+    utf8* output = nullptr;
+    utf8* save_images = nullptr;
+    utf8* compare = nullptr;
+};
+
 struct CaptureView
 {
     int32_t Width{};
@@ -58,5 +66,8 @@ std::string screenshot_dump_png_32bpp(int32_t width, int32_t height, const void*
 void screenshot_giant();
 int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOptions* options);
 int32_t cmdline_for_gfxbench(const char** argv, int32_t argc);
+int32_t cmdline_for_gfxbench_blend(const char** argv, int32_t argc);
+int32_t cmdline_for_gfxbench_lightfx(const char** argv, int32_t argc);
+int32_t cmdline_for_gfxbench_suite(const char** argv, int32_t argc, const BenchGfxSuiteOptions* options);
 
 void CaptureImage(const CaptureOptions& options);
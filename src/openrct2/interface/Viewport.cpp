@@ -27,10 +27,12 @@
 #include "../world/Map.h"
 #include "../world/Sprite.h"
 #include "Colour.h"
+#include "ViewportCache.h"
 #include "Window.h"
 #include "Window_internal.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 using namespace OpenRCT2;
@@ -167,6 +169,7 @@ void viewport_create(
     viewport->view_height = height << zoom;
     viewport->zoom = zoom;
     viewport->flags = 0;
+    viewport_cache_invalidate_all(viewport);
 
     if (gConfigGeneral.always_show_gridlines)
         viewport->flags |= VIEWPORT_FLAG_GRIDLINES;
@@ -895,19 +898,27 @@ static void viewport_paint_column(paint_session* session)
     paint_session_free(session);
 }
 
+static JobPool* viewport_get_paint_jobs()
+{
+    bool useMultithreading = gConfigGeneral.multithreading;
+    if (useMultithreading && _paintJobs == nullptr)
+    {
+        _paintJobs = std::make_unique<JobPool>();
+    }
+    else if (useMultithreading == false && _paintJobs != nullptr)
+    {
+        _paintJobs.reset();
+    }
+    return _paintJobs.get();
+}
+
 /**
- *
- *  rct2: 0x00685CBF
- *  eax: left
- *  ebx: top
- *  edx: right
- *  esi: viewport
- *  edi: dpi
- *  ebp: bottom
+ * Splits the given area into 32 pixel columns and appends a paint session for each of them to columns. The sessions
+ * still have to be filled.
  */
-void viewport_paint(
+static void viewport_split_columns(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
-    std::vector<paint_session>* recorded_sessions)
+    std::vector<paint_session*>& columns, std::vector<paint_session>* recorded_sessions)
 {
     uint32_t viewFlags = viewport->flags;
     uint16_t width = right - left;
@@ -943,20 +954,7 @@ void viewport_paint(
     const int16_t rightBorder = dpi1.x + dpi1.width;
     const int16_t alignedX = floor2(dpi1.x, 32);
 
-    std::vector<paint_session*> columns;
-
-    bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
-    {
-        _paintJobs = std::make_unique<JobPool>();
-    }
-    else if (useMultithreading == false && _paintJobs != nullptr)
-    {
-        _paintJobs.reset();
-    }
-
-    // Create space to record sessions and keep track which index is being drawn
-    size_t index = 0;
+    // Create space to record sessions
     if (recorded_sessions != nullptr)
     {
         const uint16_t columnSize = rightBorder - alignedX;
@@ -964,8 +962,8 @@ void viewport_paint(
         recorded_sessions->resize(columnCount);
     }
 
-    // Splits the area into 32 pixel columns and renders them
-    for (x = alignedX; x < rightBorder; x += 32, index++)
+    // Splits the area into 32 pixel columns
+    for (x = alignedX; x < rightBorder; x += 32)
     {
         paint_session* session = paint_session_alloc(&dpi1, viewFlags);
         columns.push_back(session);
@@ -988,10 +986,22 @@ void viewport_paint(
             dpi2.pitch += rightPitch / dpi2.zoom_level;
         }
         dpi2.width = paintRight - dpi2.x;
+    }
+}
 
-        if (useMultithreading)
+/**
+ * Fills the paint sessions of the given columns, on the paint job pool if there is one, and then draws them.
+ */
+static void viewport_fill_and_paint_columns(
+    const std::vector<paint_session*>& columns, std::vector<paint_session>* recorded_sessions)
+{
+    auto jobs = viewport_get_paint_jobs();
+    for (size_t index = 0; index < columns.size(); index++)
+    {
+        auto session = columns[index];
+        if (jobs != nullptr)
         {
-            _paintJobs->AddTask(
+            jobs->AddTask(
                 [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
         }
         else
@@ -1000,15 +1010,93 @@ void viewport_paint(
         }
     }
 
-    if (useMultithreading)
+    if (jobs != nullptr)
+    {
+        jobs->Join();
+    }
+
+    for (auto&& column : columns)
+    {
+        viewport_paint_column(column);
+    }
+}
+
+/**
+ *
+ *  rct2: 0x00685CBF
+ *  eax: left
+ *  ebx: top
+ *  edx: right
+ *  esi: viewport
+ *  edi: dpi
+ *  ebp: bottom
+ */
+void viewport_paint(
+    const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
+    std::vector<paint_session>* recorded_sessions)
+{
+    std::vector<paint_session*> columns;
+    viewport_split_columns(viewport, dpi, left, top, right, bottom, columns, recorded_sessions);
+    viewport_fill_and_paint_columns(columns, recorded_sessions);
+}
+
+void viewport_paint(const rct_viewport* viewport, rct_drawpixelinfo* dpi, const std::vector<ScreenRect>& areas)
+{
+    // The columns of all areas are filled together so that small areas still keep every worker busy
+    std::vector<paint_session*> columns;
+    for (const auto& area : areas)
     {
-        _paintJobs->Join();
+        viewport_split_columns(
+            viewport, dpi, area.GetLeft(), area.GetTop(), area.GetRight(), area.GetBottom(), columns, nullptr);
     }
+    viewport_fill_and_paint_columns(columns, nullptr);
+}
+
+void viewport_generate(const rct_viewport* viewport, rct_drawpixelinfo* dpi, const std::vector<ScreenRect>& areas)
+{
+    std::vector<paint_session*> columns;
+    for (const auto& area : areas)
+    {
+        viewport_split_columns(
+            viewport, dpi, area.GetLeft(), area.GetTop(), area.GetRight(), area.GetBottom(), columns, nullptr);
+    }
+
+    // Generated on the calling thread, as the side effects are not safe to run on several threads at once
+    for (auto&& column : columns)
+    {
+        paint_session_generate(column);
+        paint_session_free(column);
+    }
+}
+
+void viewport_paint_profiled(
+    const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
+    ViewportPaintProfile& profile)
+{
+    using Clock = std::chrono::high_resolution_clock;
+    auto elapsed = [](Clock::time_point since) { return std::chrono::duration<double>(Clock::now() - since).count(); };
+
+    std::vector<paint_session*> columns;
+    viewport_split_columns(viewport, dpi, left, top, right, bottom, columns, nullptr);
+    profile.Columns += columns.size();
 
+    for (auto&& column : columns)
+    {
+        auto startTime = Clock::now();
+        paint_session_generate(column);
+        profile.Generate += elapsed(startTime);
+
+        startTime = Clock::now();
+        paint_session_arrange(column);
+        profile.Arrange += elapsed(startTime);
+    }
+
+    const auto startTime = Clock::now();
     for (auto&& column : columns)
     {
         viewport_paint_column(column);
     }
+    profile.Draw += elapsed(startTime);
 }
 
 static void viewport_paint_weather_gloom(rct_drawpixelinfo* dpi)
@@ -1690,6 +1778,9 @@ void get_map_coordinates_from_pos_window(
  */
 void viewport_invalidate(rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom)
 {
+    // The render cache has to see every invalidation, including those of viewports that are currently covered
+    viewport_cache_invalidate(viewport, left, top, right, bottom);
+
     // if unknown viewport visibility, use the containing window to discover the status
     if (viewport->visibility == VC_UNKNOWN)
     {
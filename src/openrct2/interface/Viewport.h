@@ -145,6 +145,36 @@ void viewport_paint(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
     std::vector<paint_session>* sessions = nullptr);
 
+/**
+ * Paints several areas of a viewport, given in view coordinates. The areas must not overlap.
+ */
+void viewport_paint(const rct_viewport* viewport, rct_drawpixelinfo* dpi, const std::vector<ScreenRect>& areas);
+
+/**
+ * Generates the paint structs of several areas of a viewport, given in view coordinates, without drawing them. This
+ * only has the side effects of painting, such as adding the lights of LightFX.
+ */
+void viewport_generate(const rct_viewport* viewport, rct_drawpixelinfo* dpi, const std::vector<ScreenRect>& areas);
+
+/**
+ * Seconds spent in each stage of painting a viewport.
+ */
+struct ViewportPaintProfile
+{
+    double Generate{};
+    double Arrange{};
+    double Draw{};
+    size_t Columns{};
+};
+
+/**
+ * Paints an area of a viewport like viewport_paint, but on the calling thread, adding the time spent generating,
+ * arranging and drawing the paint structs to profile.
+ */
+void viewport_paint_profiled(
+    const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
+    ViewportPaintProfile& profile);
+
 CoordsXYZ viewport_adjust_for_map_height(const ScreenCoordsXY& startCoords);
 
 ScreenCoordsXY screen_coord_to_viewport_coord(rct_viewport* viewport, const ScreenCoordsXY& screenCoords);
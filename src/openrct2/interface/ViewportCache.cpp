@@ -0,0 +1,402 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ViewportCache.h"
+
+#include "../drawing/Drawing.h"
+#include "../drawing/IDrawingEngine.h"
+#include "../drawing/LightFX.h"
+#include "Viewport.h"
+#include "Window_internal.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+bool ViewportCache::Matches(const rct_viewport* viewport) const
+{
+    return Width == viewport->width && Height == viewport->height && Zoom == viewport->zoom && Flags == viewport->flags
+        && Rotation == get_current_rotation();
+}
+
+void ViewportCache::Reset(const rct_viewport* viewport, const ScreenCoordsXY& origin)
+{
+    Width = viewport->width;
+    Height = viewport->height;
+    BlocksX = (Width + VIEWPORT_CACHE_BLOCK_SIZE - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT;
+    BlocksY = (Height + VIEWPORT_CACHE_BLOCK_SIZE - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT;
+    Origin = origin;
+    Zoom = viewport->zoom;
+    Flags = viewport->flags;
+    Rotation = get_current_rotation();
+
+    Bits.resize(static_cast<size_t>(Width) * Height);
+    ValidBlocks.assign(static_cast<size_t>(BlocksX) * BlocksY, false);
+}
+
+void ViewportCache::InvalidateAll()
+{
+    std::fill(ValidBlocks.begin(), ValidBlocks.end(), false);
+}
+
+void ViewportCache::Invalidate(int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    if (ValidBlocks.empty())
+        return;
+
+    // Round outwards, anything touching a pixel has to repaint it
+    const int32_t zoomAmount = 1 * Zoom;
+    left = left - Origin.x;
+    top = top - Origin.y;
+    right = right - Origin.x + zoomAmount - 1;
+    bottom = bottom - Origin.y + zoomAmount - 1;
+    InvalidatePixels(left / Zoom, top / Zoom, right / Zoom, bottom / Zoom);
+}
+
+void ViewportCache::InvalidatePixels(int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, Width);
+    bottom = std::min(bottom, Height);
+    if (left >= right || top >= bottom)
+        return;
+
+    for (int32_t by = top >> VIEWPORT_CACHE_BLOCK_SHIFT; by <= (bottom - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT; by++)
+    {
+        for (int32_t bx = left >> VIEWPORT_CACHE_BLOCK_SHIFT; bx <= (right - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT; bx++)
+        {
+            ValidBlocks[by * BlocksX + bx] = false;
+        }
+    }
+}
+
+void ViewportCache::Scroll(const ScreenCoordsXY& origin)
+{
+    const int32_t dx = (origin.x - Origin.x) / Zoom;
+    const int32_t dy = (origin.y - Origin.y) / Zoom;
+    Origin = origin;
+    if (std::abs(dx) >= Width || std::abs(dy) >= Height)
+    {
+        InvalidateAll();
+        return;
+    }
+
+    // Pixel (x, y) takes the value of the old pixel (x + dx, y + dy)
+    const int32_t srcX = std::max(dx, 0);
+    const int32_t dstX = std::max(-dx, 0);
+    const size_t rowLength = Width - std::abs(dx);
+    const int32_t rowStart = std::max(-dy, 0);
+    const int32_t rowEnd = Height - std::max(dy, 0);
+    if (dy > 0)
+    {
+        for (int32_t y = rowStart; y < rowEnd; y++)
+        {
+            std::memmove(&Bits[y * Width + dstX], &Bits[(y + dy) * Width + srcX], rowLength);
+        }
+    }
+    else
+    {
+        for (int32_t y = rowEnd - 1; y >= rowStart; y--)
+        {
+            std::memmove(&Bits[y * Width + dstX], &Bits[(y + dy) * Width + srcX], rowLength);
+        }
+    }
+
+    std::vector<bool> validBlocks(ValidBlocks.size(), false);
+    for (int32_t by = 0; by < BlocksY; by++)
+    {
+        const int32_t top = (by << VIEWPORT_CACHE_BLOCK_SHIFT) + dy;
+        const int32_t bottom = std::min((by + 1) << VIEWPORT_CACHE_BLOCK_SHIFT, Height) + dy;
+        if (top < 0 || bottom > Height)
+            continue;
+
+        for (int32_t bx = 0; bx < BlocksX; bx++)
+        {
+            const int32_t left = (bx << VIEWPORT_CACHE_BLOCK_SHIFT) + dx;
+            const int32_t right = std::min((bx + 1) << VIEWPORT_CACHE_BLOCK_SHIFT, Width) + dx;
+            if (left < 0 || right > Width)
+                continue;
+
+            const int32_t oy1 = (bottom - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT;
+            const int32_t ox1 = (right - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT;
+            bool valid = true;
+            for (int32_t oy = top >> VIEWPORT_CACHE_BLOCK_SHIFT; valid && oy <= oy1; oy++)
+            {
+                for (int32_t ox = left >> VIEWPORT_CACHE_BLOCK_SHIFT; ox <= ox1; ox++)
+                {
+                    if (!ValidBlocks[oy * BlocksX + ox])
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+            }
+            validBlocks[by * BlocksX + bx] = valid;
+        }
+    }
+    ValidBlocks = std::move(validBlocks);
+}
+
+rct_drawpixelinfo ViewportCache::GetDrawPixelInfo(const rct_drawpixelinfo* dpi, const rct_viewport* viewport) const
+{
+    rct_drawpixelinfo cacheDpi = *dpi;
+    cacheDpi.bits = const_cast<uint8_t*>(Bits.data());
+    cacheDpi.x = viewport->pos.x;
+    cacheDpi.y = viewport->pos.y;
+    cacheDpi.width = Width;
+    cacheDpi.height = Height;
+    cacheDpi.pitch = 0;
+    cacheDpi.zoom_level = 0;
+    return cacheDpi;
+}
+
+void ViewportCache::ToViewAreas(const rct_viewport* viewport, std::vector<ScreenRect>& areas) const
+{
+    const auto& viewPos = viewport->viewPos;
+    for (auto& area : areas)
+    {
+        area = { { area.GetLeft() * viewport->zoom + viewPos.x, area.GetTop() * viewport->zoom + viewPos.y },
+                 { area.GetRight() * viewport->zoom + viewPos.x, area.GetBottom() * viewport->zoom + viewPos.y } };
+    }
+}
+
+void ViewportCache::Paint(const rct_drawpixelinfo* dpi, const rct_viewport* viewport, std::vector<ScreenRect>& areas)
+{
+    if (areas.empty())
+        return;
+
+    auto cacheDpi = GetDrawPixelInfo(dpi, viewport);
+    ToViewAreas(viewport, areas);
+    viewport_paint(viewport, &cacheDpi, areas);
+}
+
+void ViewportCache::CollectInvalid(int32_t left, int32_t top, int32_t right, int32_t bottom, std::vector<ScreenRect>& areas)
+{
+    const int32_t by0 = top >> VIEWPORT_CACHE_BLOCK_SHIFT;
+    const int32_t by1 = (bottom - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT;
+    const int32_t bx0 = left >> VIEWPORT_CACHE_BLOCK_SHIFT;
+    const int32_t bx1 = (right - 1) >> VIEWPORT_CACHE_BLOCK_SHIFT;
+
+    int32_t spanLeft = -1;
+    int32_t spanTop = 0;
+    int32_t spanBottom = 0;
+    for (int32_t bx = bx0; bx <= bx1 + 1; bx++)
+    {
+        int32_t first = -1;
+        int32_t last = -1;
+        if (bx <= bx1)
+        {
+            for (int32_t by = by0; by <= by1; by++)
+            {
+                if (!ValidBlocks[by * BlocksX + bx])
+                {
+                    if (first == -1)
+                        first = by;
+                    last = by;
+                }
+            }
+        }
+
+        if (spanLeft != -1 && (first != spanTop || last != spanBottom))
+        {
+            areas.push_back(
+                { { spanLeft << VIEWPORT_CACHE_BLOCK_SHIFT, spanTop << VIEWPORT_CACHE_BLOCK_SHIFT },
+                  { std::min(bx << VIEWPORT_CACHE_BLOCK_SHIFT, Width),
+                    std::min((spanBottom + 1) << VIEWPORT_CACHE_BLOCK_SHIFT, Height) } });
+            for (int32_t x = spanLeft; x < bx; x++)
+            {
+                for (int32_t y = spanTop; y <= spanBottom; y++)
+                {
+                    ValidBlocks[y * BlocksX + x] = true;
+                }
+            }
+            spanLeft = -1;
+        }
+        if (spanLeft == -1 && first != -1)
+        {
+            spanLeft = bx;
+            spanTop = first;
+            spanBottom = last;
+        }
+    }
+}
+
+void ViewportCache::Update(
+    const rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    std::vector<ScreenRect> areas;
+    CollectInvalid(left, top, right, bottom, areas);
+    Paint(dpi, viewport, areas);
+}
+
+void ViewportCache::CollectLights(
+    const rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom) const
+{
+    auto cacheDpi = GetDrawPixelInfo(dpi, viewport);
+    std::vector<ScreenRect> areas = { { { left, top }, { right, bottom } } };
+    ToViewAreas(viewport, areas);
+    viewport_generate(viewport, &cacheDpi, areas);
+}
+
+static std::array<ViewportCache, MAX_VIEWPORT_COUNT> _viewportCaches;
+
+ViewportCache* viewport_cache_get(const rct_viewport* viewport)
+{
+    if (viewport < g_viewport_list || viewport >= g_viewport_list + MAX_VIEWPORT_COUNT)
+        return nullptr;
+    return &_viewportCaches[viewport - g_viewport_list];
+}
+
+static ScreenCoordsXY viewport_cache_get_origin(const rct_viewport* viewport)
+{
+    // Same alignment as viewport_paint applies to the view position
+    const int32_t mask = ~((1 * viewport->zoom) - 1);
+    return { viewport->viewPos.x & mask, viewport->viewPos.y & mask };
+}
+
+/**
+ * Gets the cache of the viewport, brought up to date with the current view position and settings of the viewport.
+ * Returns nullptr if the viewport can not be cached for the given target.
+ */
+static ViewportCache* viewport_cache_acquire(const rct_drawpixelinfo* dpi, const rct_viewport* viewport)
+{
+    // Only engines that keep the screen between frames benefit, and only the viewports of windows are kept up to date
+    // by viewport_invalidate. Copies of viewports, e.g. for giant screenshots, are never cached.
+    if (dpi->DrawingEngine == nullptr || !(dpi->DrawingEngine->GetFlags() & DEF_DIRTY_OPTIMISATIONS))
+        return nullptr;
+    if (dpi->zoom_level != 0 || viewport->zoom < ZoomLevel::min() || viewport->width <= 0 || viewport->height <= 0)
+        return nullptr;
+
+    auto cache = viewport_cache_get(viewport);
+    if (cache == nullptr)
+        return nullptr;
+
+    auto origin = viewport_cache_get_origin(viewport);
+    if (!cache->Matches(viewport))
+    {
+        cache->Reset(viewport, origin);
+    }
+    else if (cache->Origin != origin)
+    {
+        cache->Scroll(origin);
+    }
+    return cache;
+}
+
+bool viewport_cache_render(
+    rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    auto cache = viewport_cache_acquire(dpi, viewport);
+    if (cache == nullptr)
+        return false;
+
+    left = std::max<int32_t>({ left, dpi->x, viewport->pos.x }) - viewport->pos.x;
+    top = std::max<int32_t>({ top, dpi->y, viewport->pos.y }) - viewport->pos.y;
+    right = std::min<int32_t>({ right, dpi->x + dpi->width, viewport->pos.x + viewport->width }) - viewport->pos.x;
+    bottom = std::min<int32_t>({ bottom, dpi->y + dpi->height, viewport->pos.y + viewport->height }) - viewport->pos.y;
+    if (left >= right || top >= bottom)
+        return true;
+
+    cache->Update(dpi, viewport, left, top, right, bottom);
+#ifdef __ENABLE_LIGHTFX__
+    if (lightfx_is_available())
+    {
+        cache->CollectLights(dpi, viewport, left, top, right, bottom);
+    }
+#endif
+
+    const int32_t dstPitch = dpi->width + dpi->pitch;
+    uint8_t* dst = dpi->bits + (viewport->pos.x + left - dpi->x) + (viewport->pos.y + top - dpi->y) * dstPitch;
+    const uint8_t* src = cache->Bits.data() + left + top * cache->Width;
+    for (int32_t y = top; y < bottom; y++)
+    {
+        std::memcpy(dst, src, right - left);
+        dst += dstPitch;
+        src += cache->Width;
+    }
+    return true;
+}
+
+void viewport_cache_prepare(const rct_drawpixelinfo* dpi, const std::vector<ScreenRect>& rects)
+{
+    std::vector<rct_window*> windows;
+    window_visit_each([&windows](rct_window* w) { windows.push_back(w); });
+
+    std::vector<ScreenRect> areas;
+    for (size_t i = 0; i < windows.size(); i++)
+    {
+        const auto* w = windows[i];
+        const auto* viewport = w->viewport;
+        if (viewport == nullptr || (w->flags & WF_TRANSPARENT))
+            continue;
+
+        ViewportCache* cache = nullptr;
+        areas.clear();
+        for (const auto& rect : rects)
+        {
+            const int32_t left = std::max<int32_t>(rect.GetLeft(), viewport->pos.x);
+            const int32_t top = std::max<int32_t>(rect.GetTop(), viewport->pos.y);
+            const int32_t right = std::min<int32_t>(rect.GetRight(), viewport->pos.x + viewport->width);
+            const int32_t bottom = std::min<int32_t>(rect.GetBottom(), viewport->pos.y + viewport->height);
+            if (left >= right || top >= bottom)
+                continue;
+
+            // Leave parts that are hidden behind a single window to be painted when they are actually drawn
+            const bool covered = std::any_of(windows.begin() + i + 1, windows.end(), [=](const rct_window* above) {
+                return !(above->flags & WF_TRANSPARENT) && above->windowPos.x <= left && above->windowPos.y <= top
+                    && above->windowPos.x + above->width >= right && above->windowPos.y + above->height >= bottom;
+            });
+            if (covered)
+                continue;
+
+            if (cache == nullptr)
+            {
+                cache = viewport_cache_acquire(dpi, viewport);
+                if (cache == nullptr)
+                    break;
+            }
+            cache->CollectInvalid(
+                left - viewport->pos.x, top - viewport->pos.y, right - viewport->pos.x, bottom - viewport->pos.y, areas);
+        }
+
+        if (cache != nullptr)
+        {
+            cache->Paint(dpi, viewport, areas);
+        }
+    }
+}
+
+void viewport_cache_invalidate(const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    auto cache = viewport_cache_get(viewport);
+    if (cache != nullptr)
+    {
+        cache->Invalidate(left, top, right, bottom);
+    }
+}
+
+void viewport_cache_invalidate_all(const rct_viewport* viewport)
+{
+    auto cache = viewport_cache_get(viewport);
+    if (cache != nullptr)
+    {
+        cache->InvalidateAll();
+    }
+}
+
+void viewport_cache_invalidate_all()
+{
+    for (auto& cache : _viewportCaches)
+    {
+        cache.InvalidateAll();
+    }
+}
@@ -0,0 +1,120 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+#include "ZoomLevel.hpp"
+
+#include <vector>
+
+struct rct_drawpixelinfo;
+struct rct_viewport;
+
+constexpr int32_t VIEWPORT_CACHE_BLOCK_SHIFT = 6;
+constexpr int32_t VIEWPORT_CACHE_BLOCK_SIZE = 1 << VIEWPORT_CACHE_BLOCK_SHIFT;
+
+/**
+ * The pixels of a viewport as they were last painted, laid out like the viewport on screen. The cache is split into
+ * square blocks which are marked invalid whenever something inside them is invalidated and are painted again the next
+ * time that part of the viewport is drawn. Everything else is copied from the cache, which makes redrawing the viewport
+ * behind windows, tooltips and the cursor cheap.
+ */
+struct ViewportCache
+{
+    std::vector<uint8_t> Bits;
+    std::vector<bool> ValidBlocks;
+    int32_t Width{};
+    int32_t Height{};
+    int32_t BlocksX{};
+    int32_t BlocksY{};
+    // View position of the top left pixel of the cache
+    ScreenCoordsXY Origin;
+    ZoomLevel Zoom;
+    uint32_t Flags{};
+    uint8_t Rotation{};
+
+    bool Matches(const rct_viewport* viewport) const;
+    void Reset(const rct_viewport* viewport, const ScreenCoordsXY& origin);
+    void InvalidateAll();
+
+    /**
+     * Left, top, right and bottom represent 2D map coordinates at zoom 0.
+     */
+    void Invalidate(int32_t left, int32_t top, int32_t right, int32_t bottom);
+
+    /**
+     * Left, top, right and bottom are pixels of the cache.
+     */
+    void InvalidatePixels(int32_t left, int32_t top, int32_t right, int32_t bottom);
+
+    /**
+     * Moves the cached pixels to follow the viewport to a new view position. Only the blocks that are fully covered by
+     * valid pixels of the old position stay valid.
+     */
+    void Scroll(const ScreenCoordsXY& origin);
+
+    /**
+     * Paints the given areas of the cache from the viewport. The areas are pixels of the cache.
+     */
+    void Paint(const rct_drawpixelinfo* dpi, const rct_viewport* viewport, std::vector<ScreenRect>& areas);
+
+    /**
+     * Marks all invalid blocks overlapping the given pixels of the cache as valid and adds the areas that need to be
+     * painted for them. The invalid blocks of each block column form a single span and neighbouring columns with the
+     * same span are merged, as the cost of painting a column hardly depends on its height.
+     */
+    void CollectInvalid(int32_t left, int32_t top, int32_t right, int32_t bottom, std::vector<ScreenRect>& areas);
+
+    /**
+     * Paints all invalid blocks overlapping the given pixels of the cache.
+     */
+    void Update(
+        const rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom);
+
+    /**
+     * Adds the LightFX lights of the given pixels of the cache. Lights are collected while painting, so the parts that
+     * are copied from the cache have to collect theirs again every frame.
+     */
+    void CollectLights(
+        const rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right,
+        int32_t bottom) const;
+
+private:
+    rct_drawpixelinfo GetDrawPixelInfo(const rct_drawpixelinfo* dpi, const rct_viewport* viewport) const;
+    void ToViewAreas(const rct_viewport* viewport, std::vector<ScreenRect>& areas) const;
+};
+
+/**
+ * Gets the render cache of a viewport in g_viewport_list, or nullptr for any other viewport.
+ */
+ViewportCache* viewport_cache_get(const rct_viewport* viewport);
+
+/**
+ * Draws the given screen area of a viewport from its render cache, painting only the parts of the cache that have been
+ * invalidated since they were last drawn. Returns false if the viewport or target can not be cached, in which case
+ * nothing has been drawn and the caller should fall back to viewport_render.
+ */
+bool viewport_cache_render(
+    rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom);
+
+/**
+ * Paints the parts of the render caches of all window viewports under the given screen rectangles that have been
+ * invalidated, filling the columns of every rectangle on the paint job pool at once. Drawing the windows afterwards then
+ * only has to copy from the caches.
+ */
+void viewport_cache_prepare(const rct_drawpixelinfo* dpi, const std::vector<ScreenRect>& rects);
+
+/**
+ * Left, top, right and bottom represent 2D map coordinates at zoom 0.
+ */
+void viewport_cache_invalidate(const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom);
+void viewport_cache_invalidate_all(const rct_viewport* viewport);
+void viewport_cache_invalidate_all();
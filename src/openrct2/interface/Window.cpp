@@ -29,6 +29,7 @@
 #include "../world/Map.h"
 #include "../world/Sprite.h"
 #include "Viewport.h"
+#include "ViewportCache.h"
 #include "Widget.h"
 #include "Window_internal.h"
 
@@ -1250,7 +1251,10 @@ static void window_draw_single(rct_drawpixelinfo* dpi, rct_window* w, int32_t le
  */
 void window_draw_viewport(rct_drawpixelinfo* dpi, rct_window* w)
 {
-    viewport_render(dpi, w->viewport, dpi->x, dpi->y, dpi->x + dpi->width, dpi->y + dpi->height);
+    if (!viewport_cache_render(dpi, w->viewport, dpi->x, dpi->y, dpi->x + dpi->width, dpi->y + dpi->height))
+    {
+        viewport_render(dpi, w->viewport, dpi->x, dpi->y, dpi->x + dpi->width, dpi->y + dpi->height);
+    }
 }
 
 void window_set_position(rct_window* w, const ScreenCoordsXY& screenCoords)
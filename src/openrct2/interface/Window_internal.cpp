@@ -1,6 +1,7 @@
 #include "Window_internal.h"
 
 #include "../world/Sprite.h"
+#include "ViewportCache.h"
 
 void rct_window::SetLocation(const CoordsXYZ& coords)
 {
@@ -40,5 +41,7 @@ void rct_window::ScrollToViewport()
 
 void rct_window::Invalidate()
 {
+    if (viewport != nullptr)
+        viewport_cache_invalidate_all(viewport);
     gfx_set_dirty_blocks({ windowPos, windowPos + ScreenCoordsXY{ width, height } });
 }
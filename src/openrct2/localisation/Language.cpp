@@ -131,6 +131,12 @@ rct_string_id language_allocate_object_string(const std::string& target)
     return localisationService.AllocateObjectString(target);
 }
 
+size_t language_get_num_available_object_strings()
+{
+    const auto& localisationService = OpenRCT2::GetContext()->GetLocalisationService();
+    return localisationService.GetNumAvailableObjectStrings();
+}
+
 std::string language_convert_string_to_tokens(const std::string_view& s)
 {
     std::string result;
@@ -106,6 +106,7 @@ std::string utf8_to_rct2(const std::string_view& src);
 bool language_get_localised_scenario_strings(const utf8* scenarioFilename, rct_string_id* outStringIds);
 void language_free_object_string(rct_string_id stringId);
 rct_string_id language_allocate_object_string(const std::string& target);
+size_t language_get_num_available_object_strings();
 std::string language_convert_string_to_tokens(const std::string_view& s);
 std::string language_convert_string(const std::string_view& s);
 
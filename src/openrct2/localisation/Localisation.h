@@ -127,6 +127,11 @@ public:
         return CurrentBuf - StartBuf;
     }
 
+    const uint8_t* Data() const
+    {
+        return StartBuf;
+    }
+
     template<typename TSpecified, typename TDeduced> Formatter& Add(TDeduced value)
     {
         static_assert(sizeof(TSpecified) <= sizeof(uintptr_t), "Type too large");
@@ -54,9 +54,13 @@ const char* LocalisationService::GetString(rct_string_id id) const
         {
             result = _languageCurrent->GetString(id);
         }
-        if (result == nullptr && _languageFallback != nullptr)
+        if (result == nullptr)
         {
-            result = _languageFallback->GetString(id);
+            auto languageFallback = GetFallbackLanguage();
+            if (languageFallback != nullptr)
+            {
+                result = languageFallback->GetString(id);
+            }
         }
         if (result == nullptr)
         {
@@ -82,15 +86,14 @@ void LocalisationService::OpenLanguage(int32_t id, IObjectManager& objectManager
         throw std::invalid_argument("id was undefined");
     }
 
-    std::string filename;
+    // The fallback language is only read once a string is missing from the current language
     if (id != LANGUAGE_ENGLISH_UK)
     {
-        filename = GetLanguagePath(LANGUAGE_ENGLISH_UK);
-        _languageFallback = std::unique_ptr<ILanguagePack>(
-            LanguagePackFactory::FromFile(LANGUAGE_ENGLISH_UK, filename.c_str()));
+        _languageFallbackPath = GetLanguagePath(LANGUAGE_ENGLISH_UK);
+        _languageFallbackLoaded = std::make_unique<std::once_flag>();
     }
 
-    filename = GetLanguagePath(id);
+    auto filename = GetLanguagePath(id);
     _languageCurrent = std::unique_ptr<ILanguagePack>(LanguagePackFactory::FromFile(id, filename.c_str()));
     if (_languageCurrent != nullptr)
     {
@@ -106,8 +109,24 @@ void LocalisationService::OpenLanguage(int32_t id, IObjectManager& objectManager
     }
 }
 
+const ILanguagePack* LocalisationService::GetFallbackLanguage() const
+{
+    if (_languageFallbackLoaded == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::call_once(*_languageFallbackLoaded, [this]() {
+        _languageFallback = std::unique_ptr<ILanguagePack>(
+            LanguagePackFactory::FromFile(LANGUAGE_ENGLISH_UK, _languageFallbackPath.c_str()));
+    });
+    return _languageFallback.get();
+}
+
 void LocalisationService::CloseLanguages()
 {
+    _languageFallbackPath.clear();
+    _languageFallbackLoaded = nullptr;
     _languageFallback = nullptr;
     _languageCurrent = nullptr;
     _currentLanguage = LANGUAGE_UNDEFINED;
@@ -133,6 +152,12 @@ rct_string_id LocalisationService::GetObjectOverrideStringId(const std::string_v
 
 rct_string_id LocalisationService::AllocateObjectString(const std::string& target)
 {
+    if (_availableObjectStringIds.empty())
+    {
+        log_warning("No object string ids left for \"%s\"", target.c_str());
+        return STR_EMPTY;
+    }
+
     auto stringId = _availableObjectStringIds.top();
     _availableObjectStringIds.pop();
     _languageCurrent->SetString(stringId, target);
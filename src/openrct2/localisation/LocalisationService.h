@@ -12,6 +12,7 @@
 #include "../common.h"
 
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <string_view>
@@ -33,7 +34,9 @@ namespace OpenRCT2::Localisation
         const std::shared_ptr<IPlatformEnvironment> _env;
         int32_t _currentLanguage{};
         bool _useTrueTypeFont{};
-        std::unique_ptr<ILanguagePack> _languageFallback;
+        std::string _languageFallbackPath;
+        mutable std::unique_ptr<std::once_flag> _languageFallbackLoaded;
+        mutable std::unique_ptr<ILanguagePack> _languageFallback;
         std::unique_ptr<ILanguagePack> _languageCurrent;
         std::stack<rct_string_id> _availableObjectStringIds;
 
@@ -64,6 +67,13 @@ namespace OpenRCT2::Localisation
         void CloseLanguages();
         rct_string_id AllocateObjectString(const std::string& target);
         void FreeObjectString(rct_string_id stringId);
+        size_t GetNumAvailableObjectStrings() const
+        {
+            return _availableObjectStringIds.size();
+        }
+
+    private:
+        const ILanguagePack* GetFallbackLanguage() const;
     };
 } // namespace OpenRCT2::Localisation
 
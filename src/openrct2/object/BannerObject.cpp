@@ -59,7 +59,6 @@ void BannerObject::ReadLegacy(IReadObjectContext* context, IStream* stream)
 
 void BannerObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.name = language_allocate_object_string(GetName());
     _legacyType.image = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
 }
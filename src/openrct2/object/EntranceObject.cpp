@@ -27,7 +27,6 @@ void EntranceObject::ReadLegacy(IReadObjectContext* context, IStream* stream)
 
 void EntranceObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.string_idx = language_allocate_object_string(GetName());
     _legacyType.image_id = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
 }
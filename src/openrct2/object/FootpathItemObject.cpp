@@ -63,7 +63,6 @@ void FootpathItemObject::ReadLegacy(IReadObjectContext* context, IStream* stream
 
 void FootpathItemObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.name = language_allocate_object_string(GetName());
     _legacyType.image = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
 
@@ -35,7 +35,6 @@ void FootpathObject::ReadLegacy(IReadObjectContext* context, IStream* stream)
 
 void FootpathObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.string_idx = language_allocate_object_string(GetName());
     _legacyType.image = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
     _legacyType.bridge_image = _legacyType.image + 109;
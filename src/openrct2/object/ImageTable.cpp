@@ -88,6 +88,7 @@ void ImageTable::Read(IReadObjectContext* context, IStream* stream)
         }
 
         _data = std::move(data);
+        _dataSize = dataSize;
         _entries.insert(_entries.end(), newEntries.begin(), newEntries.end());
     }
     catch (const std::exception&)
@@ -112,3 +113,23 @@ void ImageTable::AddImage(const rct_g1_element* g1)
     }
     _entries.push_back(newg1);
 }
+
+size_t ImageTable::GetMemoryUsage() const
+{
+    size_t result = _entries.capacity() * sizeof(rct_g1_element);
+    if (_data != nullptr)
+    {
+        result += _dataSize;
+    }
+    else
+    {
+        for (const auto& entry : _entries)
+        {
+            if (entry.offset != nullptr)
+            {
+                result += g1_calculate_data_size(&entry);
+            }
+        }
+    }
+    return result;
+}
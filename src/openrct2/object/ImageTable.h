@@ -22,6 +22,7 @@ class ImageTable
 {
 private:
     std::unique_ptr<uint8_t[]> _data;
+    size_t _dataSize{};
     std::vector<rct_g1_element> _entries;
 
 public:
@@ -40,4 +41,9 @@ public:
         return static_cast<uint32_t>(_entries.size());
     }
     void AddImage(const rct_g1_element* g1);
+
+    /**
+     * Gets the number of bytes held by the image headers and pixel data.
+     */
+    size_t GetMemoryUsage() const;
 };
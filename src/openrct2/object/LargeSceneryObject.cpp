@@ -69,7 +69,6 @@ void LargeSceneryObject::ReadLegacy(IReadObjectContext* context, IStream* stream
 
 void LargeSceneryObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.name = language_allocate_object_string(GetName());
     _baseImageId = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
     _legacyType.image = _baseImageId;
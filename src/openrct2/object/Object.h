@@ -14,6 +14,7 @@
 #include "StringTable.h"
 
 #include <algorithm>
+#include <cstring>
 #include <optional>
 #include <string_view>
 #include <vector>
@@ -134,6 +135,30 @@ struct rct_object_filters
 assert_struct_size(rct_object_filters, 3);
 #pragma pack(pop)
 
+/**
+ * Hashes and compares legacy object identifiers by name only, which is how the object repository finds objects.
+ */
+struct ObjectEntryHash
+{
+    size_t operator()(const rct_object_entry& entry) const
+    {
+        uint32_t hash = 5381;
+        for (auto i : entry.name)
+        {
+            hash = ((hash << 5) + hash) + i;
+        }
+        return hash;
+    }
+};
+
+struct ObjectEntryEqual
+{
+    bool operator()(const rct_object_entry& lhs, const rct_object_entry& rhs) const
+    {
+        return memcmp(&lhs.name, &rhs.name, 8) == 0;
+    }
+};
+
 interface IObjectRepository;
 interface IStream;
 struct ObjectRepositoryItem;
@@ -257,6 +282,11 @@ public:
     {
         return GetImageTable().GetCount();
     }
+
+    size_t GetStringTableMemoryUsage() const
+    {
+        return GetStringTable().GetMemoryUsage();
+    }
 };
 #ifdef __WARN_SUGGEST_FINAL_TYPES__
 #    pragma GCC diagnostic pop
@@ -0,0 +1,230 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ObjectCache.h"
+
+#include "../Context.h"
+#include "../PlatformEnvironment.h"
+#include "../core/File.h"
+#include "../core/FileScanner.h"
+#include "../core/FileSystem.hpp"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+using namespace OpenRCT2;
+
+namespace ObjectCache
+{
+    constexpr uint32_t MAGIC_NUMBER = 0x4843424F; // OBCH
+
+    // Increment this when the format of any cached data changes, so that old entries are ignored
+    constexpr uint16_t VERSION = 1;
+
+    struct EntryHeader
+    {
+        uint32_t MagicNumber;
+        uint16_t Version;
+        uint16_t HeaderSize;
+        uint64_t Key;
+        uint64_t DataLength;
+        uint64_t DataHash;
+    };
+
+    static std::atomic<uint32_t> _nextTemporaryId;
+
+    static std::string GetDirectory()
+    {
+        auto context = GetContext();
+        if (context == nullptr)
+        {
+            return {};
+        }
+        auto env = context->GetPlatformEnvironment();
+        return Path::Combine(env->GetDirectoryPath(DIRBASE::CACHE), "objcache");
+    }
+
+    static std::string GetEntryPath(uint64_t key)
+    {
+        auto directory = GetDirectory();
+        if (directory.empty())
+        {
+            return {};
+        }
+        return Path::Combine(directory, String::StdFormat("%016" PRIx64 ".bin", key));
+    }
+
+    Entry::Entry(std::unique_ptr<MemoryMappedFile> file)
+        : _file(std::move(file))
+    {
+    }
+
+    const uint8_t* Entry::GetData() const
+    {
+        return _file->GetData() + sizeof(EntryHeader);
+    }
+
+    size_t Entry::GetLength() const
+    {
+        return _file->GetLength() - sizeof(EntryHeader);
+    }
+
+    uint64_t Hash(uint64_t hash, const void* data, size_t length)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3;
+        }
+        return hash;
+    }
+
+    uint64_t Hash(uint64_t hash, const std::string_view& s)
+    {
+        // Include the terminator so that consecutive strings can not run into each other
+        hash = Hash(hash, s.data(), s.size());
+        return Hash(hash, "", 1);
+    }
+
+    std::unique_ptr<Entry> Read(uint64_t key)
+    {
+        auto path = GetEntryPath(key);
+        if (path.empty() || !File::Exists(path))
+        {
+            return nullptr;
+        }
+
+        try
+        {
+            auto file = std::make_unique<MemoryMappedFile>(path);
+            EntryHeader header;
+            if (file->GetLength() < sizeof(header))
+            {
+                return nullptr;
+            }
+            std::memcpy(&header, file->GetData(), sizeof(header));
+            if (header.MagicNumber != MAGIC_NUMBER || header.Version != VERSION || header.HeaderSize != sizeof(header)
+                || header.Key != key || header.DataLength != file->GetLength() - sizeof(header))
+            {
+                return nullptr;
+            }
+
+            if (Hash(HASH_SEED, file->GetData() + sizeof(header), header.DataLength) != header.DataHash)
+            {
+                log_warning("Object cache entry '%s' is corrupt.", path.c_str());
+                return nullptr;
+            }
+
+            // Pruning goes by the modification time, so mark the entry as used. Failing to do so is harmless.
+            std::error_code ec;
+            fs::last_write_time(fs::u8path(path), fs::file_time_type::clock::now(), ec);
+            return std::make_unique<Entry>(std::move(file));
+        }
+        catch (const std::exception& e)
+        {
+            log_warning("Unable to read object cache entry '%s': %s", path.c_str(), e.what());
+        }
+        return nullptr;
+    }
+
+    void Write(uint64_t key, const void* data, size_t length)
+    {
+        auto path = GetEntryPath(key);
+        if (path.empty())
+        {
+            return;
+        }
+
+        try
+        {
+            EntryHeader header;
+            header.MagicNumber = MAGIC_NUMBER;
+            header.Version = VERSION;
+            header.HeaderSize = sizeof(header);
+            header.Key = key;
+            header.DataLength = length;
+            header.DataHash = Hash(HASH_SEED, data, length);
+
+            std::vector<uint8_t> entry(sizeof(header) + length);
+            std::memcpy(entry.data(), &header, sizeof(header));
+            std::memcpy(entry.data() + sizeof(header), data, length);
+
+            // Write to a temporary file first so that other threads never read a partially written entry
+            Path::CreateDirectory(Path::GetDirectory(path));
+            auto temporaryPath = path + "." + std::to_string(_nextTemporaryId++) + ".tmp";
+            File::WriteAllBytes(temporaryPath, entry.data(), entry.size());
+            if (!File::Move(temporaryPath, path))
+            {
+                // Another thread may have written the same entry in the meantime
+                File::Delete(temporaryPath);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            log_warning("Unable to write object cache entry '%s': %s", path.c_str(), e.what());
+        }
+    }
+
+    void Prune(uint64_t maxSize)
+    {
+        auto directory = GetDirectory();
+        if (directory.empty() || !Path::DirectoryExists(directory))
+        {
+            return;
+        }
+
+        struct EntryFile
+        {
+            std::string Path;
+            uint64_t Size;
+            uint64_t LastModified;
+        };
+
+        std::vector<EntryFile> entryFiles;
+        uint64_t totalSize = 0;
+        auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(Path::Combine(directory, "*.bin"), false));
+        while (scanner->Next())
+        {
+            auto fileInfo = scanner->GetFileInfo();
+            entryFiles.push_back({ scanner->GetPath(), fileInfo->Size, fileInfo->LastModified });
+            totalSize += fileInfo->Size;
+        }
+        if (totalSize <= maxSize)
+        {
+            return;
+        }
+
+        std::sort(entryFiles.begin(), entryFiles.end(), [](const EntryFile& a, const EntryFile& b) {
+            return a.LastModified != b.LastModified ? a.LastModified < b.LastModified : a.Path < b.Path;
+        });
+
+        // Entries that are being read can not be deleted on some platforms, those are skipped
+        size_t numDeleted = 0;
+        for (const auto& entryFile : entryFiles)
+        {
+            if (totalSize <= maxSize)
+            {
+                break;
+            }
+            if (File::Delete(entryFile.Path))
+            {
+                totalSize -= entryFile.Size;
+                numDeleted++;
+            }
+        }
+        log_verbose("Deleted %zu object cache entries, %" PRIu64 " bytes remaining.", numDeleted, totalSize);
+    }
+} // namespace ObjectCache
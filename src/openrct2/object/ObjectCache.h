@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../core/MemoryMappedFile.h"
+
+#include <memory>
+#include <string_view>
+
+/**
+ * An on-disk cache of data compiled while loading objects, such as images that had to be decoded and encoded, so that
+ * the work only has to be done once for the same source content. Entries are stored in the user's cache directory,
+ * one file per key, and are safe to read and write from several threads.
+ */
+namespace ObjectCache
+{
+    constexpr uint64_t HASH_SEED = 0xCBF29CE484222325;
+
+    // Size the cache directory is pruned back to at startup
+    constexpr uint64_t MAX_SIZE = 256 * 1024 * 1024;
+
+    /**
+     * The data of an entry, read in place from the mapped entry file.
+     */
+    class Entry final
+    {
+    private:
+        std::unique_ptr<MemoryMappedFile> _file;
+
+    public:
+        explicit Entry(std::unique_ptr<MemoryMappedFile> file);
+
+        const uint8_t* GetData() const;
+        size_t GetLength() const;
+    };
+
+    /**
+     * Adds the given data to a 64-bit FNV-1a hash. Keys are built by hashing everything the cached data was compiled
+     * from, starting at HASH_SEED.
+     */
+    uint64_t Hash(uint64_t hash, const void* data, size_t length);
+    uint64_t Hash(uint64_t hash, const std::string_view& s);
+
+    /**
+     * Maps the data stored for the given key, or returns nullptr if there is none, it is corrupt or it was written by a
+     * different version. Reading an entry marks it as recently used.
+     */
+    std::unique_ptr<Entry> Read(uint64_t key);
+
+    /**
+     * Stores data for the given key, replacing any existing entry. Failures are logged and otherwise ignored.
+     */
+    void Write(uint64_t key, const void* data, size_t length);
+
+    /**
+     * Deletes the least recently used entries until the entries take up no more than the given number of bytes.
+     */
+    void Prune(uint64_t maxSize = MAX_SIZE);
+} // namespace ObjectCache
@@ -161,7 +161,7 @@ public:
 namespace ObjectFactory
 {
     static Object* CreateObjectFromJson(
-        IObjectRepository& objectRepository, const json_t* jRoot, const IFileDataRetriever* fileRetriever);
+        IObjectRepository& objectRepository, const json_t* jRoot, const IFileDataRetriever* fileRetriever, bool loadImages);
 
     static uint8_t ParseSourceGame(const std::string& s)
     {
@@ -351,7 +351,7 @@ namespace ObjectFactory
         return 0xFF;
     }
 
-    Object* CreateObjectFromZipFile(IObjectRepository& objectRepository, const std::string_view& path)
+    Object* CreateObjectFromZipFile(IObjectRepository& objectRepository, const std::string_view& path, bool loadImages)
     {
         Object* result = nullptr;
         try
@@ -371,7 +371,7 @@ namespace ObjectFactory
             }
 
             auto fileDataRetriever = ZipDataRetriever(*archive);
-            Object* obj = CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever);
+            Object* obj = CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever, loadImages);
             json_decref(jRoot);
             return obj;
         }
@@ -385,7 +385,7 @@ namespace ObjectFactory
         return result;
     }
 
-    Object* CreateObjectFromJsonFile(IObjectRepository& objectRepository, const std::string& path)
+    Object* CreateObjectFromJsonFile(IObjectRepository& objectRepository, const std::string& path, bool loadImages)
     {
         log_verbose("CreateObjectFromJsonFile(\"%s\")", path.c_str());
 
@@ -394,7 +394,7 @@ namespace ObjectFactory
         {
             auto jRoot = Json::ReadFromFile(path.c_str());
             auto fileDataRetriever = FileSystemDataRetriever(Path::GetDirectory(path));
-            result = CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever);
+            result = CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever, loadImages);
             json_decref(jRoot);
         }
         catch (const std::runtime_error& err)
@@ -408,7 +408,7 @@ namespace ObjectFactory
     }
 
     Object* CreateObjectFromJson(
-        IObjectRepository& objectRepository, const json_t* jRoot, const IFileDataRetriever* fileRetriever)
+        IObjectRepository& objectRepository, const json_t* jRoot, const IFileDataRetriever* fileRetriever, bool loadImages)
     {
         log_verbose("CreateObjectFromJson(...)");
 
@@ -436,7 +436,7 @@ namespace ObjectFactory
                 result = CreateObject(entry);
                 result->SetIdentifier(id);
                 result->MarkAsJsonObject();
-                auto readContext = ReadObjectContext(objectRepository, id, !gOpenRCT2NoGraphics, fileRetriever);
+                auto readContext = ReadObjectContext(objectRepository, id, loadImages, fileRetriever);
                 result->ReadJson(&readContext, jRoot);
                 if (readContext.WasError())
                 {
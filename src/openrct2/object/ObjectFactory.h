@@ -22,8 +22,8 @@ namespace ObjectFactory
     Object* CreateObjectFromLegacyFile(IObjectRepository& objectRepository, const utf8* path);
     Object* CreateObjectFromLegacyData(
         IObjectRepository& objectRepository, const rct_object_entry* entry, const void* data, size_t dataSize);
-    Object* CreateObjectFromZipFile(IObjectRepository& objectRepository, const std::string_view& path);
+    Object* CreateObjectFromZipFile(IObjectRepository& objectRepository, const std::string_view& path, bool loadImages);
     Object* CreateObject(const rct_object_entry& entry);
 
-    Object* CreateObjectFromJsonFile(IObjectRepository& objectRepository, const std::string& path);
+    Object* CreateObjectFromJsonFile(IObjectRepository& objectRepository, const std::string& path, bool loadImages);
 } // namespace ObjectFactory
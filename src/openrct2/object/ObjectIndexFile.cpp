@@ -0,0 +1,380 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ObjectIndexFile.h"
+
+#include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/MemoryMappedFile.h"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
+#include "ObjectRepository.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+static constexpr size_t TABLE_ALIGNMENT = 8;
+
+static size_t AlignTable(size_t offset)
+{
+    return (offset + TABLE_ALIGNMENT - 1) & ~(TABLE_ALIGNMENT - 1);
+}
+
+namespace
+{
+    /**
+     * Collects the strings and lists referenced by the index records into one block.
+     */
+    class PoolBuilder
+    {
+    private:
+        std::vector<uint8_t> _data;
+
+    public:
+        uint32_t Add(const void* data, size_t length)
+        {
+            if (_data.size() + length > UINT32_MAX)
+            {
+                throw std::runtime_error("Object index too large.");
+            }
+            auto offset = static_cast<uint32_t>(_data.size());
+            if (length != 0)
+            {
+                auto bytes = static_cast<const uint8_t*>(data);
+                _data.insert(_data.end(), bytes, bytes + length);
+            }
+            return offset;
+        }
+
+        uint32_t Add(std::string_view s)
+        {
+            return Add(s.data(), s.size());
+        }
+
+        const std::vector<uint8_t>& GetData() const
+        {
+            return _data;
+        }
+    };
+} // namespace
+
+ObjectIndexFile::ObjectIndexFile(std::unique_ptr<MemoryMappedFile> file)
+    : _file(std::move(file))
+{
+}
+
+ObjectIndexFile::~ObjectIndexFile() = default;
+
+std::unique_ptr<ObjectIndexFile> ObjectIndexFile::Open(
+    const std::string& path, uint32_t magicNumber, uint16_t version, int32_t language)
+{
+    if (!File::Exists(path))
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        log_verbose("ObjectIndexFile:Mapping index: '%s'", path.c_str());
+        auto index = std::unique_ptr<ObjectIndexFile>(new ObjectIndexFile(std::make_unique<MemoryMappedFile>(path)));
+        if (index->Validate(magicNumber, version, language))
+        {
+            return index;
+        }
+        log_verbose("ObjectIndexFile:Index '%s' is out of date or invalid", path.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to load index: '%s'.", path.c_str());
+        Console::Error::WriteLine("%s", e.what());
+    }
+    return nullptr;
+}
+
+bool ObjectIndexFile::Validate(uint32_t magicNumber, uint16_t version, int32_t language)
+{
+    const auto* data = _file->GetData();
+    const uint64_t length = _file->GetLength();
+    if (data == nullptr || length < sizeof(Header))
+    {
+        return false;
+    }
+
+    const auto& header = *reinterpret_cast<const Header*>(data);
+    if (header.MagicNumber != magicNumber || header.Version != version || header.Language != language
+        || header.HeaderSize != sizeof(Header))
+    {
+        return false;
+    }
+
+    // Check every table and pool range up front so that they can be read later without any checks
+    const uint64_t numAllItems = static_cast<uint64_t>(header.NumItems) + header.NumShadowedItems;
+    auto tableFits = [length](uint32_t offset, uint64_t count, size_t recordSize) {
+        return offset % TABLE_ALIGNMENT == 0 && offset + count * recordSize <= length;
+    };
+    if (!tableFits(header.FilesOffset, header.NumFiles, sizeof(FileRecord))
+        || !tableFits(header.ItemsOffset, numAllItems, sizeof(ItemRecord))
+        || !tableFits(header.LookupOffset, header.NumItems, sizeof(LookupRecord))
+        || static_cast<uint64_t>(header.PoolOffset) + header.PoolSize > length)
+    {
+        return false;
+    }
+
+    const auto* files = reinterpret_cast<const FileRecord*>(data + header.FilesOffset);
+    const auto* items = reinterpret_cast<const ItemRecord*>(data + header.ItemsOffset);
+    const auto* lookup = reinterpret_cast<const LookupRecord*>(data + header.LookupOffset);
+    auto poolFits = [&header](uint32_t offset, uint64_t count, size_t elementSize) {
+        return offset + count * elementSize <= header.PoolSize;
+    };
+    for (uint32_t i = 0; i < header.NumFiles; i++)
+    {
+        const auto& file = files[i];
+        if (!poolFits(file.PathOffset, file.PathLength, 1) || (file.ItemIndex != NO_ITEM && file.ItemIndex >= numAllItems))
+        {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < numAllItems; i++)
+    {
+        const auto& item = items[i];
+        if (!poolFits(item.PathOffset, item.PathLength, 1) || !poolFits(item.NameOffset, item.NameLength, 1)
+            || !poolFits(item.SourcesOffset, item.NumSources, 1)
+            || !poolFits(item.SceneryEntriesOffset, item.NumSceneryEntries, sizeof(rct_object_entry)))
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header.NumItems; i++)
+    {
+        if (lookup[i].ItemIndex >= header.NumItems)
+        {
+            return false;
+        }
+    }
+
+    _header = &header;
+    _files = files;
+    _items = items;
+    _lookup = lookup;
+    _pool = data + header.PoolOffset;
+    return true;
+}
+
+std::string_view ObjectIndexFile::GetString(uint32_t offset, uint32_t length) const
+{
+    return std::string_view(reinterpret_cast<const char*>(_pool + offset), length);
+}
+
+std::string_view ObjectIndexFile::GetFilePath(size_t index) const
+{
+    const auto& file = _files[index];
+    return GetString(file.PathOffset, file.PathLength);
+}
+
+const ObjectIndexFile::FileRecord& ObjectIndexFile::GetFile(size_t index) const
+{
+    return _files[index];
+}
+
+uint32_t ObjectIndexFile::FindItem(const rct_object_entry& entry) const
+{
+    auto begin = _lookup;
+    auto end = _lookup + _header->NumItems;
+    auto it = std::lower_bound(begin, end, entry, [](const LookupRecord& record, const rct_object_entry& value) {
+        return std::memcmp(record.Name, value.name, sizeof(record.Name)) < 0;
+    });
+    if (it != end && std::memcmp(it->Name, entry.name, sizeof(it->Name)) == 0)
+    {
+        return it->ItemIndex;
+    }
+    return NO_ITEM;
+}
+
+ObjectRepositoryItem ObjectIndexFile::ReadItem(size_t index) const
+{
+    const auto& record = _items[index];
+
+    ObjectRepositoryItem item = {};
+    item.Id = index;
+    item.ObjectEntry = record.ObjectEntry;
+    item.Path = GetString(record.PathOffset, record.PathLength);
+    item.Name = GetString(record.NameOffset, record.NameLength);
+    item.Sources.assign(_pool + record.SourcesOffset, _pool + record.SourcesOffset + record.NumSources);
+    switch (item.ObjectEntry.GetType())
+    {
+        case OBJECT_TYPE_RIDE:
+            item.RideInfo.RideFlags = record.RideFlags;
+            std::copy_n(record.RideCategory, MAX_CATEGORIES_PER_RIDE, item.RideInfo.RideCategory);
+            std::copy_n(record.RideType, MAX_RIDE_TYPES_PER_RIDE_ENTRY, item.RideInfo.RideType);
+            break;
+        case OBJECT_TYPE_SCENERY_GROUP:
+        {
+            const auto* entries = _pool + record.SceneryEntriesOffset;
+            item.SceneryGroupInfo.Entries.resize(record.NumSceneryEntries);
+            for (uint32_t i = 0; i < record.NumSceneryEntries; i++)
+            {
+                std::memcpy(
+                    &item.SceneryGroupInfo.Entries[i], entries + i * sizeof(rct_object_entry), sizeof(rct_object_entry));
+            }
+            break;
+        }
+    }
+    return item;
+}
+
+void ObjectIndexFile::Write(
+    const std::string& path, uint32_t magicNumber, uint16_t version, int32_t language, const std::vector<FileEntry>& files)
+{
+    // The first object with a legacy identifier wins, like when objects are added to the repository one by one
+    std::vector<const ObjectRepositoryItem*> items;
+    std::vector<const ObjectRepositoryItem*> shadowedItems;
+    std::unordered_map<std::string_view, const ObjectRepositoryItem*> itemsByName;
+    for (const auto& file : files)
+    {
+        if (file.Item != nullptr)
+        {
+            auto name = file.Item->ObjectEntry.GetName();
+            auto result = itemsByName.emplace(name, file.Item);
+            if (result.second)
+            {
+                items.push_back(file.Item);
+            }
+            else
+            {
+                Console::Error::WriteLine("Object conflict: '%s'", result.first->second->Path.c_str());
+                Console::Error::WriteLine("               : '%s'", file.Item->Path.c_str());
+                shadowedItems.push_back(file.Item);
+            }
+        }
+    }
+    if (!shadowedItems.empty())
+    {
+        Console::Error::WriteLine("%zu object conflicts found.", shadowedItems.size());
+    }
+
+    std::stable_sort(items.begin(), items.end(), [](const ObjectRepositoryItem* a, const ObjectRepositoryItem* b) {
+        return String::Compare(a->Name, b->Name) < 0;
+    });
+    const auto numItems = items.size();
+    items.insert(items.end(), shadowedItems.begin(), shadowedItems.end());
+
+    std::unordered_map<const ObjectRepositoryItem*, uint32_t> itemIndices;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        itemIndices[items[i]] = static_cast<uint32_t>(i);
+    }
+
+    PoolBuilder pool;
+
+    std::vector<FileRecord> fileRecords;
+    fileRecords.reserve(files.size());
+    for (const auto& file : files)
+    {
+        FileRecord record = {};
+        record.PathLength = static_cast<uint32_t>(file.Path.size());
+        record.PathOffset = pool.Add(file.Path);
+        record.Size = file.Size;
+        record.LastModified = file.LastModified;
+        record.ItemIndex = file.Item != nullptr ? itemIndices[file.Item] : NO_ITEM;
+        fileRecords.push_back(record);
+    }
+
+    std::vector<ItemRecord> itemRecords;
+    itemRecords.reserve(items.size());
+    for (const auto* item : items)
+    {
+        ItemRecord record = {};
+        record.ObjectEntry = item->ObjectEntry;
+        record.PathLength = static_cast<uint32_t>(item->Path.size());
+        record.PathOffset = pool.Add(item->Path);
+        record.NameLength = static_cast<uint32_t>(item->Name.size());
+        record.NameOffset = pool.Add(item->Name);
+        record.NumSources = static_cast<uint32_t>(item->Sources.size());
+        record.SourcesOffset = pool.Add(item->Sources.data(), item->Sources.size());
+        switch (item->ObjectEntry.GetType())
+        {
+            case OBJECT_TYPE_RIDE:
+                record.RideFlags = item->RideInfo.RideFlags;
+                std::copy_n(item->RideInfo.RideCategory, MAX_CATEGORIES_PER_RIDE, record.RideCategory);
+                std::copy_n(item->RideInfo.RideType, MAX_RIDE_TYPES_PER_RIDE_ENTRY, record.RideType);
+                break;
+            case OBJECT_TYPE_SCENERY_GROUP:
+            {
+                const auto& entries = item->SceneryGroupInfo.Entries;
+                record.NumSceneryEntries = static_cast<uint32_t>(entries.size());
+                record.SceneryEntriesOffset = pool.Add(entries.data(), entries.size() * sizeof(rct_object_entry));
+                break;
+            }
+        }
+        itemRecords.push_back(record);
+    }
+
+    std::vector<LookupRecord> lookupRecords(numItems);
+    for (size_t i = 0; i < numItems; i++)
+    {
+        std::memcpy(lookupRecords[i].Name, items[i]->ObjectEntry.name, sizeof(lookupRecords[i].Name));
+        lookupRecords[i].ItemIndex = static_cast<uint32_t>(i);
+    }
+    std::sort(lookupRecords.begin(), lookupRecords.end(), [](const LookupRecord& a, const LookupRecord& b) {
+        return std::memcmp(a.Name, b.Name, sizeof(a.Name)) < 0;
+    });
+
+    Header header = {};
+    header.MagicNumber = magicNumber;
+    header.Version = version;
+    header.Language = static_cast<uint16_t>(language);
+    header.HeaderSize = sizeof(Header);
+    header.NumFiles = static_cast<uint32_t>(fileRecords.size());
+    header.NumItems = static_cast<uint32_t>(numItems);
+    header.NumShadowedItems = static_cast<uint32_t>(shadowedItems.size());
+
+    size_t offset = AlignTable(sizeof(Header));
+    header.FilesOffset = static_cast<uint32_t>(offset);
+    offset = AlignTable(offset + fileRecords.size() * sizeof(FileRecord));
+    header.ItemsOffset = static_cast<uint32_t>(offset);
+    offset = AlignTable(offset + itemRecords.size() * sizeof(ItemRecord));
+    header.LookupOffset = static_cast<uint32_t>(offset);
+    offset = AlignTable(offset + lookupRecords.size() * sizeof(LookupRecord));
+    header.PoolOffset = static_cast<uint32_t>(offset);
+    header.PoolSize = static_cast<uint32_t>(pool.GetData().size());
+    if (offset + pool.GetData().size() > UINT32_MAX)
+    {
+        throw std::runtime_error("Object index too large.");
+    }
+
+    std::vector<uint8_t> buffer(offset + pool.GetData().size());
+    auto copyTable = [&buffer](uint32_t tableOffset, const auto& records) {
+        if (!records.empty())
+        {
+            std::memcpy(buffer.data() + tableOffset, records.data(), records.size() * sizeof(records[0]));
+        }
+    };
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    copyTable(header.FilesOffset, fileRecords);
+    copyTable(header.ItemsOffset, itemRecords);
+    copyTable(header.LookupOffset, lookupRecords);
+    copyTable(header.PoolOffset, pool.GetData());
+
+    // Replace the index in one step as other instances of the game may still have the old index mapped
+    Path::CreateDirectory(Path::GetDirectory(path));
+    auto temporaryPath = path + ".tmp";
+    File::WriteAllBytes(temporaryPath, buffer.data(), buffer.size());
+    if (!File::Move(temporaryPath, path))
+    {
+        // Moving over an existing file is not supported on every platform
+        File::Delete(path);
+        if (!File::Move(temporaryPath, path))
+        {
+            File::Delete(temporaryPath);
+            throw std::runtime_error("Unable to replace '" + path + "'.");
+        }
+    }
+}
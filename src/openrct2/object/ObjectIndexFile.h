@@ -0,0 +1,155 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../ride/Ride.h"
+#include "Object.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MemoryMappedFile;
+struct ObjectRepositoryItem;
+
+/**
+ * The object index as it is stored on disk: fixed-size records for every indexed file and object followed by a pool
+ * for their strings and lists. The file is memory mapped and queried in place, so starting the game does not have to
+ * deserialise, sort and hash every object in the repository. Objects are stored sorted by name, and a table of their
+ * legacy identifiers sorted for binary search is used to find them.
+ */
+class ObjectIndexFile final
+{
+public:
+    static constexpr uint32_t NO_ITEM = UINT32_MAX;
+
+    /**
+     * A file found by scanning the object directories and the object created from it, if any.
+     */
+    struct FileEntry
+    {
+        std::string_view Path;
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
+        const ObjectRepositoryItem* Item = nullptr;
+    };
+
+    struct FileRecord
+    {
+        uint32_t PathOffset;
+        uint32_t PathLength;
+        uint64_t Size;
+        uint64_t LastModified;
+        uint32_t ItemIndex;
+        uint32_t Padding;
+    };
+
+private:
+    struct Header
+    {
+        uint32_t MagicNumber;
+        uint16_t Version;
+        uint16_t Language;
+        uint32_t HeaderSize;
+        uint32_t NumFiles;
+        uint32_t NumItems;
+        uint32_t NumShadowedItems;
+        uint32_t FilesOffset;
+        uint32_t ItemsOffset;
+        uint32_t LookupOffset;
+        uint32_t PoolOffset;
+        uint32_t PoolSize;
+        uint32_t Padding;
+    };
+
+    struct ItemRecord
+    {
+        rct_object_entry ObjectEntry;
+        uint32_t PathOffset;
+        uint32_t PathLength;
+        uint32_t NameOffset;
+        uint32_t NameLength;
+        uint32_t SourcesOffset;
+        uint32_t NumSources;
+        uint32_t SceneryEntriesOffset;
+        uint32_t NumSceneryEntries;
+        uint8_t RideFlags;
+        uint8_t RideCategory[MAX_CATEGORIES_PER_RIDE];
+        uint8_t RideType[MAX_RIDE_TYPES_PER_RIDE_ENTRY];
+        uint8_t Padding[2];
+    };
+
+    struct LookupRecord
+    {
+        char Name[8];
+        uint32_t ItemIndex;
+    };
+
+    std::unique_ptr<MemoryMappedFile> _file;
+    const Header* _header{};
+    const FileRecord* _files{};
+    const ItemRecord* _items{};
+    const LookupRecord* _lookup{};
+    const uint8_t* _pool{};
+
+public:
+    ~ObjectIndexFile();
+
+    /**
+     * Maps the index at the given path. Returns nullptr if there is no index, or if it is invalid or was written for a
+     * different version or language.
+     */
+    static std::unique_ptr<ObjectIndexFile> Open(
+        const std::string& path, uint32_t magicNumber, uint16_t version, int32_t language);
+
+    /**
+     * Writes an index of the given files and their objects. Objects that share a legacy identifier with an earlier object
+     * are kept in the index but can not be found, so that they are available again once the other object is removed.
+     */
+    static void Write(
+        const std::string& path, uint32_t magicNumber, uint16_t version, int32_t language, const std::vector<FileEntry>& files);
+
+    size_t GetNumFiles() const
+    {
+        return _header->NumFiles;
+    }
+
+    /**
+     * Gets the number of objects that can be found, excluding shadowed objects. These are stored first.
+     */
+    size_t GetNumItems() const
+    {
+        return _header->NumItems;
+    }
+
+    /**
+     * Gets the path of the file at the given index. Files are stored in the order they were given to Write.
+     */
+    std::string_view GetFilePath(size_t index) const;
+    const FileRecord& GetFile(size_t index) const;
+
+    /**
+     * Gets the index of the object with the given legacy identifier, or NO_ITEM.
+     */
+    uint32_t FindItem(const rct_object_entry& entry) const;
+
+    /**
+     * Creates the repository item for the object at the given index, which includes shadowed objects.
+     */
+    ObjectRepositoryItem ReadItem(size_t index) const;
+
+private:
+    explicit ObjectIndexFile(std::unique_ptr<MemoryMappedFile> file);
+
+    bool Validate(uint32_t magicNumber, uint16_t version, int32_t language);
+    std::string_view GetString(uint32_t offset, uint32_t length) const;
+};
@@ -15,7 +15,9 @@
 #include "../PlatformEnvironment.h"
 #include "../core/File.h"
 #include "../core/FileScanner.h"
+#include "../core/FileSystem.hpp"
 #include "../core/Memory.hpp"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../core/String.hpp"
 #include "../drawing/ImageImporter.h"
@@ -23,11 +25,15 @@
 #include "../localisation/Language.h"
 #include "../sprites.h"
 #include "Object.h"
+#include "ObjectCache.h"
 #include "ObjectFactory.h"
 
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <optional>
+#include <system_error>
 #include <unordered_map>
 
 using namespace OpenRCT2;
@@ -43,6 +49,9 @@ namespace ObjectJsonHelpers
         rct_g1_element g1{};
         std::unique_ptr<RequiredImage> next_zoom;
 
+        // The object cache entry g1.offset points into, if the image was read from the cache rather than owning its data
+        std::shared_ptr<const ObjectCache::Entry> cache_entry;
+
         bool HasData() const
         {
             return g1.offset != nullptr;
@@ -60,6 +69,13 @@ namespace ObjectJsonHelpers
             g1.flags &= ~G1_FLAG_HAS_ZOOM_SPRITE;
         }
 
+        RequiredImage(const rct_g1_element& orig, std::shared_ptr<const ObjectCache::Entry> cacheEntry, const uint8_t* data)
+            : cache_entry(std::move(cacheEntry))
+        {
+            g1 = orig;
+            g1.offset = const_cast<uint8_t*>(data);
+        }
+
         RequiredImage(uint32_t idx, std::function<const rct_g1_element*(uint32_t)> getter)
         {
             auto orig = getter(idx);
@@ -84,7 +100,10 @@ namespace ObjectJsonHelpers
 
         ~RequiredImage()
         {
-            delete[] g1.offset;
+            if (cache_entry == nullptr)
+            {
+                delete[] g1.offset;
+            }
         }
     };
 
@@ -308,11 +327,145 @@ namespace ObjectJsonHelpers
         return objectPath;
     }
 
+    /**
+     * Reads images, including their images for the next zoom levels, written by WriteCachedImages from the object cache.
+     * The images point into the mapped cache entry, which is kept until they are added to the image table.
+     */
+    static std::optional<std::vector<std::unique_ptr<RequiredImage>>> ReadCachedImages(uint64_t key)
+    {
+        std::shared_ptr<const ObjectCache::Entry> entry = ObjectCache::Read(key);
+        if (entry == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            MemoryStream stream(entry->GetData(), entry->GetLength());
+            std::vector<std::unique_ptr<RequiredImage>> result(stream.ReadValue<uint32_t>());
+            for (auto& image : result)
+            {
+                auto zoomLevels = stream.ReadValue<uint8_t>();
+                if (zoomLevels == 0)
+                {
+                    image = std::make_unique<RequiredImage>();
+                    continue;
+                }
+
+                auto* next = &image;
+                for (uint8_t i = 0; i < zoomLevels; i++)
+                {
+                    rct_g1_element g1{};
+                    g1.width = stream.ReadValue<int16_t>();
+                    g1.height = stream.ReadValue<int16_t>();
+                    g1.x_offset = stream.ReadValue<int16_t>();
+                    g1.y_offset = stream.ReadValue<int16_t>();
+                    g1.flags = stream.ReadValue<uint16_t>();
+                    g1.zoomed_offset = stream.ReadValue<int32_t>();
+                    auto length = stream.ReadValue<uint32_t>();
+                    if (stream.GetPosition() + length > stream.GetLength())
+                    {
+                        return std::nullopt;
+                    }
+                    auto pixels = static_cast<const uint8_t*>(stream.GetData()) + stream.GetPosition();
+                    *next = std::make_unique<RequiredImage>(g1, entry, pixels);
+                    stream.Seek(length, STREAM_SEEK_CURRENT);
+                    next = &(*next)->next_zoom;
+                }
+            }
+            return result;
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    static void WriteCachedImages(uint64_t key, const std::vector<std::unique_ptr<RequiredImage>>& images)
+    {
+        MemoryStream stream;
+        stream.WriteValue<uint32_t>(static_cast<uint32_t>(images.size()));
+        for (const auto& image : images)
+        {
+            uint8_t zoomLevels = 0;
+            for (auto img = image.get(); img != nullptr && img->HasData(); img = img->next_zoom.get())
+            {
+                zoomLevels++;
+            }
+
+            stream.WriteValue<uint8_t>(zoomLevels);
+            for (auto img = image.get(); img != nullptr && img->HasData(); img = img->next_zoom.get())
+            {
+                const auto& g1 = img->g1;
+                const auto length = g1_calculate_data_size(&g1);
+                stream.WriteValue<int16_t>(g1.width);
+                stream.WriteValue<int16_t>(g1.height);
+                stream.WriteValue<int16_t>(g1.x_offset);
+                stream.WriteValue<int16_t>(g1.y_offset);
+                stream.WriteValue<uint16_t>(g1.flags);
+                stream.WriteValue<int32_t>(g1.zoomed_offset);
+                stream.WriteValue<uint32_t>(static_cast<uint32_t>(length));
+                stream.Write(g1.offset, length);
+            }
+        }
+        ObjectCache::Write(key, stream.GetData(), stream.GetLength());
+    }
+
+    /**
+     * Decodes a PNG image and encodes it as a G1 image, or takes the result from the object cache if the same image
+     * has been imported before.
+     */
+    static std::unique_ptr<RequiredImage> ImportImage(
+        const std::vector<uint8_t>& imageData, ImageImporter::IMPORT_FLAGS flags)
+    {
+        auto key = ObjectCache::Hash(ObjectCache::HASH_SEED, "png");
+        key = ObjectCache::Hash(key, &flags, sizeof(flags));
+        key = ObjectCache::Hash(key, imageData.data(), imageData.size());
+        auto cachedImages = ReadCachedImages(key);
+        if (cachedImages && cachedImages->size() == 1)
+        {
+            return std::move(cachedImages->front());
+        }
+
+        auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
+
+        ImageImporter importer;
+        auto importResult = importer.Import(image, 0, 0, flags);
+
+        std::vector<std::unique_ptr<RequiredImage>> result;
+        result.push_back(std::make_unique<RequiredImage>(importResult.Element));
+        WriteCachedImages(key, result);
+        return std::move(result.front());
+    }
+
     static std::vector<std::unique_ptr<RequiredImage>> LoadObjectImages(
         IReadObjectContext* context, const std::string& name, const std::vector<int32_t>& range)
     {
         std::vector<std::unique_ptr<RequiredImage>> result;
         auto objectPath = FindLegacyObject(name);
+
+        // Decoding the whole legacy object is expensive, so the images taken from it are cached. Like the object index,
+        // the key identifies the object file by its path, size and modification time rather than reading it.
+        std::optional<uint64_t> cacheKey;
+        std::error_code ec;
+        auto objectSize = static_cast<uint64_t>(fs::file_size(objectPath, ec));
+        if (!ec)
+        {
+            auto lastModified = File::GetLastModified(objectPath);
+            auto key = ObjectCache::Hash(ObjectCache::HASH_SEED, "objfile");
+            key = ObjectCache::Hash(key, objectPath);
+            key = ObjectCache::Hash(key, &objectSize, sizeof(objectSize));
+            key = ObjectCache::Hash(key, &lastModified, sizeof(lastModified));
+            key = ObjectCache::Hash(key, range.data(), range.size() * sizeof(int32_t));
+            cacheKey = key;
+
+            auto cachedImages = ReadCachedImages(key);
+            if (cachedImages && cachedImages->size() == range.size())
+            {
+                return std::move(*cachedImages);
+            }
+        }
+
         auto obj = ObjectFactory::CreateObjectFromLegacyFile(context->GetObjectRepository(), objectPath.c_str());
         if (obj != nullptr)
         {
@@ -341,6 +494,10 @@ namespace ObjectJsonHelpers
                 std::string msg = "Adding " + std::to_string(placeHoldersAdded) + " placeholders";
                 context->LogWarning(OBJECT_ERROR_INVALID_PROPERTY, msg.c_str());
             }
+            else if (cacheKey)
+            {
+                WriteCachedImages(*cacheKey, result);
+            }
         }
         else
         {
@@ -408,12 +565,7 @@ namespace ObjectJsonHelpers
             try
             {
                 auto imageData = context->GetData(s);
-                auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
-
-                ImageImporter importer;
-                auto importResult = importer.Import(image, 0, 0, ImageImporter::IMPORT_FLAGS::RLE);
-
-                result.push_back(std::make_unique<RequiredImage>(importResult.Element));
+                result.push_back(ImportImage(imageData, ImageImporter::IMPORT_FLAGS::RLE));
             }
             catch (const std::exception& e)
             {
@@ -441,14 +593,10 @@ namespace ObjectJsonHelpers
                 flags = static_cast<ImageImporter::IMPORT_FLAGS>(flags | ImageImporter::IMPORT_FLAGS::RLE);
             }
             auto imageData = context->GetData(path);
-            auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
-
-            ImageImporter importer;
-            auto importResult = importer.Import(image, 0, 0, flags);
-            auto g1Element = importResult.Element;
-            g1Element.x_offset = x;
-            g1Element.y_offset = y;
-            result.push_back(std::make_unique<RequiredImage>(g1Element));
+            auto image = ImportImage(imageData, flags);
+            image->g1.x_offset = x;
+            image->g1.y_offset = y;
+            result.push_back(std::move(image));
         }
         catch (const std::exception& e)
         {
@@ -495,7 +643,6 @@ namespace ObjectJsonHelpers
                 }
             }
         }
-        stringTable.Sort();
     }
 
     void LoadImages(IReadObjectContext* context, const json_t* root, ImageTable& imageTable)
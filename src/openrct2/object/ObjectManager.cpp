@@ -12,7 +12,12 @@
 #include "../Context.h"
 #include "../ParkImporter.h"
 #include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/FileSystem.hpp"
+#include "../core/JobPool.hpp"
 #include "../core/Memory.hpp"
+#include "../drawing/Drawing.h"
+#include "../localisation/Language.h"
 #include "../localisation/StringIds.h"
 #include "FootpathItemObject.h"
 #include "LargeSceneryObject.h"
@@ -26,17 +31,43 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
 #include <memory>
-#include <mutex>
-#include <thread>
+#include <system_error>
+#include <unordered_map>
 #include <unordered_set>
 
+// Most objects kept loaded after a park no longer uses them, in case the next park needs them again
+constexpr size_t MAX_RETAINED_OBJECTS = 512;
+
+// Most object string ids an object allocates when it is loaded, which a ride object does for its name, description
+// and capacity
+constexpr size_t MAX_OBJECT_STRINGS_PER_OBJECT = 3;
+
 class ObjectManager final : public IObjectManager
 {
 private:
+    struct RetainedObject
+    {
+        std::string Path;
+        // Size and modification time of the file when the object was loaded from it
+        uint64_t Size;
+        uint64_t LastModified;
+        Object* LoadedObject;
+    };
+
     IObjectRepository& _objectRepository;
     std::vector<Object*> _loadedObjects;
     std::array<std::vector<ObjectEntryIndex>, RIDE_TYPE_COUNT> _rideTypeToObjectMap;
+    std::unique_ptr<JobPool> _loadJobs;
+
+    // Objects that were unloaded by switching to another object set, most recently used first. They are still loaded,
+    // including their images, but are not registered with the repository until a later object set uses them again.
+    std::list<RetainedObject> _retainedObjects;
+    std::unordered_map<std::string, std::list<RetainedObject>::iterator> _retainedObjectsByPath;
+    size_t _retainedImageCount = 0;
 
     // Used to return a safe empty vector back from GetAllRideEntries, can be removed when std::span is available
     std::vector<ObjectEntryIndex> _nullRideTypeEntries;
@@ -132,13 +163,19 @@ public:
     }
 
     void LoadObjects(const rct_object_entry* entries, size_t count) override
+    {
+        PreparedObjectMap preparedObjects;
+        LoadPreparedObjects(entries, count, preparedObjects);
+    }
+
+    void LoadPreparedObjects(const rct_object_entry* entries, size_t count, PreparedObjectMap& preparedObjects) override
     {
         // Find all the required objects
         auto requiredObjects = GetRequiredObjects(entries, count);
 
         // Load the required objects
         size_t numNewLoadedObjects = 0;
-        auto loadedObjects = LoadObjects(requiredObjects, &numNewLoadedObjects);
+        auto loadedObjects = LoadObjects(requiredObjects, preparedObjects, &numNewLoadedObjects);
 
         SetNewLoadedObjectList(loadedObjects);
         LoadDefaultObjects();
@@ -181,12 +218,16 @@ public:
         {
             UnloadObject(object);
         }
+        EvictRetainedObjects(0, 0);
         UpdateSceneryGroupIndexes();
         ResetTypeToRideEntryIndexMap();
     }
 
     void ResetObjects() override
     {
+        // Retained objects would otherwise keep what they loaded before the reset
+        EvictRetainedObjects(0, 0);
+
         for (auto loadedObject : _loadedObjects)
         {
             if (loadedObject != nullptr)
@@ -201,13 +242,18 @@ public:
 
     std::vector<const ObjectRepositoryItem*> GetPackableObjects() override
     {
+        // Only look at the loaded objects, enumerating the whole repository would read every item from its index
         std::vector<const ObjectRepositoryItem*> objects;
-        size_t numObjects = _objectRepository.GetNumObjects();
-        for (size_t i = 0; i < numObjects; i++)
+        for (auto loadedObject : _loadedObjects)
         {
-            const ObjectRepositoryItem* item = &_objectRepository.GetObjects()[i];
-            if (item->LoadedObject != nullptr && IsObjectCustom(item) && item->LoadedObject->GetLegacyData() != nullptr
-                && !item->LoadedObject->IsJsonObject())
+            if (loadedObject == nullptr || loadedObject->GetLegacyData() == nullptr || loadedObject->IsJsonObject())
+            {
+                continue;
+            }
+
+            const ObjectRepositoryItem* item = _objectRepository.FindObject(loadedObject->GetObjectEntry());
+            if (item != nullptr && item->LoadedObject == loadedObject && IsObjectCustom(item)
+                && std::find(objects.begin(), objects.end(), item) == objects.end())
             {
                 objects.push_back(item);
             }
@@ -403,7 +449,7 @@ private:
                 totalObjectsLoaded++;
                 if (exceptSet.find(object) == exceptSet.end())
                 {
-                    UnloadObject(object);
+                    RetainObject(object);
                     numObjectsUnloaded++;
                 }
             }
@@ -553,73 +599,137 @@ private:
         return requiredObjects;
     }
 
-    template<typename T, typename TFunc> static void ParallelFor(const std::vector<T>& items, TFunc func)
+    JobPool& GetLoadJobs()
     {
-        auto partitions = std::thread::hardware_concurrency();
-        auto partitionSize = (items.size() + (partitions - 1)) / partitions;
-        std::vector<std::thread> threads;
-        for (size_t n = 0; n < partitions; n++)
+        if (_loadJobs == nullptr)
         {
-            auto begin = n * partitionSize;
-            auto end = std::min(items.size(), begin + partitionSize);
-            threads.emplace_back(
-                [func](size_t pbegin, size_t pend) {
-                    for (size_t i = pbegin; i < pend; i++)
-                    {
-                        func(i);
-                    }
-                },
-                begin, end);
-        }
-        for (auto& t : threads)
-        {
-            t.join();
+            _loadJobs = std::make_unique<JobPool>();
         }
+        return *_loadJobs;
     }
 
-    std::vector<Object*> LoadObjects(std::vector<const ObjectRepositoryItem*>& requiredObjects, size_t* outNewObjectsLoaded)
+    /**
+     * Loads the objects that are not loaded yet as a pipeline. Each object is read and parsed, which includes decoding
+     * its images, on the load job pool, unless it has been prepared already. As soon as an object is ready it is
+     * registered and loaded on this thread, which allocates its image ids, while the pool carries on with the remaining
+     * objects.
+     */
+    std::vector<Object*> LoadObjects(
+        std::vector<const ObjectRepositoryItem*>& requiredObjects, PreparedObjectMap& preparedObjects,
+        size_t* outNewObjectsLoaded)
     {
+        using Clock = std::chrono::high_resolution_clock;
+        auto elapsed = [](Clock::time_point since) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+        };
+
         std::vector<Object*> objects;
         std::vector<Object*> loadedObjects;
+        std::vector<Object*> reusedObjects;
         std::vector<rct_object_entry> badObjects;
         objects.resize(OBJECT_ENTRY_COUNT);
         loadedObjects.reserve(OBJECT_ENTRY_COUNT);
 
-        // Read objects
-        std::mutex commonMutex;
-        ParallelFor(requiredObjects, [this, &commonMutex, requiredObjects, &objects, &badObjects, &loadedObjects](size_t i) {
+        const auto startTime = Clock::now();
+        std::atomic<int64_t> readTime = 0;
+        int64_t loadTime = 0;
+
+        // The same object can be required by several slots, it is only loaded for the first one
+        std::unordered_map<const ObjectRepositoryItem*, size_t> firstSlots;
+        auto& jobs = GetLoadJobs();
+        for (size_t i = 0; i < requiredObjects.size(); i++)
+        {
             auto ori = requiredObjects[i];
-            Object* loadedObject = nullptr;
-            if (ori != nullptr)
+            if (ori == nullptr || !firstSlots.emplace(ori, i).second)
             {
-                loadedObject = ori->LoadedObject;
-                if (loadedObject == nullptr)
-                {
-                    loadedObject = _objectRepository.LoadObject(ori);
+                continue;
+            }
+
+            if (ori->LoadedObject != nullptr)
+            {
+                objects[i] = ori->LoadedObject;
+                continue;
+            }
+
+            auto retainedObject = TakeRetainedObject(ori);
+            if (retainedObject != nullptr)
+            {
+                _objectRepository.RegisterLoadedObject(ori, retainedObject);
+                reusedObjects.push_back(retainedObject);
+                objects[i] = retainedObject;
+                continue;
+            }
+
+            auto preparedObject = preparedObjects.find(ori->ObjectEntry);
+            if (preparedObject != preparedObjects.end())
+            {
+                objects[i] = preparedObject->second.release();
+                preparedObjects.erase(preparedObject);
+            }
+
+            // The tasks refer to locals of this call, so no exception may leave them. Otherwise Join would be left with
+            // queued tasks, which the next call would run after these locals are gone.
+            jobs.AddTask(
+                [this, ori, i, &objects, &readTime, &elapsed]() {
+                    if (objects[i] != nullptr)
+                    {
+                        return;
+                    }
+                    const auto readStartTime = Clock::now();
+                    try
+                    {
+                        objects[i] = _objectRepository.LoadObject(ori);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        log_error("Unable to read object '%s': %s", ori->Path.c_str(), e.what());
+                    }
+                    readTime += elapsed(readStartTime);
+                },
+                [this, ori, i, &objects, &badObjects, &loadedObjects, &loadTime, &elapsed]() {
+                    auto loadedObject = objects[i];
                     if (loadedObject == nullptr)
                     {
-                        std::lock_guard<std::mutex> guard(commonMutex);
                         badObjects.push_back(ori->ObjectEntry);
                         ReportObjectLoadProblem(&ori->ObjectEntry);
+                        return;
                     }
-                    else
+
+                    const auto loadStartTime = Clock::now();
+                    // Connect the ori to the registered object, it is unloaded with the other new objects if it fails
+                    _objectRepository.RegisterLoadedObject(ori, loadedObject);
+                    loadedObjects.push_back(loadedObject);
+                    try
                     {
-                        std::lock_guard<std::mutex> guard(commonMutex);
-                        loadedObjects.push_back(loadedObject);
-                        // Connect the ori to the registered object
-                        _objectRepository.RegisterLoadedObject(ori, loadedObject);
+                        ReserveObjectStrings();
+                        ReserveObjectImages(loadedObject->GetNumImages());
+                        loadedObject->Load();
                     }
-                }
-            }
-            objects[i] = loadedObject;
-        });
+                    catch (const std::exception& e)
+                    {
+                        log_error("Unable to load object '%s': %s", ori->Path.c_str(), e.what());
+                        badObjects.push_back(ori->ObjectEntry);
+                        ReportObjectLoadProblem(&ori->ObjectEntry);
+                    }
+                    loadTime += elapsed(loadStartTime);
+                });
+        }
+        jobs.Join();
 
-        // Load objects
-        for (auto obj : loadedObjects)
+        for (size_t i = 0; i < requiredObjects.size(); i++)
         {
-            obj->Load();
+            auto ori = requiredObjects[i];
+            if (ori != nullptr)
+            {
+                objects[i] = objects[firstSlots[ori]];
+            }
         }
 
+        log_verbose(
+            "Loaded %zu objects in %.2f ms: reading and parsing %.2f ms (over all threads), loading %.2f ms, %zu reused",
+            loadedObjects.size(), elapsed(startTime) / 1000.0, readTime / 1000.0, loadTime / 1000.0,
+            reusedObjects.size());
+
         if (!badObjects.empty())
         {
             // Unload all the new objects we loaded
@@ -627,6 +737,10 @@ private:
             {
                 UnloadObject(object);
             }
+            for (auto object : reusedObjects)
+            {
+                RetainObject(object);
+            }
             throw ObjectLoadException(std::move(badObjects));
         }
 
@@ -637,15 +751,131 @@ private:
         return objects;
     }
 
+    /**
+     * Unregisters an object that is no longer part of the loaded object set and keeps it loaded so that a later
+     * object set can use it again without loading it from its file.
+     */
+    void RetainObject(Object* object)
+    {
+        const ObjectRepositoryItem* ori = _objectRepository.FindObject(object->GetObjectEntry());
+        if (ori == nullptr || ori->LoadedObject != object || _retainedObjectsByPath.count(ori->Path) != 0)
+        {
+            UnloadObject(object);
+            return;
+        }
+
+        _objectRepository.UnregisterLoadedObject(ori, object);
+        for (auto& obj : _loadedObjects)
+        {
+            if (obj == object)
+            {
+                obj = nullptr;
+            }
+        }
+
+        _retainedObjects.push_front({ ori->Path, GetFileSize(ori->Path), File::GetLastModified(ori->Path), object });
+        _retainedObjectsByPath[ori->Path] = _retainedObjects.begin();
+        _retainedImageCount += object->GetNumImages();
+
+        // Keep most of the image list free for objects that are actually in use
+        EvictRetainedObjects(MAX_RETAINED_OBJECTS, ImageListGetMaximum() / 4);
+    }
+
+    /**
+     * Takes the retained object loaded from the file of the given item, or returns nullptr if there is none or the file
+     * has changed since, in which case the retained object is unloaded.
+     */
+    Object* TakeRetainedObject(const ObjectRepositoryItem* ori)
+    {
+        auto itr = _retainedObjectsByPath.find(ori->Path);
+        if (itr == _retainedObjectsByPath.end())
+        {
+            return nullptr;
+        }
+
+        const auto retainedObject = *itr->second;
+        auto object = retainedObject.LoadedObject;
+        _retainedImageCount -= object->GetNumImages();
+        _retainedObjects.erase(itr->second);
+        _retainedObjectsByPath.erase(itr);
+
+        if (retainedObject.Size != GetFileSize(ori->Path) || retainedObject.LastModified != File::GetLastModified(ori->Path))
+        {
+            object->Unload();
+            delete object;
+            return nullptr;
+        }
+        return object;
+    }
+
+    static uint64_t GetFileSize(const std::string& path)
+    {
+        std::error_code ec;
+        auto size = fs::file_size(fs::u8path(path), ec);
+        return ec ? 0 : static_cast<uint64_t>(size);
+    }
+
+    /**
+     * Unloads the least recently used retained objects until no more than the given number of objects and images are
+     * retained.
+     */
+    void EvictRetainedObjects(size_t maxObjects, size_t maxImages)
+    {
+        while (!_retainedObjects.empty() && (_retainedObjects.size() > maxObjects || _retainedImageCount > maxImages))
+        {
+            auto& retainedObject = _retainedObjects.back();
+            auto object = retainedObject.LoadedObject;
+            _retainedImageCount -= object->GetNumImages();
+            _retainedObjectsByPath.erase(retainedObject.Path);
+            _retainedObjects.pop_back();
+
+            object->Unload();
+            delete object;
+        }
+    }
+
+    /**
+     * Retained objects keep the object string ids they allocated, which come from a fixed pool that is shared with the
+     * loaded objects. Unloads the least recently used retained objects until an object can allocate all of its strings.
+     */
+    void ReserveObjectStrings()
+    {
+        while (!_retainedObjects.empty() && language_get_num_available_object_strings() < MAX_OBJECT_STRINGS_PER_OBJECT)
+        {
+            EvictRetainedObjects(_retainedObjects.size() - 1, SIZE_MAX);
+        }
+    }
+
+    /**
+     * Retained objects also keep their image ids. Unloads the least recently used retained objects until the given
+     * number of images fits in a single free range of the image list.
+     */
+    void ReserveObjectImages(size_t numImages)
+    {
+        while (!_retainedObjects.empty() && ImageListGetLargestFreeRange() < numImages)
+        {
+            EvictRetainedObjects(_retainedObjects.size() - 1, SIZE_MAX);
+        }
+    }
+
     Object* GetOrLoadObject(const ObjectRepositoryItem* ori)
     {
         Object* loadedObject = ori->LoadedObject;
         if (loadedObject == nullptr)
         {
+            loadedObject = TakeRetainedObject(ori);
+            if (loadedObject != nullptr)
+            {
+                _objectRepository.RegisterLoadedObject(ori, loadedObject);
+                return loadedObject;
+            }
+
             // Try to load object
             loadedObject = _objectRepository.LoadObject(ori);
             if (loadedObject != nullptr)
             {
+                ReserveObjectStrings();
+                ReserveObjectImages(loadedObject->GetNumImages());
                 loadedObject->Load();
 
                 // Connect the ori to the registered object
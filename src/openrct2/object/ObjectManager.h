@@ -12,12 +12,20 @@
 #include "../common.h"
 #include "../object/Object.h"
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 interface IObjectRepository;
 class Object;
 struct ObjectRepositoryItem;
 
+/**
+ * Objects that have been read from their files but not loaded yet, by the legacy identifier of the repository item they
+ * were read for. Repository items can move when objects are added to the repository, so they are not used as keys.
+ */
+using PreparedObjectMap = std::unordered_map<rct_object_entry, std::unique_ptr<Object>, ObjectEntryHash, ObjectEntryEqual>;
+
 interface IObjectManager
 {
     virtual ~IObjectManager()
@@ -32,6 +40,13 @@ interface IObjectManager
 
     virtual Object* LoadObject(const rct_object_entry* entry) abstract;
     virtual void LoadObjects(const rct_object_entry* entries, size_t count) abstract;
+
+    /**
+     * Loads the given objects like LoadObjects, but takes any of them that are in preparedObjects instead of reading
+     * them again. Prepared objects that are not needed, because they are loaded already, are left in the map.
+     */
+    virtual void LoadPreparedObjects(const rct_object_entry* entries, size_t count, PreparedObjectMap& preparedObjects)
+        abstract;
     virtual void LoadDefaultObjects() abstract;
     virtual void UnloadObjects(const std::vector<rct_object_entry>& entries) abstract;
     virtual void UnloadAll() abstract;
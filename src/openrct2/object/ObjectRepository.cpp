@@ -10,6 +10,7 @@
 #include "ObjectRepository.h"
 
 #include "../Context.h"
+#include "../OpenRCT2.h"
 #include "../PlatformEnvironment.h"
 #include "../common.h"
 #include "../config/Config.h"
@@ -33,12 +34,14 @@
 #include "../util/Util.h"
 #include "Object.h"
 #include "ObjectFactory.h"
+#include "ObjectIndexFile.h"
 #include "ObjectList.h"
 #include "ObjectManager.h"
 #include "RideObject.h"
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -47,34 +50,13 @@
 
 using namespace OpenRCT2;
 
-struct ObjectEntryHash
-{
-    size_t operator()(const rct_object_entry& entry) const
-    {
-        uint32_t hash = 5381;
-        for (auto i : entry.name)
-        {
-            hash = ((hash << 5) + hash) + i;
-        }
-        return hash;
-    }
-};
-
-struct ObjectEntryEqual
-{
-    bool operator()(const rct_object_entry& lhs, const rct_object_entry& rhs) const
-    {
-        return memcmp(&lhs.name, &rhs.name, 8) == 0;
-    }
-};
-
 using ObjectEntryMap = std::unordered_map<rct_object_entry, size_t, ObjectEntryHash, ObjectEntryEqual>;
 
 class ObjectFileIndex final : public FileIndex<ObjectRepositoryItem>
 {
 private:
     static constexpr uint32_t MAGIC_NUMBER = 0x5844494F; // OIDX
-    static constexpr uint16_t VERSION = 20;
+    static constexpr uint16_t VERSION = 21;
     static constexpr auto PATTERN = "*.dat;*.pob;*.json;*.parkobj";
 
     IObjectRepository& _objectRepository;
@@ -94,15 +76,17 @@ public:
 public:
     std::tuple<bool, ObjectRepositoryItem> Create([[maybe_unused]] int32_t language, const std::string& path) const override
     {
+        // The index only needs the metadata of each object, so skip loading images. This also keeps the scan independent
+        // of the base graphics, which objects can reference images from, so both can be loaded at the same time.
         Object* object = nullptr;
         auto extension = Path::GetExtension(path);
         if (String::Equals(extension, ".json", true))
         {
-            object = ObjectFactory::CreateObjectFromJsonFile(_objectRepository, path);
+            object = ObjectFactory::CreateObjectFromJsonFile(_objectRepository, path, false);
         }
         else if (String::Equals(extension, ".parkobj", true))
         {
-            object = ObjectFactory::CreateObjectFromZipFile(_objectRepository, path);
+            object = ObjectFactory::CreateObjectFromZipFile(_objectRepository, path, false);
         }
         else
         {
@@ -122,81 +106,86 @@ public:
         return std::make_tuple(false, ObjectRepositoryItem());
     }
 
-protected:
-    void Serialise(IStream* stream, const ObjectRepositoryItem& item) const override
+    /**
+     * Maps the index if it exists and is up to date with the object files on disk, otherwise returns nullptr. The index
+     * stores the files in the order they were scanned, so it is compared file by file with a new scan.
+     */
+    std::unique_ptr<ObjectIndexFile> OpenIfUpToDate(int32_t language) const
     {
-        stream->WriteValue(item.ObjectEntry);
-        stream->WriteString(item.Path);
-        stream->WriteString(item.Name);
-        uint8_t sourceLength = static_cast<uint8_t>(item.Sources.size());
-        stream->WriteValue(sourceLength);
-        for (auto source : item.Sources)
-        {
-            stream->WriteValue(source);
-        }
-
-        switch (item.ObjectEntry.GetType())
+        auto index = Open(language);
+        if (index != nullptr)
         {
-            case OBJECT_TYPE_RIDE:
-                stream->WriteValue<uint8_t>(item.RideInfo.RideFlags);
-                for (int32_t i = 0; i < MAX_CATEGORIES_PER_RIDE; i++)
-                {
-                    stream->WriteValue<uint8_t>(item.RideInfo.RideCategory[i]);
-                }
-                for (int32_t i = 0; i < MAX_RIDE_TYPES_PER_RIDE_ENTRY; i++)
-                {
-                    stream->WriteValue<uint8_t>(item.RideInfo.RideType[i]);
-                }
-                break;
-            case OBJECT_TYPE_SCENERY_GROUP:
-                stream->WriteValue<uint16_t>(static_cast<uint16_t>(item.SceneryGroupInfo.Entries.size()));
-                for (const auto& entry : item.SceneryGroupInfo.Entries)
+            auto files = Scan();
+            if (files.size() != index->GetNumFiles())
+            {
+                return nullptr;
+            }
+            for (size_t i = 0; i < files.size(); i++)
+            {
+                const auto& record = index->GetFile(i);
+                if (record.Size != files[i].Size || record.LastModified != files[i].LastModified
+                    || index->GetFilePath(i) != files[i].Path)
                 {
-                    stream->WriteValue<rct_object_entry>(entry);
+                    return nullptr;
                 }
-                break;
+            }
         }
+        return index;
     }
 
-    ObjectRepositoryItem Deserialise(IStream* stream) const override
+    std::unique_ptr<ObjectIndexFile> Open(int32_t language) const
     {
-        ObjectRepositoryItem item;
+        return ObjectIndexFile::Open(_indexPath, _magicNumber, _version, language);
+    }
 
-        item.ObjectEntry = stream->ReadValue<rct_object_entry>();
-        item.Path = stream->ReadStdString();
-        item.Name = stream->ReadStdString();
-        auto sourceLength = stream->ReadValue<uint8_t>();
-        for (size_t i = 0; i < sourceLength; i++)
+protected:
+    std::optional<FileRecordMap> ReadIndexFile(int32_t language) const override
+    {
+        auto index = Open(language);
+        if (index == nullptr)
         {
-            auto value = stream->ReadValue<uint8_t>();
-            item.Sources.push_back(value);
+            return std::nullopt;
         }
 
-        switch (item.ObjectEntry.GetType())
+        FileRecordMap records;
+        records.reserve(index->GetNumFiles());
+        for (size_t i = 0; i < index->GetNumFiles(); i++)
         {
-            case OBJECT_TYPE_RIDE:
-                item.RideInfo.RideFlags = stream->ReadValue<uint8_t>();
-                for (int32_t i = 0; i < MAX_CATEGORIES_PER_RIDE; i++)
-                {
-                    item.RideInfo.RideCategory[i] = stream->ReadValue<uint8_t>();
-                }
-                for (int32_t i = 0; i < MAX_RIDE_TYPES_PER_RIDE_ENTRY; i++)
-                {
-                    item.RideInfo.RideType[i] = stream->ReadValue<uint8_t>();
-                }
-                break;
-            case OBJECT_TYPE_SCENERY_GROUP:
+            const auto& file = index->GetFile(i);
+            FileRecord record;
+            record.Size = file.Size;
+            record.LastModified = file.LastModified;
+            if (file.ItemIndex != ObjectIndexFile::NO_ITEM)
             {
-                auto numEntries = stream->ReadValue<uint16_t>();
-                item.SceneryGroupInfo.Entries = std::vector<rct_object_entry>(numEntries);
-                for (size_t i = 0; i < numEntries; i++)
-                {
-                    item.SceneryGroupInfo.Entries[i] = stream->ReadValue<rct_object_entry>();
-                }
-                break;
+                record.Item = index->ReadItem(file.ItemIndex);
             }
+            records.emplace(index->GetFilePath(i), std::move(record));
+        }
+        return records;
+    }
+
+    bool WriteIndexFile(
+        int32_t language, const std::vector<ScannedFile>& files, const std::vector<FileRecord>& records) const override
+    {
+        try
+        {
+            log_verbose("FileIndex:Writing index: '%s'", _indexPath.c_str());
+            std::vector<ObjectIndexFile::FileEntry> entries;
+            entries.reserve(files.size());
+            for (size_t i = 0; i < files.size(); i++)
+            {
+                const auto& item = records[i].Item;
+                entries.push_back({ files[i].Path, files[i].Size, files[i].LastModified, item ? &*item : nullptr });
+            }
+            ObjectIndexFile::Write(_indexPath, _magicNumber, _version, language, entries);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("Unable to save index: '%s'.", _indexPath.c_str());
+            Console::Error::WriteLine("%s", e.what());
+            return false;
         }
-        return item;
     }
 
 private:
@@ -210,7 +199,13 @@ class ObjectRepository final : public IObjectRepository
 {
     std::shared_ptr<IPlatformEnvironment> const _env;
     ObjectFileIndex const _fileIndex;
-    std::vector<ObjectRepositoryItem> _items;
+
+    // Items of the mapped index are only read into _items when they are first needed. Items that are not in the index,
+    // or all items if the index could not be written, are found through _itemMap instead.
+    std::unique_ptr<ObjectIndexFile> _index;
+    mutable std::vector<ObjectRepositoryItem> _items;
+    mutable std::vector<bool> _itemsRead;
+    mutable std::mutex _itemsMutex;
     ObjectEntryMap _itemMap;
 
 public:
@@ -228,16 +223,25 @@ public:
     void LoadOrConstruct(int32_t language) override
     {
         ClearItems();
-        auto items = _fileIndex.LoadOrBuild(language);
-        AddItems(items);
-        SortItems();
+        auto index = _fileIndex.OpenIfUpToDate(language);
+        if (index != nullptr)
+        {
+            SetIndex(std::move(index));
+        }
+        else
+        {
+            bool indexUpToDate = false;
+            auto items = _fileIndex.LoadOrBuild(language, &indexUpToDate);
+            SetIndexOrItems(indexUpToDate ? _fileIndex.Open(language) : nullptr, items);
+        }
     }
 
     void Construct(int32_t language) override
     {
-        auto items = _fileIndex.Rebuild(language);
-        AddItems(items);
-        SortItems();
+        ClearItems();
+        bool indexUpToDate = false;
+        auto items = _fileIndex.Rebuild(language, &indexUpToDate);
+        SetIndexOrItems(indexUpToDate ? _fileIndex.Open(language) : nullptr, items);
     }
 
     size_t GetNumObjects() const override
@@ -247,6 +251,11 @@ public:
 
     const ObjectRepositoryItem* GetObjects() const override
     {
+        std::lock_guard<std::mutex> lock(_itemsMutex);
+        for (size_t i = 0; i < _itemsRead.size(); i++)
+        {
+            ReadItem(i);
+        }
         return _items.data();
     }
 
@@ -254,17 +263,21 @@ public:
     {
         rct_object_entry entry = {};
         entry.SetName(legacyIdentifier);
-
-        auto kvp = _itemMap.find(entry);
-        if (kvp != _itemMap.end())
-        {
-            return &_items[kvp->second];
-        }
-        return nullptr;
+        return FindObject(&entry);
     }
 
     const ObjectRepositoryItem* FindObject(const rct_object_entry* objectEntry) const override final
     {
+        std::lock_guard<std::mutex> lock(_itemsMutex);
+        if (_index != nullptr)
+        {
+            auto index = _index->FindItem(*objectEntry);
+            if (index != ObjectIndexFile::NO_ITEM)
+            {
+                return ReadItem(index);
+            }
+        }
+
         auto kvp = _itemMap.find(*objectEntry);
         if (kvp != _itemMap.end())
         {
@@ -280,11 +293,11 @@ public:
         auto extension = Path::GetExtension(ori->Path);
         if (String::Equals(extension, ".json", true))
         {
-            return ObjectFactory::CreateObjectFromJsonFile(*this, ori->Path);
+            return ObjectFactory::CreateObjectFromJsonFile(*this, ori->Path, !gOpenRCT2NoGraphics);
         }
         else if (String::Equals(extension, ".parkobj", true))
         {
-            return ObjectFactory::CreateObjectFromZipFile(*this, ori->Path);
+            return ObjectFactory::CreateObjectFromZipFile(*this, ori->Path, !gOpenRCT2NoGraphics);
         }
         else
         {
@@ -392,7 +405,46 @@ private:
     void ClearItems()
     {
         _items.clear();
+        _itemsRead.clear();
         _itemMap.clear();
+        _index = nullptr;
+    }
+
+    void SetIndex(std::unique_ptr<ObjectIndexFile> index)
+    {
+        _index = std::move(index);
+        _items.resize(_index->GetNumItems());
+        _itemsRead.assign(_items.size(), false);
+    }
+
+    /**
+     * Uses the given index, or the given items if the index could not be written.
+     */
+    void SetIndexOrItems(std::unique_ptr<ObjectIndexFile> index, const std::vector<ObjectRepositoryItem>& items)
+    {
+        if (index != nullptr)
+        {
+            SetIndex(std::move(index));
+        }
+        else
+        {
+            AddItems(items);
+            SortItems();
+        }
+    }
+
+    /**
+     * Gets the item at the given index, reading it from the mapped index if it has not been read yet. The items mutex
+     * must be held.
+     */
+    const ObjectRepositoryItem* ReadItem(size_t index) const
+    {
+        if (!_itemsRead[index])
+        {
+            _items[index] = _index->ReadItem(index);
+            _itemsRead[index] = true;
+        }
+        return &_items[index];
     }
 
     void SortItems()
@@ -408,6 +460,7 @@ private:
         }
 
         // Rebuild item map
+        _itemsRead.assign(_items.size(), true);
         _itemMap.clear();
         for (size_t i = 0; i < _items.size(); i++)
         {
@@ -437,10 +490,12 @@ private:
         auto conflict = FindObject(&item.ObjectEntry);
         if (conflict == nullptr)
         {
+            std::lock_guard<std::mutex> lock(_itemsMutex);
             size_t index = _items.size();
             auto copy = item;
             copy.Id = index;
             _items.push_back(copy);
+            _itemsRead.push_back(true);
             _itemMap[item.ObjectEntry] = index;
             return true;
         }
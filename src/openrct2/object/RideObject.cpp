@@ -187,7 +187,6 @@ void RideObject::Load()
 {
     _legacyType.obj = this;
 
-    GetStringTable().Sort();
     _legacyType.naming.Name = language_allocate_object_string(GetName());
     _legacyType.naming.Description = language_allocate_object_string(GetDescription());
     _legacyType.capacity = language_allocate_object_string(GetCapacity());
@@ -43,7 +43,6 @@ void SceneryGroupObject::ReadLegacy(IReadObjectContext* context, IStream* stream
 
 void SceneryGroupObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.name = language_allocate_object_string(GetName());
     _legacyType.image = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
     _legacyType.entry_count = 0;
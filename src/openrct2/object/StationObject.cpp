@@ -18,7 +18,6 @@
 
 void StationObject::Load()
 {
-    GetStringTable().Sort();
     NameStringId = language_allocate_object_string(GetName());
 
     auto numImages = GetImageTable().GetCount();
@@ -16,7 +16,7 @@
 #include "../localisation/LocalisationService.h"
 #include "Object.h"
 
-#include <algorithm>
+#include <optional>
 
 static constexpr const uint8_t RCT2ToOpenRCT2LanguageId[] = {
     LANGUAGE_ENGLISH_UK,
@@ -57,16 +57,11 @@ void StringTable::Read(IReadObjectContext* context, IStream* stream, uint8_t id)
             uint8_t languageId = (rct2LanguageId <= RCT2_LANGUAGE_ID_PORTUGUESE) ? RCT2ToOpenRCT2LanguageId[rct2LanguageId]
                                                                                  : static_cast<uint8_t>(LANGUAGE_UNDEFINED);
             std::string stringAsWin1252 = stream->ReadStdString();
-            auto stringAsUtf8 = rct2_to_utf8(stringAsWin1252, rct2LanguageId);
 
-            if (!StringIsBlank(stringAsUtf8.data()))
+            // Spaces and tabs are the same in every RCT2 encoding, so blank strings can be skipped without converting them
+            if (!StringIsBlank(stringAsWin1252.c_str()))
             {
-                stringAsUtf8 = String::Trim(stringAsUtf8);
-                StringTableEntry entry{};
-                entry.Id = id;
-                entry.LanguageId = languageId;
-                entry.Text = stringAsUtf8;
-                _strings.push_back(entry);
+                AddString(id, languageId, rct2LanguageId, stringAsWin1252);
             }
         }
     }
@@ -75,73 +70,115 @@ void StringTable::Read(IReadObjectContext* context, IStream* stream, uint8_t id)
         context->LogError(OBJECT_ERROR_BAD_STRING_TABLE, "Bad string table.");
         throw;
     }
-    Sort();
 }
 
 std::string StringTable::GetString(uint8_t id) const
 {
-    for (auto& string : _strings)
+    // Prefer the current language, then English (UK), then the language with the lowest id
+    auto targetLanguage = LocalisationService_GetCurrentLanguage();
+    auto getPriority = [targetLanguage](uint8_t languageId) -> int32_t {
+        if (languageId == targetLanguage)
+        {
+            return -2;
+        }
+        if (languageId == LANGUAGE_ENGLISH_UK)
+        {
+            return -1;
+        }
+        return languageId;
+    };
+
+    std::optional<size_t> best;
+    for (size_t i = 0; i < _strings.size(); i++)
     {
-        if (string.Id == id)
+        if (_strings[i].Id != id)
         {
-            return string.Text;
+            continue;
+        }
+
+        if (best.has_value())
+        {
+            auto priority = getPriority(_strings[i].LanguageId);
+            auto bestPriority = getPriority(_strings[*best].LanguageId);
+            if (priority > bestPriority)
+            {
+                continue;
+            }
+            if (priority == bestPriority)
+            {
+                // Several strings for the same language, pick the first alphabetically
+                auto text = GetConvertedString(i);
+                if (String::Compare(text, GetConvertedString(*best), true) >= 0)
+                {
+                    continue;
+                }
+            }
         }
+        best = i;
     }
-    return std::string();
+    return best.has_value() ? GetConvertedString(*best) : std::string();
 }
 
 std::string StringTable::GetString(uint8_t language, uint8_t id) const
 {
-    for (auto& string : _strings)
+    for (size_t i = 0; i < _strings.size(); i++)
     {
-        if (string.LanguageId == language && string.Id == id)
+        if (_strings[i].LanguageId == language && _strings[i].Id == id)
         {
-            return string.Text;
+            return GetConvertedString(i);
         }
     }
     return std::string();
 }
 
 void StringTable::SetString(uint8_t id, uint8_t language, const std::string& text)
+{
+    AddString(id, language, RCT2_LANGUAGE_ID_END, text);
+}
+
+size_t StringTable::GetMemoryUsage() const
+{
+    size_t result = _data.capacity() + (_strings.capacity() * sizeof(StringTableEntry))
+        + (_cache.capacity() * sizeof(CachedString));
+    for (const auto& cached : _cache)
+    {
+        result += cached.Text.capacity();
+    }
+    return result;
+}
+
+void StringTable::AddString(uint8_t id, uint8_t language, uint8_t sourceLanguage, const std::string_view& text)
 {
     StringTableEntry entry;
     entry.Id = id;
     entry.LanguageId = language;
-    entry.Text = text;
+    entry.SourceLanguageId = sourceLanguage;
+    entry.Offset = static_cast<uint32_t>(_data.size());
+    entry.Length = static_cast<uint32_t>(text.size());
+    _data.append(text);
     _strings.push_back(entry);
 }
 
-void StringTable::Sort()
+std::string StringTable::ConvertString(size_t index) const
 {
-    auto targetLanguage = LocalisationService_GetCurrentLanguage();
-    std::sort(_strings.begin(), _strings.end(), [targetLanguage](const StringTableEntry& a, const StringTableEntry& b) -> bool {
-        if (a.Id == b.Id)
-        {
-            if (a.LanguageId == b.LanguageId)
-            {
-                return String::Compare(a.Text, b.Text, true) < 0;
-            }
-
-            if (a.LanguageId == targetLanguage)
-            {
-                return true;
-            }
-            if (b.LanguageId == targetLanguage)
-            {
-                return false;
-            }
-
-            if (a.LanguageId == LANGUAGE_ENGLISH_UK)
-            {
-                return true;
-            }
-            if (b.LanguageId == LANGUAGE_ENGLISH_UK)
-            {
-                return false;
-            }
+    const auto& entry = _strings[index];
+    auto text = std::string_view(_data).substr(entry.Offset, entry.Length);
+    if (entry.SourceLanguageId == RCT2_LANGUAGE_ID_END)
+    {
+        return std::string(text);
+    }
+    return String::Trim(rct2_to_utf8(text, static_cast<RCT2LanguageId>(entry.SourceLanguageId)));
+}
 
-            return a.LanguageId < b.LanguageId;
+const std::string& StringTable::GetConvertedString(size_t index) const
+{
+    for (const auto& cached : _cache)
+    {
+        if (cached.Index == index)
+        {
+            return cached.Text;
         }
-        return a.Id < b.Id;
-    });
+    }
+    _cache.push_back({ index, ConvertString(index) });
+    return _cache.back().Text;
 }
@@ -13,6 +13,7 @@
 #include "../localisation/Language.h"
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 interface IReadObjectContext;
@@ -34,13 +35,29 @@ struct StringTableEntry
 {
     uint8_t Id = OBJ_STRING_ID_UNKNOWN;
     uint8_t LanguageId = LANGUAGE_UNDEFINED;
-    std::string Text;
+    // The encoding of the text as it was read from the object, or RCT2_LANGUAGE_ID_END if it is UTF-8
+    uint8_t SourceLanguageId = RCT2_LANGUAGE_ID_END;
+    uint32_t Offset = 0;
+    uint32_t Length = 0;
 };
 
+/**
+ * The strings of an object in every language it provides. The text is kept as it was read from the object and is only
+ * converted to UTF-8 when a string is first asked for, so languages that are never displayed cost no more than their
+ * source bytes.
+ */
 class StringTable
 {
 private:
+    struct CachedString
+    {
+        size_t Index;
+        std::string Text;
+    };
+
+    std::string _data;
     std::vector<StringTableEntry> _strings;
+    mutable std::vector<CachedString> _cache;
 
 public:
     StringTable() = default;
@@ -48,8 +65,21 @@ public:
     StringTable& operator=(const StringTable&) = delete;
 
     void Read(IReadObjectContext* context, IStream* stream, uint8_t id);
-    void Sort();
+
+    /**
+     * Gets the string in the current language, or in English (UK) or any other language if there is no such string.
+     */
     std::string GetString(uint8_t id) const;
     std::string GetString(uint8_t language, uint8_t id) const;
     void SetString(uint8_t id, uint8_t language, const std::string& text);
+
+    /**
+     * Gets the number of bytes held by the table, including the strings converted so far.
+     */
+    size_t GetMemoryUsage() const;
+
+private:
+    void AddString(uint8_t id, uint8_t language, uint8_t sourceLanguage, const std::string_view& text);
+    std::string ConvertString(size_t index) const;
+    const std::string& GetConvertedString(size_t index) const;
 };
@@ -17,7 +17,6 @@
 
 void TerrainEdgeObject::Load()
 {
-    GetStringTable().Sort();
     NameStringId = language_allocate_object_string(GetName());
     IconImageId = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
 
@@ -20,7 +20,6 @@
 
 void TerrainSurfaceObject::Load()
 {
-    GetStringTable().Sort();
     NameStringId = language_allocate_object_string(GetName());
     IconImageId = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
     if ((Flags & SMOOTH_WITH_SELF) || (Flags & SMOOTH_WITH_OTHER))
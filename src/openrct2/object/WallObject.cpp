@@ -53,7 +53,6 @@ void WallObject::ReadLegacy(IReadObjectContext* context, IStream* stream)
 
 void WallObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.name = language_allocate_object_string(GetName());
     _legacyType.image = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
 }
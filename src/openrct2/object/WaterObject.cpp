@@ -31,7 +31,6 @@ void WaterObject::ReadLegacy(IReadObjectContext* context, IStream* stream)
 
 void WaterObject::Load()
 {
-    GetStringTable().Sort();
     _legacyType.string_idx = language_allocate_object_string(GetName());
     _legacyType.image_id = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
     _legacyType.palette_index_1 = _legacyType.image_id + 1;
@@ -74,7 +74,7 @@ void Painter::Paint(IDrawingEngine& de)
 
     if (gConfigGeneral.show_fps)
     {
-        PaintFPS(dpi);
+        PaintFPS(dpi, de.GetFrameStats());
     }
     gCurrentDrawCount++;
 }
@@ -102,7 +102,7 @@ void Painter::PaintReplayNotice(rct_drawpixelinfo* dpi, const char* text)
     gfx_set_dirty_blocks({ screenCoords, screenCoords + ScreenCoordsXY{ stringWidth, 16 } });
 }
 
-void Painter::PaintFPS(rct_drawpixelinfo* dpi)
+void Painter::PaintFPS(rct_drawpixelinfo* dpi, const DrawingEngineFrameStats* stats)
 {
     ScreenCoordsXY screenCoords(_uiContext->GetWidth() / 2, 2);
 
@@ -125,6 +125,24 @@ void Painter::PaintFPS(rct_drawpixelinfo* dpi)
 
     // Make area dirty so the text doesn't get drawn over the last
     gfx_set_dirty_blocks({ { screenCoords - ScreenCoordsXY{ 16, 4 } }, { gLastDrawStringX + 16, 16 } });
+
+    if (stats != nullptr)
+    {
+        // Break down where the time of the frame went
+        utf8 statsBuffer[128] = { 0 };
+        ch = statsBuffer;
+        ch = utf8_write_codepoint(ch, FORMAT_MEDIUMFONT);
+        ch = utf8_write_codepoint(ch, FORMAT_OUTLINE);
+        ch = utf8_write_codepoint(ch, FORMAT_WHITE);
+        snprintf(
+            ch, sizeof(statsBuffer) - (ch - statsBuffer), "%u/%u blocks, %u rects, %.1f ms viewports, %.1f ms windows",
+            stats->DirtyBlocks, stats->DrawnBlocks, stats->DirtyRects, stats->ViewportTime, stats->WindowTime);
+
+        stringWidth = gfx_get_string_width(statsBuffer);
+        screenCoords = { (_uiContext->GetWidth() - stringWidth) / 2, 16 };
+        gfx_draw_string(dpi, statsBuffer, 0, screenCoords);
+        gfx_set_dirty_blocks({ { screenCoords - ScreenCoordsXY{ 16, 4 } }, { gLastDrawStringX + 16, 30 } });
+    }
 }
 
 void Painter::MeasureFPS()
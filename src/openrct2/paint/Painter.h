@@ -16,6 +16,7 @@
 #include <memory>
 #include <vector>
 
+struct DrawingEngineFrameStats;
 struct rct_drawpixelinfo;
 
 namespace OpenRCT2
@@ -51,7 +52,7 @@ namespace OpenRCT2
 
         private:
             void PaintReplayNotice(rct_drawpixelinfo * dpi, const char* text);
-            void PaintFPS(rct_drawpixelinfo * dpi);
+            void PaintFPS(rct_drawpixelinfo * dpi, const DrawingEngineFrameStats* stats);
             void MeasureFPS();
         };
     } // namespace Paint
@@ -101,23 +101,24 @@ void banner_paint(paint_session* session, uint8_t direction, int32_t height, con
 
     scrollingMode += direction;
 
-    auto ft = Formatter::Common();
+    uint8_t args[32]{};
+    Formatter ft(args);
     banner->FormatTextTo(ft, /*addColour*/ true);
 
+    utf8 bannerString[256];
     if (gConfigGeneral.upper_case_banners)
     {
-        format_string_to_upper(
-            gCommonStringFormatBuffer, sizeof(gCommonStringFormatBuffer), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+        format_string_to_upper(bannerString, sizeof(bannerString), STR_BANNER_TEXT_FORMAT, args);
     }
     else
     {
-        format_string(gCommonStringFormatBuffer, sizeof(gCommonStringFormatBuffer), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+        format_string(bannerString, sizeof(bannerString), STR_BANNER_TEXT_FORMAT, args);
     }
 
     gCurrentFontSpriteBase = FONT_SPRITE_BASE_TINY;
 
-    uint16_t string_width = gfx_get_string_width(gCommonStringFormatBuffer);
+    uint16_t string_width = gfx_get_string_width(bannerString);
     uint16_t scroll = (gCurrentTicks / 2) % string_width;
-    auto scrollIndex = scrolling_text_setup(session, STR_BANNER_TEXT_FORMAT, scroll, scrollingMode, COLOUR_BLACK);
+    auto scrollIndex = scrolling_text_setup(session, STR_BANNER_TEXT_FORMAT, ft, scroll, scrollingMode, COLOUR_BLACK);
     sub_98199C(session, scrollIndex, 0, 0, 1, 1, 0x15, height + 22, boundBoxOffset.x, boundBoxOffset.y, boundBoxOffset.z);
 }
@@ -165,10 +165,8 @@ static void ride_entrance_exit_paint(paint_session* session, uint8_t direction,
     if (!is_exit && !(tile_element->IsGhost()) && tile_element->AsEntrance()->GetRideIndex() != RIDE_ID_NULL
         && stationObj->ScrollingMode != SCROLLING_MODE_NONE)
     {
-        // clear next 8 bytes
-        Formatter::Common().Add<uint32_t>(0).Add<uint32_t>(0);
-
-        auto ft = Formatter::Common();
+        uint8_t args[32]{};
+        Formatter ft(args);
         ft.Add<rct_string_id>(STR_RIDE_ENTRANCE_NAME);
 
         if (ride->status == RIDE_STATUS_OPEN && !(ride->lifecycle_flags & RIDE_LIFECYCLE_BROKEN_DOWN))
@@ -183,11 +181,11 @@ static void ride_entrance_exit_paint(paint_session* session, uint8_t direction,
         utf8 entrance_string[256];
         if (gConfigGeneral.upper_case_banners)
         {
-            format_string_to_upper(entrance_string, sizeof(entrance_string), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+            format_string_to_upper(entrance_string, sizeof(entrance_string), STR_BANNER_TEXT_FORMAT, args);
         }
         else
         {
-            format_string(entrance_string, sizeof(entrance_string), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+            format_string(entrance_string, sizeof(entrance_string), STR_BANNER_TEXT_FORMAT, args);
         }
 
         gCurrentFontSpriteBase = FONT_SPRITE_BASE_TINY;
@@ -196,8 +194,9 @@ static void ride_entrance_exit_paint(paint_session* session, uint8_t direction,
         uint16_t scroll = stringWidth > 0 ? (gCurrentTicks / 2) % stringWidth : 0;
 
         sub_98199C(
-            session, scrolling_text_setup(session, STR_BANNER_TEXT_FORMAT, scroll, stationObj->ScrollingMode, COLOUR_BLACK), 0,
-            0, 0x1C, 0x1C, 0x33, height + stationObj->Height, 2, 2, height + stationObj->Height);
+            session,
+            scrolling_text_setup(session, STR_BANNER_TEXT_FORMAT, ft, scroll, stationObj->ScrollingMode, COLOUR_BLACK), 0, 0,
+            0x1C, 0x1C, 0x33, height + stationObj->Height, 2, 2, height + stationObj->Height);
     }
 
     image_id = entranceImageId;
@@ -273,8 +272,8 @@ static void park_entrance_paint(paint_session* session, uint8_t direction, int32
                 break;
 
             {
-                Formatter::Common().Add<uint32_t>(0).Add<uint32_t>(0);
-                auto ft = Formatter::Common();
+                uint8_t args[32]{};
+                Formatter ft(args);
 
                 if (gParkFlags & PARK_FLAGS_PARK_OPEN)
                 {
@@ -292,11 +291,11 @@ static void park_entrance_paint(paint_session* session, uint8_t direction, int32
                 utf8 park_name[256];
                 if (gConfigGeneral.upper_case_banners)
                 {
-                    format_string_to_upper(park_name, sizeof(park_name), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+                    format_string_to_upper(park_name, sizeof(park_name), STR_BANNER_TEXT_FORMAT, args);
                 }
                 else
                 {
-                    format_string(park_name, sizeof(park_name), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+                    format_string(park_name, sizeof(park_name), STR_BANNER_TEXT_FORMAT, args);
                 }
 
                 gCurrentFontSpriteBase = FONT_SPRITE_BASE_TINY;
@@ -308,7 +307,7 @@ static void park_entrance_paint(paint_session* session, uint8_t direction, int32
                     break;
 
                 int32_t stsetup = scrolling_text_setup(
-                    session, STR_BANNER_TEXT_FORMAT, scroll, entrance->scrolling_mode + direction / 2, COLOUR_BLACK);
+                    session, STR_BANNER_TEXT_FORMAT, ft, scroll, entrance->scrolling_mode + direction / 2, COLOUR_BLACK);
                 int32_t text_height = height + entrance->text_height;
                 sub_98199C(session, stsetup, 0, 0, 0x1C, 0x1C, 0x2F, text_height, 2, 2, text_height);
             }
@@ -429,16 +429,17 @@ void large_scenery_paint(paint_session* session, uint8_t direction, uint16_t hei
     auto banner = tileElement->AsLargeScenery()->GetBanner();
     if (banner != nullptr)
     {
-        auto ft = Formatter::Common();
+        uint8_t args[32]{};
+        Formatter ft(args);
         banner->FormatTextTo(ft);
         utf8 signString[256];
         if (gConfigGeneral.upper_case_banners)
         {
-            format_string_to_upper(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, gCommonFormatArgs);
+            format_string_to_upper(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, args);
         }
         else
         {
-            format_string(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, gCommonFormatArgs);
+            format_string(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, args);
         }
 
         gCurrentFontSpriteBase = FONT_SPRITE_BASE_TINY;
@@ -446,8 +447,8 @@ void large_scenery_paint(paint_session* session, uint8_t direction, uint16_t hei
         uint16_t stringWidth = gfx_get_string_width(signString);
         uint16_t scroll = stringWidth > 0 ? (gCurrentTicks / 2) % stringWidth : 0;
         sub_98199C(
-            session, scrolling_text_setup(session, STR_SCROLLING_SIGN_TEXT, scroll, scrollMode, textColour), 0, 0, 1, 1, 21,
-            height + 25, boxoffset.x, boxoffset.y, boxoffset.z);
+            session, scrolling_text_setup(session, STR_SCROLLING_SIGN_TEXT, ft, scroll, scrollMode, textColour), 0, 0, 1, 1,
+            21, height + 25, boxoffset.x, boxoffset.y, boxoffset.z);
     }
 
     large_scenery_paint_supports(session, direction, height, tileElement, dword_F4387C, tile);
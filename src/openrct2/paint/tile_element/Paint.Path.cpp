@@ -447,11 +447,8 @@ static void sub_6A4101(
             uint16_t scrollingMode = railingEntry->scrolling_mode;
             scrollingMode += direction;
 
-            // This is required due to scrolling_test_setup doing a memcmp of another set
-            // of args and see if it matches these args
-            Formatter::Common().Add<uint32_t>(0).Add<uint32_t>(0);
-
-            auto ft = Formatter::Common();
+            uint8_t args[32]{};
+            Formatter ft(args);
 
             if (ride->status == RIDE_STATUS_OPEN && !(ride->lifecycle_flags & RIDE_LIFECYCLE_BROKEN_DOWN))
             {
@@ -462,25 +459,24 @@ static void sub_6A4101(
             {
                 ft.Add<rct_string_id>(STR_RIDE_ENTRANCE_CLOSED);
             }
+            utf8 bannerString[256];
             if (gConfigGeneral.upper_case_banners)
             {
-                format_string_to_upper(
-                    gCommonStringFormatBuffer, sizeof(gCommonStringFormatBuffer), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+                format_string_to_upper(bannerString, sizeof(bannerString), STR_BANNER_TEXT_FORMAT, args);
             }
             else
             {
-                format_string(
-                    gCommonStringFormatBuffer, sizeof(gCommonStringFormatBuffer), STR_BANNER_TEXT_FORMAT, gCommonFormatArgs);
+                format_string(bannerString, sizeof(bannerString), STR_BANNER_TEXT_FORMAT, args);
             }
 
             gCurrentFontSpriteBase = FONT_SPRITE_BASE_TINY;
 
-            uint16_t stringWidth = gfx_get_string_width(gCommonStringFormatBuffer);
+            uint16_t stringWidth = gfx_get_string_width(bannerString);
             uint16_t scroll = stringWidth > 0 ? (gCurrentTicks / 2) % stringWidth : 0;
 
             sub_98199C(
-                session, scrolling_text_setup(session, STR_BANNER_TEXT_FORMAT, scroll, scrollingMode, COLOUR_BLACK), 0, 0, 1, 1,
-                21, height + 7, boundBoxOffsets.x, boundBoxOffsets.y, boundBoxOffsets.z);
+                session, scrolling_text_setup(session, STR_BANNER_TEXT_FORMAT, ft, scroll, scrollingMode, COLOUR_BLACK), 0, 0,
+                1, 1, 21, height + 7, boundBoxOffsets.x, boundBoxOffsets.y, boundBoxOffsets.z);
         }
 
         session->InteractionType = VIEWPORT_INTERACTION_ITEM_FOOTPATH;
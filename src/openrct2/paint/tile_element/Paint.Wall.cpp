@@ -434,16 +434,17 @@ void fence_paint(paint_session* session, uint8_t direction, int32_t height, cons
     auto banner = tile_element->AsWall()->GetBanner();
     if (banner != nullptr && !banner->IsNull())
     {
-        auto ft = Formatter::Common();
+        uint8_t args[32]{};
+        Formatter ft(args);
         banner->FormatTextTo(ft);
         utf8 signString[256];
         if (gConfigGeneral.upper_case_banners)
         {
-            format_string_to_upper(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, gCommonFormatArgs);
+            format_string_to_upper(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, args);
         }
         else
         {
-            format_string(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, gCommonFormatArgs);
+            format_string(signString, sizeof(signString), STR_SCROLLING_SIGN_TEXT, args);
         }
 
         gCurrentFontSpriteBase = FONT_SPRITE_BASE_TINY;
@@ -452,7 +453,7 @@ void fence_paint(paint_session* session, uint8_t direction, int32_t height, cons
         uint16_t scroll = stringWidth > 0 ? (gCurrentTicks / 2) % stringWidth : 0;
 
         sub_98199C(
-            session, scrolling_text_setup(session, STR_SCROLLING_SIGN_TEXT, scroll, scrollingMode, secondaryColour), 0, 0, 1, 1,
-            13, height + 8, boundsOffset.x, boundsOffset.y, boundsOffset.z);
+            session, scrolling_text_setup(session, STR_SCROLLING_SIGN_TEXT, ft, scroll, scrollingMode, secondaryColour), 0, 0,
+            1, 1, 13, height + 8, boundsOffset.x, boundsOffset.y, boundsOffset.z);
     }
 }
@@ -10,20 +10,25 @@
 #include "SawyerChunkReader.h"
 
 #include "../core/IStream.hpp"
+#include "../core/Memory.hpp"
 
-// malloc is very slow for large allocations in MSVC debug builds as it allocates
-// memory on a special debug heap and then initialises all the memory to 0xCC.
-#if defined(_WIN32) && defined(DEBUG)
-#    define __USE_HEAP_ALLOC__
-#    define WIN32_LEAN_AND_MEAN
-#    include <windows.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    define SAWYER_CHUNK_READER_SSE2
+#    include <emmintrin.h>
 #endif
 
 // Allow chunks to be uncompressed to a maximum of 16 MiB
 constexpr size_t MAX_UNCOMPRESSED_CHUNK_SIZE = 16 * 1024 * 1024;
 
+// A run-length encoding code is followed by at most 128 bytes
+constexpr size_t MAX_RLE_CODE_LENGTH = 129;
+
 constexpr const char* EXCEPTION_MSG_CORRUPT_CHUNK_SIZE = "Corrupt chunk size.";
 constexpr const char* EXCEPTION_MSG_CORRUPT_RLE = "Corrupt RLE compression data.";
+constexpr const char* EXCEPTION_MSG_CORRUPT_REPEAT = "Corrupt repeat compression data.";
 constexpr const char* EXCEPTION_MSG_DESTINATION_TOO_SMALL = "Chunk data larger than allocated destination capacity.";
 constexpr const char* EXCEPTION_MSG_INVALID_CHUNK_ENCODING = "Invalid chunk encoding.";
 constexpr const char* EXCEPTION_MSG_ZERO_SIZED_CHUNK = "Encountered zero-sized chunk.";
@@ -41,294 +46,565 @@ public:
     }
 };
 
-SawyerChunkReader::SawyerChunkReader(IStream* stream)
-    : _stream(stream)
+namespace
 {
-}
-
-void SawyerChunkReader::SkipChunk()
-{
-    uint64_t originalPosition = _stream->GetPosition();
-    try
+    /**
+     * Provides the encoded data of a chunk to the decoders. The data is used in place if the stream is held in memory,
+     * otherwise it is read from the stream a block at a time.
+     */
+    class ChunkSource
     {
-        auto header = _stream->ReadValue<sawyercoding_chunk_header>();
-        _stream->Seek(header.length, STREAM_SEEK_CURRENT);
-    }
-    catch (const std::exception&)
-    {
-        // Rewind stream back to original position
-        _stream->SetPosition(originalPosition);
-        throw;
-    }
-}
+    private:
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
 
-std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunk()
-{
-    uint64_t originalPosition = _stream->GetPosition();
-    try
-    {
-        auto header = _stream->ReadValue<sawyercoding_chunk_header>();
-        if (header.length >= MAX_UNCOMPRESSED_CHUNK_SIZE)
-            throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+        IStream* const _stream;
+        uint64_t _remaining;
+        std::unique_ptr<uint8_t[]> _block;
+        const uint8_t* _position = nullptr;
+        const uint8_t* _end = nullptr;
 
-        switch (header.encoding)
+    public:
+        ChunkSource(IStream* stream, uint64_t length)
+            : _stream(stream)
+            , _remaining(length)
         {
-            case CHUNK_ENCODING_NONE:
-            case CHUNK_ENCODING_RLE:
-            case CHUNK_ENCODING_RLECOMPRESSED:
-            case CHUNK_ENCODING_ROTATE:
+            auto data = static_cast<const uint8_t*>(stream->GetData());
+            if (data != nullptr)
             {
-                std::unique_ptr<uint8_t[]> compressedData(new uint8_t[header.length]);
-                if (_stream->TryRead(compressedData.get(), header.length) != header.length)
+                auto position = stream->GetPosition();
+                if (length > stream->GetLength() - position)
                 {
                     throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
                 }
+                stream->Seek(length, STREAM_SEEK_CURRENT);
+                _position = data + position;
+                _end = _position + length;
+                _remaining = 0;
+            }
+        }
 
-                auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer());
-                size_t uncompressedLength = DecodeChunk(buffer, MAX_UNCOMPRESSED_CHUNK_SIZE, compressedData.get(), header);
-                if (uncompressedLength == 0)
-                {
-                    throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
-                }
-                buffer = static_cast<uint8_t*>(FinaliseLargeTempBuffer(buffer, uncompressedLength));
-                return std::make_shared<SawyerChunk>(static_cast<SAWYER_ENCODING>(header.encoding), buffer, uncompressedLength);
+        bool IsEmpty() const
+        {
+            return _position == _end && _remaining == 0;
+        }
+
+        /**
+         * Gets the data that has not been consumed yet, reading the next block from the stream if there is none. This is
+         * only called when more data is expected, so running out of data means the run-length encoding is corrupt.
+         */
+        const uint8_t* Peek(size_t& available)
+        {
+            if (_position == _end)
+            {
+                ReadBlock();
             }
-            default:
-                throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
+            available = _end - _position;
+            return _position;
         }
-    }
-    catch (const std::exception&)
-    {
-        // Rewind stream back to original position
-        _stream->SetPosition(originalPosition);
-        throw;
-    }
-}
 
-std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunkTrack()
-{
-    uint64_t originalPosition = _stream->GetPosition();
-    try
-    {
-        // Remove 4 as we don't want to touch the checksum at the end of the file
-        int64_t compressedDataLength64 = _stream->GetLength() - _stream->GetPosition() - 4;
-        if (compressedDataLength64 < 0 || compressedDataLength64 > std::numeric_limits<uint32_t>::max())
+        void Skip(size_t count)
         {
-            throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+            _position += count;
         }
-        uint32_t compressedDataLength = compressedDataLength64;
-        auto compressedData = std::make_unique<uint8_t[]>(compressedDataLength);
 
-        if (_stream->TryRead(compressedData.get(), compressedDataLength) != compressedDataLength)
+        uint8_t ReadByte()
         {
-            throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+            if (_position == _end)
+            {
+                ReadBlock();
+            }
+            return *_position++;
         }
 
-        auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer());
-        sawyercoding_chunk_header header{ CHUNK_ENCODING_RLE, compressedDataLength };
-        size_t uncompressedLength = DecodeChunk(buffer, MAX_UNCOMPRESSED_CHUNK_SIZE, compressedData.get(), header);
-        if (uncompressedLength == 0)
+    private:
+        void ReadBlock()
         {
-            throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+            if (_remaining == 0)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
+            }
+
+            auto length = static_cast<size_t>(std::min<uint64_t>(_remaining, BLOCK_SIZE));
+            if (_block == nullptr)
+            {
+                _block.reset(new uint8_t[length]);
+            }
+            if (_stream->TryRead(_block.get(), length) != length)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+            }
+            _remaining -= length;
+            _position = _block.get();
+            _end = _position + length;
         }
-        buffer = static_cast<uint8_t*>(FinaliseLargeTempBuffer(buffer, uncompressedLength));
-        return std::make_shared<SawyerChunk>(SAWYER_ENCODING::RLE, buffer, uncompressedLength);
-    }
-    catch (const std::exception&)
-    {
-        // Rewind stream back to original position
-        _stream->SetPosition(originalPosition);
-        throw;
-    }
-}
+    };
 
-void SawyerChunkReader::ReadChunk(void* dst, size_t length)
-{
-    auto chunk = ReadChunk();
-    auto chunkData = static_cast<const uint8_t*>(chunk->GetData());
-    auto chunkLength = chunk->GetLength();
-    if (chunkLength > length)
-    {
-        std::memcpy(dst, chunkData, length);
-    }
-    else
+    /**
+     * Receives the decoded data of a chunk. A writer either fills a destination of a fixed size, in which case data past
+     * its end is dropped but still counted, or owns a buffer that grows as needed.
+     */
+    class ChunkWriter
     {
-        std::memcpy(dst, chunkData, chunkLength);
-        auto remainingLength = length - chunkLength;
-        if (remainingLength > 0)
+    private:
+        uint8_t* _buffer;
+        size_t _capacity;
+        size_t _length = 0;
+        bool _growable;
+
+    public:
+        ChunkWriter(uint8_t* buffer, size_t capacity)
+            : _buffer(buffer)
+            , _capacity(capacity)
+            , _growable(false)
         {
-            auto offset = static_cast<uint8_t*>(dst) + chunkLength;
-            std::fill_n(offset, remainingLength, 0x00);
         }
-    }
-}
 
-size_t SawyerChunkReader::DecodeChunk(void* dst, size_t dstCapacity, const void* src, const sawyercoding_chunk_header& header)
-{
-    size_t resultLength;
-    switch (header.encoding)
-    {
-        case CHUNK_ENCODING_NONE:
-            if (header.length > dstCapacity)
+        explicit ChunkWriter(size_t initialCapacity)
+            : _buffer(Memory::Allocate<uint8_t>(initialCapacity))
+            , _capacity(initialCapacity)
+            , _growable(true)
+        {
+        }
+
+        ChunkWriter(const ChunkWriter&) = delete;
+        ChunkWriter& operator=(const ChunkWriter&) = delete;
+
+        ~ChunkWriter()
+        {
+            if (_growable)
             {
-                throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
+                Memory::Free(_buffer);
             }
-            std::memcpy(dst, src, header.length);
-            resultLength = header.length;
-            break;
-        case CHUNK_ENCODING_RLE:
-            resultLength = DecodeChunkRLE(dst, dstCapacity, src, header.length);
-            break;
-        case CHUNK_ENCODING_RLECOMPRESSED:
-            resultLength = DecodeChunkRLERepeat(dst, dstCapacity, src, header.length);
-            break;
-        case CHUNK_ENCODING_ROTATE:
-            resultLength = DecodeChunkRotate(dst, dstCapacity, src, header.length);
-            break;
-        default:
-            throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
-    }
-    return resultLength;
-}
+        }
 
-size_t SawyerChunkReader::DecodeChunkRLERepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
-{
-    auto immBuffer = AllocateLargeTempBuffer();
-    auto immLength = DecodeChunkRLE(immBuffer, MAX_UNCOMPRESSED_CHUNK_SIZE, src, srcLength);
-    auto size = DecodeChunkRepeat(dst, dstCapacity, immBuffer, immLength);
-    FreeLargeTempBuffer(immBuffer);
-    return size;
-}
+        size_t GetLength() const
+        {
+            return _length;
+        }
 
-size_t SawyerChunkReader::DecodeChunkRLE(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
-{
-    auto src8 = static_cast<const uint8_t*>(src);
-    auto dst8 = static_cast<uint8_t*>(dst);
-    auto dstEnd = dst8 + dstCapacity;
-    for (size_t i = 0; i < srcLength; i++)
-    {
-        uint8_t rleCodeByte = src8[i];
-        if (rleCodeByte & 128)
+        /**
+         * Takes ownership of a growable buffer, shrunk to the length of the data.
+         */
+        uint8_t* Release()
         {
-            i++;
-            size_t count = 257 - rleCodeByte;
+            auto buffer = Memory::Reallocate(_buffer, _length);
+            _buffer = nullptr;
+            _capacity = 0;
+            return buffer;
+        }
 
-            if (i >= srcLength)
+        void Put(uint8_t value)
+        {
+            if (_length < _capacity || Reserve(1) != 0)
             {
-                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
+                _buffer[_length] = value;
+            }
+            _length++;
+        }
+
+        void Fill(uint8_t value, size_t count)
+        {
+            auto writable = Reserve(count);
+            if (writable != 0)
+            {
+                auto dst = _buffer + _length;
+#ifdef SAWYER_CHUNK_READER_SSE2
+                // Expand the run 16 bytes at a time if there is room to write past its end, whatever is decoded next
+                // overwrites the excess
+                if (writable == count && _capacity - _length - count >= 15)
+                {
+                    auto value128 = _mm_set1_epi8(static_cast<char>(value));
+                    for (size_t i = 0; i < count; i += 16)
+                    {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value128);
+                    }
+                }
+                else
+#endif
+                {
+                    std::memset(dst, value, writable);
+                }
             }
-            if (dst8 + count > dstEnd)
+            _length += count;
+        }
+
+        void Copy(const uint8_t* src, size_t count)
+        {
+            auto writable = Reserve(count);
+            if (writable != 0)
             {
-                throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
+                std::memcpy(_buffer + _length, src, writable);
             }
+            _length += count;
+        }
 
-            std::fill_n(dst8, count, src8[i]);
-            dst8 += count;
+        /**
+         * As Copy, for literal runs of at most 128 bytes where the source can be read up to the next multiple of 16 bytes
+         * past the end of the run.
+         */
+        void CopyLiteral(const uint8_t* src, size_t count)
+        {
+#ifdef SAWYER_CHUNK_READER_SSE2
+            auto writable = Reserve(count);
+            if (writable == count && _capacity - _length - count >= 15)
+            {
+                auto dst = _buffer + _length;
+                for (size_t i = 0; i < count; i += 16)
+                {
+                    auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), data);
+                }
+                _length += count;
+                return;
+            }
+#endif
+            Copy(src, count);
         }
-        else
+
+        /**
+         * Copies count bytes from distance bytes back. The copy may overlap the data it writes, in which case the last
+         * distance bytes are repeated.
+         */
+        void CopyBack(size_t distance, size_t count)
         {
-            if (i + 1 >= srcLength)
+            if (distance > _length)
             {
-                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_REPEAT);
             }
-            if (dst8 + rleCodeByte + 1 > dstEnd)
+
+            // Copies of at most 8 bytes that do not overlap can copy all 8 if there is room to write past their end
+            if (distance >= 8 && count <= 8 && _length < _capacity && _capacity - _length >= 8)
+            {
+                auto dst = _buffer + _length;
+                std::memcpy(dst, dst - distance, 8);
+                _length += count;
+                return;
+            }
+
+            auto writable = Reserve(count);
+            if (writable != 0)
+            {
+                auto dst = _buffer + _length;
+                auto src = dst - distance;
+                for (size_t i = 0; i < writable; i++)
+                {
+                    dst[i] = src[i];
+                }
+            }
+            _length += count;
+        }
+
+    private:
+        /**
+         * Makes room for count more bytes if the buffer is growable and returns how many of them fit in the buffer.
+         */
+        size_t Reserve(size_t count)
+        {
+            if (count > MAX_UNCOMPRESSED_CHUNK_SIZE - _length)
             {
                 throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
             }
-            if (i + 1 + rleCodeByte + 1 > srcLength)
+            if (_growable && _length + count > _capacity)
             {
-                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
+                auto capacity = std::max(_length + count, std::min(_capacity * 2, MAX_UNCOMPRESSED_CHUNK_SIZE));
+                _buffer = Memory::Reallocate(_buffer, capacity);
+                _capacity = capacity;
             }
+            return _length < _capacity ? std::min(count, _capacity - _length) : 0;
+        }
+    };
+
+    /**
+     * Decodes the repeat compression of chunks that are both run-length and repeat encoded, taking the run-length
+     * decoded data as it is produced.
+     */
+    class RepeatDecoder
+    {
+    private:
+        ChunkWriter& _writer;
+        bool _literalNext = false;
 
-            std::memcpy(dst8, src8 + i + 1, rleCodeByte + 1);
-            dst8 += rleCodeByte + 1;
-            i += rleCodeByte + 1;
+    public:
+        explicit RepeatDecoder(ChunkWriter& writer)
+            : _writer(writer)
+        {
         }
-    }
-    return reinterpret_cast<uintptr_t>(dst8) - reinterpret_cast<uintptr_t>(dst);
-}
 
-size_t SawyerChunkReader::DecodeChunkRepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
-{
-    auto src8 = static_cast<const uint8_t*>(src);
-    auto dst8 = static_cast<uint8_t*>(dst);
-    auto dstEnd = dst8 + dstCapacity;
-    for (size_t i = 0; i < srcLength; i++)
+        void Put(uint8_t code)
+        {
+            if (_literalNext)
+            {
+                _writer.Put(code);
+                _literalNext = false;
+            }
+            else if (code == 0xFF)
+            {
+                _literalNext = true;
+            }
+            else
+            {
+                // Repeat 1 to 8 bytes from at most 32 bytes back
+                _writer.CopyBack(32 - (code >> 3), (code & 7) + 1);
+            }
+        }
+
+        void Fill(uint8_t code, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Put(code);
+            }
+        }
+
+        void Copy(const uint8_t* src, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Put(src[i]);
+            }
+        }
+
+        void CopyLiteral(const uint8_t* src, size_t count)
+        {
+            Copy(src, count);
+        }
+
+        void Finish()
+        {
+            if (_literalNext)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_REPEAT);
+            }
+        }
+    };
+
+    template<typename TWriter> void DecodeRLECode(ChunkSource& source, TWriter& writer)
     {
-        if (src8[i] == 0xFF)
+        uint8_t code = source.ReadByte();
+        if (code & 0x80)
         {
-            *dst8++ = src8[++i];
+            writer.Fill(source.ReadByte(), 257 - code);
         }
         else
         {
-            size_t count = (src8[i] & 7) + 1;
-            const uint8_t* copySrc = dst8 + static_cast<int32_t>(src8[i] >> 3) - 32;
+            // The literal run may continue in the next block
+            size_t remaining = code + 1;
+            while (remaining != 0)
+            {
+                size_t available;
+                auto data = source.Peek(available);
+                auto count = std::min(available, remaining);
+                writer.Copy(data, count);
+                source.Skip(count);
+                remaining -= count;
+            }
+        }
+    }
+
+    template<typename TWriter> void DecodeRLE(ChunkSource& source, TWriter& writer)
+    {
+        while (!source.IsEmpty())
+        {
+            size_t available;
+            auto begin = source.Peek(available);
+            auto data = begin;
 
-            if (dst8 + count >= dstEnd || copySrc + count >= dstEnd)
+            // Codes that are known to end within the block do not need to check for its end
+            if (available >= MAX_RLE_CODE_LENGTH)
             {
-                throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
+                auto last = begin + available - MAX_RLE_CODE_LENGTH;
+                while (data <= last)
+                {
+                    uint8_t code = *data++;
+                    if (code & 0x80)
+                    {
+                        writer.Fill(*data++, 257 - code);
+                    }
+                    else
+                    {
+                        writer.CopyLiteral(data, code + 1);
+                        data += code + 1;
+                    }
+                }
+                source.Skip(data - begin);
+            }
+
+            if (!source.IsEmpty())
+            {
+                DecodeRLECode(source, writer);
             }
+        }
+    }
+
+    void DecodeNone(ChunkSource& source, ChunkWriter& writer)
+    {
+        while (!source.IsEmpty())
+        {
+            size_t available;
+            auto data = source.Peek(available);
+            writer.Copy(data, available);
+            source.Skip(available);
+        }
+    }
 
-            std::memcpy(dst8, copySrc, count);
-            dst8 += count;
+    void DecodeRotate(ChunkSource& source, ChunkWriter& writer)
+    {
+        uint8_t buffer[1024];
+        uint8_t code = 1;
+        while (!source.IsEmpty())
+        {
+            size_t available;
+            auto data = source.Peek(available);
+            auto count = std::min(available, sizeof(buffer));
+            for (size_t i = 0; i < count; i++)
+            {
+                buffer[i] = ror8(data[i], code);
+                code = (code + 2) % 8;
+            }
+            writer.Copy(buffer, count);
+            source.Skip(count);
+        }
+    }
+
+    void DecodeChunk(uint8_t encoding, ChunkSource& source, ChunkWriter& writer)
+    {
+        switch (encoding)
+        {
+            case CHUNK_ENCODING_NONE:
+                DecodeNone(source, writer);
+                break;
+            case CHUNK_ENCODING_RLE:
+                DecodeRLE(source, writer);
+                break;
+            case CHUNK_ENCODING_RLECOMPRESSED:
+            {
+                RepeatDecoder repeatDecoder(writer);
+                DecodeRLE(source, repeatDecoder);
+                repeatDecoder.Finish();
+                break;
+            }
+            case CHUNK_ENCODING_ROTATE:
+                DecodeRotate(source, writer);
+                break;
+            default:
+                throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
         }
     }
-    return reinterpret_cast<uintptr_t>(dst8) - reinterpret_cast<uintptr_t>(dst);
+} // namespace
+
+SawyerChunkReader::SawyerChunkReader(IStream* stream)
+    : _stream(stream)
+{
 }
 
-size_t SawyerChunkReader::DecodeChunkRotate(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
+void SawyerChunkReader::SkipChunk()
 {
-    if (srcLength > dstCapacity)
+    uint64_t originalPosition = _stream->GetPosition();
+    try
+    {
+        auto header = _stream->ReadValue<sawyercoding_chunk_header>();
+        _stream->Seek(header.length, STREAM_SEEK_CURRENT);
+    }
+    catch (const std::exception&)
     {
-        throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
     }
+}
 
-    auto src8 = static_cast<const uint8_t*>(src);
-    auto dst8 = static_cast<uint8_t*>(dst);
-    uint8_t code = 1;
-    for (size_t i = 0; i < srcLength; i++)
+std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunk()
+{
+    uint64_t originalPosition = _stream->GetPosition();
+    try
     {
-        dst8[i] = ror8(src8[i], code);
-        code = (code + 2) % 8;
+        auto header = ReadHeader();
+        return ReadChunk(header);
+    }
+    catch (const std::exception&)
+    {
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
     }
-    return srcLength;
 }
 
-void* SawyerChunkReader::AllocateLargeTempBuffer()
+std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunkTrack()
 {
-#ifdef __USE_HEAP_ALLOC__
-    auto buffer = HeapAlloc(GetProcessHeap(), 0, MAX_UNCOMPRESSED_CHUNK_SIZE);
-#else
-    auto buffer = std::malloc(MAX_UNCOMPRESSED_CHUNK_SIZE);
-#endif
-    if (buffer == nullptr)
+    uint64_t originalPosition = _stream->GetPosition();
+    try
+    {
+        // Remove 4 as we don't want to touch the checksum at the end of the file
+        int64_t compressedDataLength64 = _stream->GetLength() - _stream->GetPosition() - 4;
+        if (compressedDataLength64 < 0 || compressedDataLength64 > std::numeric_limits<uint32_t>::max())
+        {
+            throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+        }
+
+        sawyercoding_chunk_header header{ CHUNK_ENCODING_RLE, static_cast<uint32_t>(compressedDataLength64) };
+        return ReadChunk(header);
+    }
+    catch (const std::exception&)
     {
-        throw std::runtime_error("Unable to allocate large temporary buffer.");
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
     }
-    return buffer;
 }
 
-void* SawyerChunkReader::FinaliseLargeTempBuffer(void* buffer, size_t len)
+void SawyerChunkReader::ReadChunk(void* dst, size_t length)
 {
-#ifdef __USE_HEAP_ALLOC__
-    auto finalBuffer = std::malloc(len);
-    std::memcpy(finalBuffer, buffer, len);
-    HeapFree(GetProcessHeap(), 0, buffer);
-#else
-    auto finalBuffer = static_cast<uint8_t*>(std::realloc(buffer, len));
-#endif
-    if (finalBuffer == nullptr)
+    uint64_t originalPosition = _stream->GetPosition();
+    try
     {
-        throw std::runtime_error("Unable to allocate final buffer.");
+        auto header = ReadHeader();
+        ChunkSource source(_stream, header.length);
+        ChunkWriter writer(static_cast<uint8_t*>(dst), length);
+        DecodeChunk(header.encoding, source, writer);
+
+        auto chunkLength = writer.GetLength();
+        if (chunkLength == 0)
+        {
+            throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+        }
+        if (chunkLength < length)
+        {
+            auto offset = static_cast<uint8_t*>(dst) + chunkLength;
+            std::fill_n(offset, length - chunkLength, 0x00);
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
     }
-    return finalBuffer;
 }
 
-void SawyerChunkReader::FreeLargeTempBuffer(void* buffer)
+sawyercoding_chunk_header SawyerChunkReader::ReadHeader()
 {
-#ifdef __USE_HEAP_ALLOC__
-    HeapFree(GetProcessHeap(), 0, buffer);
-#else
-    std::free(buffer);
-#endif
+    auto header = _stream->ReadValue<sawyercoding_chunk_header>();
+    if (header.length >= MAX_UNCOMPRESSED_CHUNK_SIZE)
+    {
+        throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+    }
+    return header;
+}
+
+std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunk(const sawyercoding_chunk_header& header)
+{
+    ChunkSource source(_stream, header.length);
+
+    // Most chunks decode to less than four times their encoded length, the buffer grows for any that do not
+    auto capacity = std::clamp<uint64_t>(header.length * 4ULL, 256, MAX_UNCOMPRESSED_CHUNK_SIZE);
+    ChunkWriter writer(static_cast<size_t>(capacity));
+    DecodeChunk(header.encoding, source, writer);
+
+    auto chunkLength = writer.GetLength();
+    if (chunkLength == 0)
+    {
+        throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+    }
+    auto buffer = writer.Release();
+    return std::make_shared<SawyerChunk>(static_cast<SAWYER_ENCODING>(header.encoding), buffer, chunkLength);
 }
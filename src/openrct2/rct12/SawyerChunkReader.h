@@ -19,7 +19,8 @@ interface IStream;
 
 /**
  * Reads sawyer encoding chunks from a data stream. This can be used to read
- * SC6, SV6 and RCT2 objects.
+ * SC6, SV6 and RCT2 objects. Chunks are decoded as they are read from the
+ * stream, straight into their destination.
  */
 class SawyerChunkReader final
 {
@@ -49,7 +50,8 @@ public:
      * Reads the next chunk from the stream and copies it directly to the
      * destination buffer. If the chunk is larger than length, only length
      * is copied. If the chunk is smaller than length, the remaining space
-     * is padded with zero.
+     * is padded with zero. If the chunk can not be read, the contents of the
+     * destination buffer are undefined.
      * @param dst The destination buffer.
      * @param length The size of the destination buffer.
      */
@@ -68,13 +70,6 @@ public:
     }
 
 private:
-    static size_t DecodeChunk(void* dst, size_t dstCapacity, const void* src, const sawyercoding_chunk_header& header);
-    static size_t DecodeChunkRLERepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
-    static size_t DecodeChunkRLE(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
-    static size_t DecodeChunkRepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
-    static size_t DecodeChunkRotate(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
-
-    static void* AllocateLargeTempBuffer();
-    static void* FinaliseLargeTempBuffer(void* buffer, size_t len);
-    static void FreeLargeTempBuffer(void* buffer);
+    sawyercoding_chunk_header ReadHeader();
+    std::shared_ptr<SawyerChunk> ReadChunk(const sawyercoding_chunk_header& header);
 };
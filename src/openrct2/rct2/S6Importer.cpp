@@ -61,12 +61,20 @@
 class S6Importer final : public IParkImporter
 {
 private:
+    struct PackedObject
+    {
+        rct_object_entry Entry;
+        std::shared_ptr<SawyerChunk> Chunk;
+    };
+
     IObjectRepository& _objectRepository;
 
     const utf8* _s6Path = nullptr;
     rct_s6_data _s6{};
     uint8_t _gameVersion = 0;
     bool _isSV7 = false;
+    bool _deferPackedObjects = false;
+    std::vector<PackedObject> _packedObjects;
 
 public:
     S6Importer(IObjectRepository& objectRepository)
@@ -145,7 +153,15 @@ public:
         // TODO try to contain this more and not store objects until later
         for (uint16_t i = 0; i < _s6.header.num_packed_objects; i++)
         {
-            _objectRepository.ExportPackedObject(stream);
+            if (_deferPackedObjects)
+            {
+                auto entry = stream->ReadValue<rct_object_entry>();
+                _packedObjects.push_back({ entry, chunkReader.ReadChunk() });
+            }
+            else
+            {
+                _objectRepository.ExportPackedObject(stream);
+            }
         }
 
         if (path)
@@ -187,6 +203,24 @@ public:
         return false;
     }
 
+    void DeferPackedObjects() override
+    {
+        _deferPackedObjects = true;
+    }
+
+    void ExportPackedObjects() override
+    {
+        for (const auto& packedObject : _packedObjects)
+        {
+            if (_objectRepository.FindObject(&packedObject.Entry) == nullptr)
+            {
+                const auto& chunk = *packedObject.Chunk;
+                _objectRepository.AddObject(&packedObject.Entry, chunk.GetData(), chunk.GetLength());
+            }
+        }
+        _packedObjects.clear();
+    }
+
     void Import() override
     {
         Initialise();
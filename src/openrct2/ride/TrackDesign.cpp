@@ -2123,6 +2123,8 @@ static void track_design_preview_restore_map(map_backup* backup)
     gMapSizeMinus2 = backup->map_size_units_minus_2;
     gMapSize = backup->map_size;
     gCurrentRotation = backup->current_rotation;
+    park_statistics_invalidate();
+    map_active_tiles_invalidate();
 }
 
 /**
@@ -945,6 +945,7 @@ namespace OpenRCT2::Scripting
         void Invalidate()
         {
             map_invalidate_tile_full(_coords);
+            map_active_tiles_mark(_coords);
         }
 
     public:
@@ -1124,6 +1125,7 @@ namespace OpenRCT2::Scripting
                     }
                 }
                 map_invalidate_tile_full(_coords);
+                map_active_tiles_mark(_coords);
             }
         }
 
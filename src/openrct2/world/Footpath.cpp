@@ -14,7 +14,9 @@
 #include "../actions/FootpathPlaceAction.hpp"
 #include "../actions/FootpathRemoveAction.hpp"
 #include "../actions/LandSetRightsAction.hpp"
+#include "../config/Config.h"
 #include "../core/Guard.hpp"
+#include "../core/JobPool.hpp"
 #include "../localisation/Localisation.h"
 #include "../management/Finance.h"
 #include "../network/network.h"
@@ -33,7 +35,9 @@
 #include "Surface.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <memory>
 
 void footpath_update_queue_entrance_banner(const CoordsXY& footpathPos, TileElement* tileElement);
 
@@ -54,6 +58,13 @@ uint8_t gFootpathGroundFlags;
 static uint8_t* _footpathQueueChainNext;
 static uint8_t _footpathQueueChain[64];
 
+// Number of paths built or removed before the next wide flag update that triggers an immediate update of the area
+static constexpr const int32_t PATH_WIDE_FLAGS_BULK_UPDATE_THRESHOLD = 16;
+
+static MapRange _pathWideFlagsQueuedRange = { 0, 0, 0, 0 };
+static int32_t _pathWideFlagsQueuedCount = 0;
+static std::unique_ptr<JobPool> _pathWideFlagsJobs;
+
 // This is the coordinates that a user of the bin should move to
 // rct2: 0x00992A4C
 const CoordsXY BinUseOffsets[4] = {
@@ -977,6 +988,11 @@ void footpath_connect_edges(const CoordsXY& footpathPos, TileElement* tileElemen
     rct_neighbour_list neighbourList;
     rct_neighbour neighbour;
 
+    if (!(flags & GAME_COMMAND_FLAG_GHOST))
+    {
+        footpath_queue_wide_flags_update(footpathPos);
+    }
+
     footpath_update_queue_chains();
 
     neighbour_list_init(&neighbourList);
@@ -1840,6 +1856,117 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
     } while (!(tileElement++)->IsLastForTile());
 }
 
+/**
+ * Recomputes the wide flags of every tile in the range in a single pass, producing the same result as visiting the
+ * tiles one at a time in the order used by map_update_path_wide_flags. A tile only reads the wide flags of the tiles
+ * west, north-west, north and north-east of it, so rows can be processed concurrently as long as each row trails the
+ * row before it by two tiles. Rows are handed out in order, so a row is only ever waiting on a row that is already
+ * being processed.
+ */
+void footpath_update_path_wide_flags_range(const MapRange& range)
+{
+    auto normRange = range.Normalise();
+    auto topLeft = TileCoordsXY(
+        CoordsXY{ std::clamp(normRange.GetLeft(), 0, MAXIMUM_TILE_START_XY),
+                  std::clamp(normRange.GetTop(), 0, MAXIMUM_TILE_START_XY) });
+    auto bottomRight = TileCoordsXY(
+        CoordsXY{ std::clamp(normRange.GetRight(), 0, MAXIMUM_TILE_START_XY),
+                  std::clamp(normRange.GetBottom(), 0, MAXIMUM_TILE_START_XY) });
+    const int32_t width = bottomRight.x - topLeft.x + 1;
+    const int32_t height = bottomRight.y - topLeft.y + 1;
+
+    if (!gConfigGeneral.multithreading || height < 2)
+    {
+        for (int32_t y = topLeft.y; y <= bottomRight.y; y++)
+        {
+            for (int32_t x = topLeft.x; x <= bottomRight.x; x++)
+            {
+                footpath_update_path_wide_flags(TileCoordsXY{ x, y }.ToCoordsXY());
+            }
+        }
+        return;
+    }
+
+    if (_pathWideFlagsJobs == nullptr)
+    {
+        _pathWideFlagsJobs = std::make_unique<JobPool>();
+    }
+
+    auto rowProgress = std::make_unique<std::atomic<int32_t>[]>(height);
+    for (int32_t row = 0; row < height; row++)
+    {
+        rowProgress[row].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<int32_t> nextRow = { 0 };
+
+    auto processRows = [&]() {
+        int32_t row;
+        while ((row = nextRow.fetch_add(1)) < height)
+        {
+            for (int32_t col = 0; col < width; col++)
+            {
+                if (row > 0)
+                {
+                    auto required = std::min(col + 2, width);
+                    while (rowProgress[row - 1].load(std::memory_order_acquire) < required)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                footpath_update_path_wide_flags(TileCoordsXY{ topLeft.x + col, topLeft.y + row }.ToCoordsXY());
+                rowProgress[row].store(col + 1, std::memory_order_release);
+            }
+        }
+    };
+
+    auto numTasks = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), height));
+    for (size_t i = 0; i < numTasks; i++)
+    {
+        _pathWideFlagsJobs->AddTask(processRows);
+    }
+    _pathWideFlagsJobs->Join();
+}
+
+/**
+ * Records that a path has been built or removed. If enough paths change before the next wide flag update, the
+ * affected area is recomputed in one go rather than waiting for the regular sweep to reach it.
+ */
+void footpath_queue_wide_flags_update(const CoordsXY& footpathPos)
+{
+    if (_pathWideFlagsQueuedCount == 0)
+    {
+        _pathWideFlagsQueuedRange = MapRange(footpathPos.x, footpathPos.y, footpathPos.x, footpathPos.y);
+    }
+    else
+    {
+        _pathWideFlagsQueuedRange = MapRange(
+            std::min(_pathWideFlagsQueuedRange.GetLeft(), footpathPos.x),
+            std::min(_pathWideFlagsQueuedRange.GetTop(), footpathPos.y),
+            std::max(_pathWideFlagsQueuedRange.GetRight(), footpathPos.x),
+            std::max(_pathWideFlagsQueuedRange.GetBottom(), footpathPos.y));
+    }
+    _pathWideFlagsQueuedCount++;
+}
+
+void footpath_update_queued_wide_flags()
+{
+    if (_pathWideFlagsQueuedCount >= PATH_WIDE_FLAGS_BULK_UPDATE_THRESHOLD)
+    {
+        // Include the surrounding tiles, their wide flags depend on the changed paths
+        auto range = MapRange(
+            _pathWideFlagsQueuedRange.GetLeft() - COORDS_XY_STEP, _pathWideFlagsQueuedRange.GetTop() - COORDS_XY_STEP,
+            _pathWideFlagsQueuedRange.GetRight() + COORDS_XY_STEP,
+            _pathWideFlagsQueuedRange.GetBottom() + COORDS_XY_STEP);
+        footpath_update_path_wide_flags_range(range);
+    }
+    _pathWideFlagsQueuedCount = 0;
+}
+
+void footpath_clear_queued_wide_flags()
+{
+    _pathWideFlagsQueuedCount = 0;
+}
+
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position)
 {
     auto pathElement = map_get_path_element_at(position);
@@ -194,6 +194,10 @@ bool fence_in_the_way(const CoordsXYRangedZ& fencePos, int32_t direction);
 void footpath_chain_ride_queue(
     ride_id_t rideIndex, int32_t entranceIndex, const CoordsXY& footpathPos, TileElement* tileElement, int32_t direction);
 void footpath_update_path_wide_flags(const CoordsXY& footpathPos);
+void footpath_update_path_wide_flags_range(const MapRange& range);
+void footpath_queue_wide_flags_update(const CoordsXY& footpathPos);
+void footpath_update_queued_wide_flags();
+void footpath_clear_queued_wide_flags();
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position);
 
 int32_t footpath_is_connected_to_map_edge(const CoordsXYZ& footpathPos, int32_t direction, int32_t flags);
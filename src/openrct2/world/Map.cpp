@@ -56,6 +56,7 @@
 #include "Wall.h"
 
 #include <algorithm>
+#include <bitset>
 #include <iterator>
 #include <memory>
 
@@ -93,6 +94,15 @@ uint16_t gWidePathTileLoopX;
 uint16_t gWidePathTileLoopY;
 uint16_t gGrassSceneryTileLoopPosition;
 
+/**
+ * Tiles that may need visiting by the grass / scenery and path wide flag sweeps. A clear bit guarantees that
+ * visiting the tile would be a no-op, a set bit only means it might not be. Bits are set when elements are
+ * inserted or changed in a way that could make a tile relevant, and cleared again when a sweep finds nothing there.
+ */
+static std::bitset<MAX_TILE_TILE_ELEMENT_POINTERS> _activeGrassSceneryTiles;
+static std::bitset<MAX_TILE_TILE_ELEMENT_POINTERS> _activePathTiles;
+static bool _activeTilesValid = false;
+
 int16_t gMapSizeUnits;
 int16_t gMapSizeMinus2;
 int16_t gMapSize;
@@ -385,6 +395,9 @@ void map_update_tile_pointers()
 {
     int32_t i, x, y;
 
+    park_statistics_invalidate();
+    map_active_tiles_invalidate();
+
     for (i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
     {
         gTileElementTilePointers[i] = TILE_UNDEFINED_TILE_ELEMENT;
@@ -616,6 +629,93 @@ bool map_coord_is_connected(const TileCoordsXYZ& loc, uint8_t faceDirection)
     return false;
 }
 
+static size_t map_active_tile_index(const CoordsXY& coords)
+{
+    auto tileCoords = TileCoordsXY(coords);
+    return static_cast<size_t>(tileCoords.y) * MAXIMUM_MAP_SIZE_TECHNICAL + tileCoords.x;
+}
+
+/**
+ * Whether map_update_tiles has anything to do for the tile: grass that can grow or be cut, small scenery that ages
+ * or path additions that may be jumping fountains. Ghost elements are included to keep this a superset.
+ */
+static bool map_tile_has_grass_or_scenery(const CoordsXY& coords)
+{
+    auto tileElement = map_get_first_element_at(coords);
+    if (tileElement == nullptr)
+        return false;
+    do
+    {
+        switch (tileElement->GetType())
+        {
+            case TILE_ELEMENT_TYPE_SURFACE:
+                if (tileElement->AsSurface()->CanGrassGrow())
+                    return true;
+                break;
+            case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+                return true;
+            case TILE_ELEMENT_TYPE_PATH:
+                if (tileElement->AsPath()->HasAddition())
+                    return true;
+                break;
+        }
+    } while (!(tileElement++)->IsLastForTile());
+    return false;
+}
+
+static bool map_tile_has_path(const CoordsXY& coords)
+{
+    auto tileElement = map_get_first_element_at(coords);
+    if (tileElement == nullptr)
+        return false;
+    do
+    {
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH)
+            return true;
+    } while (!(tileElement++)->IsLastForTile());
+    return false;
+}
+
+static void map_active_tiles_validate()
+{
+    if (_activeTilesValid)
+        return;
+
+    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_BIG; y += COORDS_XY_STEP)
+    {
+        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_BIG; x += COORDS_XY_STEP)
+        {
+            auto tileIndex = map_active_tile_index({ x, y });
+            _activeGrassSceneryTiles.set(tileIndex, map_tile_has_grass_or_scenery({ x, y }));
+            _activePathTiles.set(tileIndex, map_tile_has_path({ x, y }));
+        }
+    }
+    _activeTilesValid = true;
+}
+
+/**
+ * Forces the active tile sets to be rebuilt from the map on the next sweep. Used after the map has been changed
+ * in bulk, e.g. loaded, generated or restored from a backup.
+ */
+void map_active_tiles_invalidate()
+{
+    _activeTilesValid = false;
+}
+
+/**
+ * Marks a tile as needing to be visited by the grass / scenery and path wide flag sweeps. Must be called whenever
+ * an element is added to a tile or an existing element is changed into something the sweeps act upon.
+ */
+void map_active_tiles_mark(const CoordsXY& coords)
+{
+    if (!_activeTilesValid || !map_is_location_valid(coords))
+        return;
+
+    auto tileIndex = map_active_tile_index(coords);
+    _activeGrassSceneryTiles.set(tileIndex);
+    _activePathTiles.set(tileIndex);
+}
+
 /**
  *
  *  rct2: 0x006A876D
@@ -624,17 +724,31 @@ void map_update_path_wide_flags()
 {
     if (gScreenFlags & (SCREEN_FLAGS_TRACK_DESIGNER | SCREEN_FLAGS_TRACK_MANAGER))
     {
+        map_active_tiles_invalidate();
         return;
     }
 
+    map_active_tiles_validate();
+    footpath_update_queued_wide_flags();
+
     // Presumably update_path_wide_flags is too computationally expensive to call for every
     // tile every update, so gWidePathTileLoopX and gWidePathTileLoopY store the x and y
-    // progress. A maximum of 128 calls is done per update.
+    // progress. A maximum of 128 calls is done per update. Tiles without any paths are
+    // skipped but still count towards the 128 so that each path tile is updated on the
+    // same tick as it would be if every tile was visited.
     uint16_t x = gWidePathTileLoopX;
     uint16_t y = gWidePathTileLoopY;
     for (int32_t i = 0; i < 128; i++)
     {
-        footpath_update_path_wide_flags({ x, y });
+        auto tileIndex = map_active_tile_index({ x, y });
+        if (_activePathTiles.test(tileIndex))
+        {
+            footpath_update_path_wide_flags({ x, y });
+            if (!map_tile_has_path({ x, y }))
+            {
+                _activePathTiles.reset(tileIndex);
+            }
+        }
 
         // Next x, y tile
         x += COORDS_XY_STEP;
@@ -1160,6 +1274,7 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
 
     newTileElement = gNextFreeTileElement;
     originalTileElement = gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x];
+    map_active_tiles_mark(loc);
 
     // Set tile index pointer to point to new element block
     gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x] = newTileElement;
@@ -1516,7 +1631,13 @@ void map_update_tiles()
 {
     int32_t ignoreScreenFlags = SCREEN_FLAGS_SCENARIO_EDITOR | SCREEN_FLAGS_TRACK_DESIGNER | SCREEN_FLAGS_TRACK_MANAGER;
     if (gScreenFlags & ignoreScreenFlags)
+    {
+        // The editors change the map and loaded objects freely, rebuild the active tiles once they are left
+        map_active_tiles_invalidate();
         return;
+    }
+
+    map_active_tiles_validate();
 
     // Update 43 more tiles
     for (int32_t j = 0; j < 43; j++)
@@ -1534,11 +1655,19 @@ void map_update_tiles()
         }
 
         auto mapPos = TileCoordsXY{ x, y }.ToCoordsXY();
-        auto* surfaceElement = map_get_surface_element_at(mapPos);
-        if (surfaceElement != nullptr)
+        auto tileIndex = map_active_tile_index(mapPos);
+        if (_activeGrassSceneryTiles.test(tileIndex))
         {
-            surfaceElement->UpdateGrassLength(mapPos);
-            scenery_update_tile(mapPos);
+            auto* surfaceElement = map_get_surface_element_at(mapPos);
+            if (surfaceElement != nullptr)
+            {
+                surfaceElement->UpdateGrassLength(mapPos);
+                scenery_update_tile(mapPos);
+            }
+            if (!map_tile_has_grass_or_scenery(mapPos))
+            {
+                _activeGrassSceneryTiles.reset(tileIndex);
+            }
         }
 
         gGrassSceneryTileLoopPosition++;
@@ -1699,6 +1828,8 @@ void map_extend_boundary_surface()
 
         update_park_fences({ x << 5, y << 5 });
     }
+
+    map_active_tiles_invalidate();
 }
 
 /**
@@ -1720,6 +1851,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             element->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
             element->AsSurface()->SetParkFences(0);
             element->AsSurface()->SetWaterHeight(0);
+            map_active_tiles_mark(loc);
             // Because this element is not completely removed, the pointer must be updated manually
             // The rest of the elements are removed from the array, so the pointer doesn't need to be updated.
             (*elementPtr)++;
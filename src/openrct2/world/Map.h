@@ -215,6 +215,8 @@ int32_t tile_element_iterator_next(tile_element_iterator* it);
 void tile_element_iterator_restart_for_tile(tile_element_iterator* it);
 
 void map_update_tiles();
+void map_active_tiles_invalidate();
+void map_active_tiles_mark(const CoordsXY& coords);
 int32_t map_get_highest_z(const CoordsXY& loc);
 
 bool tile_element_wants_path_connection_towards(const TileCoordsXYZD& coords, const TileElement* const elementToBeRemoved);
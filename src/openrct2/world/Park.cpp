@@ -78,6 +78,16 @@ uint32_t _suggestedGuestMaximum;
  */
 int32_t _guestGenerationProbability;
 
+static ParkStatistics _parkStatistics;
+static bool _parkStatisticsValid = false;
+
+/**
+ * Litter dropped on the current tick is not counted by the park rating until the tick has passed. Rather than
+ * re-checking every piece of litter, the litter dropped on the most recent tick is held back here.
+ */
+static uint32_t _parkStatisticsRecentLitterTick;
+static uint32_t _parkStatisticsRecentLitterCount;
+
 /**
  * Choose a random peep spawn and iterates through until defined spawn is found.
  */
@@ -312,6 +322,9 @@ void Park::Update(const Date& date)
     // Every ~13 seconds
     if (gCurrentTicks % 512 == 0)
     {
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        park_statistics_verify();
+#endif
         gParkRating = CalculateParkRating();
         gParkValue = CalculateParkValue();
         gCompanyValue = CalculateCompanyValue();
@@ -339,22 +352,7 @@ void Park::Update(const Date& date)
 
 int32_t Park::CalculateParkSize() const
 {
-    int32_t tiles;
-    tile_element_iterator it;
-
-    tiles = 0;
-    tile_element_iterator_begin(&it);
-    do
-    {
-        if (it.element->GetType() == TILE_ELEMENT_TYPE_SURFACE)
-        {
-            if (it.element->AsSurface()->GetOwnership() & (OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED | OWNERSHIP_OWNED))
-            {
-                tiles++;
-            }
-        }
-    } while (tile_element_iterator_next(&it));
-
+    int32_t tiles = static_cast<int32_t>(park_statistics_get().OwnedTileCount);
     if (tiles != gParkSize)
     {
         gParkSize = tiles;
@@ -377,28 +375,16 @@ int32_t Park::CalculateParkRating() const
         result = 1050;
     }
 
+    const auto& statistics = park_statistics_get();
+
     // Guests
     {
         // -150 to +3 based on a range of guests from 0 to 2000
         result -= 150 - (std::min<int16_t>(2000, gNumGuestsInPark) / 13);
 
         // Find the number of happy peeps and the number of peeps who can't find the park exit
-        uint32_t happyGuestCount = 0;
-        uint32_t lostGuestCount = 0;
-        for (auto peep : EntityList<Guest>(EntityListId::Peep))
-        {
-            if (!peep->OutsideOfPark)
-            {
-                if (peep->Happiness > 128)
-                {
-                    happyGuestCount++;
-                }
-                if ((peep->PeepFlags & PEEP_FLAGS_LEAVING_PARK) && (peep->GuestIsLostCountdown < 90))
-                {
-                    lostGuestCount++;
-                }
-            }
-        }
+        uint32_t happyGuestCount = statistics.HappyGuestCount;
+        uint32_t lostGuestCount = statistics.LostGuestCount;
 
         // Peep happiness -500 to +0
         result -= 500;
@@ -467,15 +453,7 @@ int32_t Park::CalculateParkRating() const
 
     // Litter
     {
-        int32_t litterCount = 0;
-        for (auto litter : EntityList<Litter>(EntityListId::Litter))
-        {
-            // Ignore recently dropped litter
-            if (litter->creationTick - gScenarioTicks >= 7680)
-            {
-                litterCount++;
-            }
-        }
+        int32_t litterCount = static_cast<int32_t>(statistics.LitterCount);
         result -= 600 - (4 * (150 - std::min<int32_t>(150, litterCount)));
     }
 
@@ -808,3 +786,208 @@ uint8_t calculate_guest_initial_happiness(uint8_t percentage)
 {
     return Park::CalculateGuestInitialHappiness(percentage);
 }
+
+static bool park_statistics_is_owned(uint8_t ownership)
+{
+    return (ownership & (OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED | OWNERSHIP_OWNED)) != 0;
+}
+
+static bool park_statistics_is_litter_counted(const Litter* litter)
+{
+    // Ignore recently dropped litter
+    return litter->creationTick - gScenarioTicks >= 7680;
+}
+
+/**
+ * Counts the happy and lost guests. The happiness and state of guests change on nearly every tick, so these are
+ * counted from the guest list whenever the statistics are read rather than kept up to date by every guest update.
+ */
+static void park_statistics_count_guests(ParkStatistics& statistics)
+{
+    statistics.HappyGuestCount = 0;
+    statistics.LostGuestCount = 0;
+    for (auto peep : EntityList<Guest>(EntityListId::Peep))
+    {
+        if (!peep->OutsideOfPark)
+        {
+            if (peep->Happiness > 128)
+            {
+                statistics.HappyGuestCount++;
+            }
+            if ((peep->PeepFlags & PEEP_FLAGS_LEAVING_PARK) && (peep->GuestIsLostCountdown < 90))
+            {
+                statistics.LostGuestCount++;
+            }
+        }
+    }
+}
+
+/**
+ * Moves litter that was held back on a previous tick into the litter count.
+ */
+static void park_statistics_flush_recent_litter()
+{
+    if (_parkStatisticsRecentLitterTick != gScenarioTicks)
+    {
+        _parkStatistics.LitterCount += _parkStatisticsRecentLitterCount;
+        _parkStatisticsRecentLitterTick = gScenarioTicks;
+        _parkStatisticsRecentLitterCount = 0;
+    }
+}
+
+static void park_statistics_recount()
+{
+    _parkStatistics = {};
+    _parkStatisticsRecentLitterTick = gScenarioTicks;
+    _parkStatisticsRecentLitterCount = 0;
+
+    tile_element_iterator it;
+    tile_element_iterator_begin(&it);
+    do
+    {
+        if (it.element->GetType() == TILE_ELEMENT_TYPE_SURFACE)
+        {
+            if (park_statistics_is_owned(it.element->AsSurface()->GetOwnership()))
+            {
+                _parkStatistics.OwnedTileCount++;
+            }
+        }
+    } while (tile_element_iterator_next(&it));
+
+    for (auto litter : EntityList<Litter>(EntityListId::Litter))
+    {
+        if (park_statistics_is_litter_counted(litter))
+        {
+            _parkStatistics.LitterCount++;
+        }
+        else if (litter->creationTick == gScenarioTicks)
+        {
+            _parkStatisticsRecentLitterCount++;
+        }
+    }
+
+    _parkStatisticsValid = true;
+}
+
+const ParkStatistics& park_statistics_get()
+{
+    if (!_parkStatisticsValid)
+    {
+        park_statistics_recount();
+    }
+    park_statistics_flush_recent_litter();
+    park_statistics_count_guests(_parkStatistics);
+    return _parkStatistics;
+}
+
+/**
+ * Calculates the park statistics from scratch without touching the maintained counters.
+ */
+ParkStatistics park_statistics_calculate()
+{
+    ParkStatistics result{};
+
+    tile_element_iterator it;
+    tile_element_iterator_begin(&it);
+    do
+    {
+        if (it.element->GetType() == TILE_ELEMENT_TYPE_SURFACE)
+        {
+            if (park_statistics_is_owned(it.element->AsSurface()->GetOwnership()))
+            {
+                result.OwnedTileCount++;
+            }
+        }
+    } while (tile_element_iterator_next(&it));
+
+    park_statistics_count_guests(result);
+
+    for (auto litter : EntityList<Litter>(EntityListId::Litter))
+    {
+        if (park_statistics_is_litter_counted(litter))
+        {
+            result.LitterCount++;
+        }
+    }
+    return result;
+}
+
+void park_statistics_invalidate()
+{
+    _parkStatisticsValid = false;
+}
+
+/**
+ * Cross-checks the maintained statistics against a full recalculation. Any mismatch is logged and the statistics
+ * are recounted so that the game continues with correct values.
+ */
+bool park_statistics_verify()
+{
+    const auto& current = park_statistics_get();
+    auto expected = park_statistics_calculate();
+    if (current.OwnedTileCount == expected.OwnedTileCount && current.HappyGuestCount == expected.HappyGuestCount
+        && current.LostGuestCount == expected.LostGuestCount && current.LitterCount == expected.LitterCount)
+    {
+        return true;
+    }
+
+    log_error(
+        "Park statistics out of sync: owned tiles %u/%u, happy guests %u/%u, lost guests %u/%u, litter %u/%u",
+        current.OwnedTileCount, expected.OwnedTileCount, current.HappyGuestCount, expected.HappyGuestCount,
+        current.LostGuestCount, expected.LostGuestCount, current.LitterCount, expected.LitterCount);
+    park_statistics_recount();
+    return false;
+}
+
+void park_statistics_on_ownership_changed(uint8_t oldOwnership, uint8_t newOwnership)
+{
+    if (!_parkStatisticsValid)
+        return;
+
+    bool wasOwned = park_statistics_is_owned(oldOwnership);
+    bool isOwned = park_statistics_is_owned(newOwnership);
+    if (wasOwned && !isOwned)
+    {
+        _parkStatistics.OwnedTileCount--;
+    }
+    else if (!wasOwned && isOwned)
+    {
+        _parkStatistics.OwnedTileCount++;
+    }
+}
+
+void park_statistics_on_litter_created(const Litter* litter)
+{
+    if (!_parkStatisticsValid)
+        return;
+
+    park_statistics_flush_recent_litter();
+    if (litter->creationTick == gScenarioTicks)
+    {
+        _parkStatisticsRecentLitterCount++;
+    }
+    else if (park_statistics_is_litter_counted(litter))
+    {
+        _parkStatistics.LitterCount++;
+    }
+}
+
+void park_statistics_on_sprite_removed(const SpriteBase* sprite)
+{
+    if (!_parkStatisticsValid)
+        return;
+
+    auto litter = sprite->As<Litter>();
+    if (litter != nullptr)
+    {
+        park_statistics_flush_recent_litter();
+        if (litter->creationTick == gScenarioTicks && _parkStatisticsRecentLitterCount > 0)
+        {
+            _parkStatisticsRecentLitterCount--;
+        }
+        else if (park_statistics_is_litter_counted(litter))
+        {
+            _parkStatistics.LitterCount--;
+        }
+    }
+}
@@ -45,6 +45,22 @@ enum : uint32_t
 
 struct Peep;
 struct rct_ride;
+struct Litter;
+struct SpriteBase;
+
+/**
+ * Aggregates used by the park size and rating calculations. The owned tile and litter counts are maintained by the
+ * game actions and entity updates that affect them instead of being recounted from a full map or entity sweep. Any bulk
+ * change to the map or entity lists (loading a park, restoring a map backup) invalidates them and they are recounted on
+ * next access. The happy and lost guest counts are counted from the guest list whenever the statistics are read.
+ */
+struct ParkStatistics
+{
+    uint32_t OwnedTileCount;
+    uint32_t HappyGuestCount;
+    uint32_t LostGuestCount;
+    uint32_t LitterCount;
+};
 
 namespace OpenRCT2
 {
@@ -124,5 +140,13 @@ int32_t park_entrance_get_index(const CoordsXYZ& entrancePos);
 void park_set_entrance_fee(money32 value);
 money16 park_get_entrance_fee();
 
+const ParkStatistics& park_statistics_get();
+ParkStatistics park_statistics_calculate();
+void park_statistics_invalidate();
+bool park_statistics_verify();
+void park_statistics_on_ownership_changed(uint8_t oldOwnership, uint8_t newOwnership);
+void park_statistics_on_litter_created(const Litter* litter);
+void park_statistics_on_sprite_removed(const SpriteBase* sprite);
+
 bool park_ride_prices_unlocked();
 bool park_entry_price_unlocked();
@@ -16,10 +16,12 @@
 #include "../core/Crypt.h"
 #include "../core/Guard.hpp"
 #include "../interface/Viewport.h"
+#include "../interface/ViewportCache.h"
 #include "../localisation/Date.h"
 #include "../localisation/Localisation.h"
 #include "../scenario/Scenario.h"
 #include "Fountain.h"
+#include "Park.h"
 
 #include <algorithm>
 #include <cmath>
@@ -135,10 +137,20 @@ static void invalidate_sprite_max_zoom(SpriteBase* sprite, int32_t maxZoom)
     for (int32_t i = 0; i < MAX_VIEWPORT_COUNT; i++)
     {
         rct_viewport* viewport = &g_viewport_list[i];
-        if (viewport->width != 0 && viewport->zoom <= maxZoom)
+        if (viewport->width == 0)
+            continue;
+
+        if (viewport->zoom <= maxZoom)
         {
             viewport_invalidate(viewport, sprite->sprite_left, sprite->sprite_top, sprite->sprite_right, sprite->sprite_bottom);
         }
+        else
+        {
+            // The screen is left as it is at this zoom, but the next time it is drawn it must not be copied from the
+            // render cache as it was before the sprite changed
+            viewport_cache_invalidate(
+                viewport, sprite->sprite_left, sprite->sprite_top, sprite->sprite_right, sprite->sprite_bottom);
+        }
     }
 }
 
@@ -227,6 +239,7 @@ void reset_sprite_list()
  */
 void reset_sprite_spatial_index()
 {
+    park_statistics_invalidate();
     std::fill_n(gSpriteSpatialIndex, std::size(gSpriteSpatialIndex), SPRITE_INDEX_NULL);
     for (size_t i = 0; i < MAX_SPRITES; i++)
     {
@@ -772,6 +785,8 @@ void sprite_set_coordinates(const CoordsXYZ& spritePos, SpriteBase* sprite)
  */
 void sprite_remove(SpriteBase* sprite)
 {
+    park_statistics_on_sprite_removed(sprite);
+
     auto peep = sprite->As<Peep>();
     if (peep != nullptr)
     {
@@ -865,6 +880,7 @@ void litter_create(const CoordsXYZD& litterPos, int32_t type)
     litter->MoveTo(offsetLitterPos);
     litter->Invalidate0();
     litter->creationTick = gScenarioTicks;
+    park_statistics_on_litter_created(litter);
 }
 
 /**
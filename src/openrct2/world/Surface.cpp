@@ -16,6 +16,7 @@
 #include "../scenario/Scenario.h"
 #include "Location.hpp"
 #include "Map.h"
+#include "Park.h"
 
 uint32_t SurfaceElement::GetSurfaceStyle() const
 {
@@ -197,6 +198,7 @@ uint8_t SurfaceElement::GetOwnership() const
 
 void SurfaceElement::SetOwnership(uint8_t newOwnership)
 {
+    park_statistics_on_ownership_changed(GetOwnership(), newOwnership);
     Ownership &= ~TILE_ELEMENT_SURFACE_OWNERSHIP_MASK;
     Ownership |= (newOwnership & TILE_ELEMENT_SURFACE_OWNERSHIP_MASK);
 }
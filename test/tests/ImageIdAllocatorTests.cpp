@@ -0,0 +1,134 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <openrct2/drawing/ImageIdAllocator.h>
+#include <random>
+#include <vector>
+
+TEST(ImageIdAllocatorTests, FreedRangesAreMerged)
+{
+    ImageIdAllocator allocator(100, 1000);
+    auto a = allocator.Allocate(10);
+    auto b = allocator.Allocate(20);
+    auto c = allocator.Allocate(30);
+    ASSERT_EQ(a, 100u);
+    ASSERT_EQ(b, 110u);
+    ASSERT_EQ(c, 130u);
+
+    ASSERT_TRUE(allocator.Free(b, 20));
+    ASSERT_EQ(allocator.GetStats().FreeRanges, 2u);
+    ASSERT_TRUE(allocator.Free(a, 10));
+    ASSERT_EQ(allocator.GetStats().FreeRanges, 2u);
+    ASSERT_TRUE(allocator.Free(c, 30));
+
+    auto stats = allocator.GetStats();
+    ASSERT_EQ(stats.Allocated, 0u);
+    ASSERT_EQ(stats.FreeRanges, 1u);
+    ASSERT_EQ(stats.LargestFreeRange, 1000u);
+    ASSERT_EQ(stats.GetFragmentation(), 0.0);
+}
+
+TEST(ImageIdAllocatorTests, SmallestFittingRangeIsUsed)
+{
+    ImageIdAllocator allocator(0, 1000);
+    auto a = allocator.Allocate(50);
+    allocator.Allocate(1);
+    auto b = allocator.Allocate(10);
+    allocator.Allocate(1);
+    allocator.Free(a, 50);
+    allocator.Free(b, 10);
+
+    ASSERT_EQ(allocator.Allocate(8), b);
+    ASSERT_EQ(allocator.Allocate(40), a);
+    ASSERT_EQ(allocator.Allocate(2000), ImageIdAllocator::INVALID_ID);
+}
+
+TEST(ImageIdAllocatorTests, InvalidFreeIsRejected)
+{
+    ImageIdAllocator allocator(0, 1000);
+    auto a = allocator.Allocate(10);
+    ASSERT_FALSE(allocator.Free(a, 5));
+    ASSERT_FALSE(allocator.Free(a + 1, 9));
+    ASSERT_TRUE(allocator.Free(a, 10));
+    ASSERT_FALSE(allocator.Free(a, 10));
+}
+
+TEST(ImageIdAllocatorTests, RepeatedObjectSetSwitching)
+{
+    // Mimics loading and unloading parks that share part of their objects from a large object repository, each object
+    // owning a range of images. Checks that ranges never overlap and that everything merges back once freed.
+    constexpr uint32_t CAPACITY = 1 << 20;
+    constexpr size_t REPOSITORY_SIZE = 20000;
+    constexpr size_t PARK_OBJECTS = 600;
+    constexpr int32_t PARKS = 200;
+
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<uint32_t> imageCountDistribution(1, 256);
+    std::vector<uint32_t> imageCounts(REPOSITORY_SIZE);
+    for (auto& count : imageCounts)
+    {
+        count = imageCountDistribution(random);
+    }
+
+    ImageIdAllocator allocator(0, CAPACITY);
+    std::vector<uint32_t> baseIds(REPOSITORY_SIZE, ImageIdAllocator::INVALID_ID);
+    std::vector<uint8_t> owner(CAPACITY);
+    std::uniform_int_distribution<size_t> objectDistribution(0, REPOSITORY_SIZE - 1);
+    std::bernoulli_distribution keepDistribution(0.5);
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    for (int32_t park = 0; park < PARKS; park++)
+    {
+        // Unload about half of the loaded objects
+        for (size_t i = 0; i < REPOSITORY_SIZE; i++)
+        {
+            if (baseIds[i] != ImageIdAllocator::INVALID_ID && !keepDistribution(random))
+            {
+                std::fill_n(owner.begin() + baseIds[i], imageCounts[i], 0);
+                ASSERT_TRUE(allocator.Free(baseIds[i], imageCounts[i]));
+                baseIds[i] = ImageIdAllocator::INVALID_ID;
+            }
+        }
+
+        // Load objects for the next park
+        for (size_t n = 0; n < PARK_OBJECTS / 2; n++)
+        {
+            auto i = objectDistribution(random);
+            if (baseIds[i] == ImageIdAllocator::INVALID_ID)
+            {
+                baseIds[i] = allocator.Allocate(imageCounts[i]);
+                ASSERT_NE(baseIds[i], ImageIdAllocator::INVALID_ID);
+                ASSERT_LE(baseIds[i] + imageCounts[i], CAPACITY);
+                for (uint32_t j = 0; j < imageCounts[i]; j++)
+                {
+                    ASSERT_EQ(owner[baseIds[i] + j], 0);
+                    owner[baseIds[i] + j] = 1;
+                }
+            }
+        }
+    }
+    const auto duration = std::chrono::high_resolution_clock::now() - startTime;
+    RecordProperty("Milliseconds", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
+    RecordProperty("FreeRanges", static_cast<int>(allocator.GetStats().FreeRanges));
+
+    for (size_t i = 0; i < REPOSITORY_SIZE; i++)
+    {
+        if (baseIds[i] != ImageIdAllocator::INVALID_ID)
+        {
+            ASSERT_TRUE(allocator.Free(baseIds[i], imageCounts[i]));
+        }
+    }
+    auto stats = allocator.GetStats();
+    ASSERT_EQ(stats.Allocated, 0u);
+    ASSERT_EQ(stats.FreeRanges, 1u);
+    ASSERT_EQ(stats.LargestFreeRange, CAPACITY);
+}
@@ -9,7 +9,10 @@
 
 #include "TestData.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/core/Imaging.h>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/drawing/ImageImporter.h>
 #include <string_view>
@@ -56,3 +59,44 @@ TEST_F(ImageImporterTests, Import_Logo)
     auto hash = GetHash(result.Buffer.data(), result.Buffer.size());
     ASSERT_EQ(0xCEF27C7D, hash);
 }
+
+TEST_F(ImageImporterTests, PngFileWriter_RowsMatchWholeImage)
+{
+    constexpr uint32_t width = 37;
+    constexpr uint32_t height = 53;
+
+    Image header;
+    header.Width = width;
+    header.Height = height;
+    header.Depth = 8;
+    header.Stride = width;
+    header.Palette = std::make_unique<GamePalette>();
+
+    std::vector<uint8_t> pixels(width * height);
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        pixels[i] = static_cast<uint8_t>((i * 7) ^ (i >> 5));
+    }
+
+    // Write the image in uneven bands, as the giant screenshot does
+    auto path = (fs::temp_directory_path() / "openrct2_pngfilewriter_test.png").string();
+    {
+        Imaging::PngFileWriter writer(path, header);
+        uint32_t y = 0;
+        for (uint32_t numRows : { 1u, 16u, 30u, 6u })
+        {
+            writer.WriteRows(pixels.data() + y * width, numRows, width);
+            y += numRows;
+        }
+        ASSERT_EQ(height, y);
+        writer.Finish();
+    }
+
+    auto image = Imaging::ReadFromFile(path, IMAGE_FORMAT::PNG);
+    fs::remove(path);
+
+    ASSERT_EQ(width, image.Width);
+    ASSERT_EQ(height, image.Height);
+    ASSERT_EQ(8u, image.Depth);
+    ASSERT_TRUE(std::equal(pixels.begin(), pixels.end(), image.Pixels.begin()));
+}
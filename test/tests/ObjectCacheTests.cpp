@@ -0,0 +1,133 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TemporaryEnvironment.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/core/Path.hpp>
+#include <openrct2/core/String.hpp>
+#include <openrct2/object/ObjectCache.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class ObjectCacheTests : public TemporaryEnvironmentTest
+{
+protected:
+    ObjectCacheTests()
+        : TemporaryEnvironmentTest("openrct2_objectcache_test")
+    {
+    }
+
+    std::string GetEntryPath(uint64_t key)
+    {
+        return Path::Combine(
+            _env->GetDirectoryPath(DIRBASE::CACHE), "objcache", String::StdFormat("%016" PRIx64 ".bin", key));
+    }
+
+    static std::vector<uint8_t> CreateData(size_t length, uint8_t seed)
+    {
+        std::vector<uint8_t> data(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            data[i] = static_cast<uint8_t>(seed + i * 7);
+        }
+        return data;
+    }
+
+    void ModifyEntry(uint64_t key, size_t offset, uint8_t value)
+    {
+        auto path = GetEntryPath(key);
+        auto entry = File::ReadAllBytes(path);
+        ASSERT_LT(offset, entry.size());
+        entry[offset] = value;
+        File::WriteAllBytes(path, entry.data(), entry.size());
+    }
+};
+
+TEST_F(ObjectCacheTests, Read_Written_ReturnsData)
+{
+    auto data = CreateData(1000, 3);
+    ObjectCache::Write(12, data.data(), data.size());
+
+    auto entry = ObjectCache::Read(12);
+    ASSERT_NE(nullptr, entry);
+    ASSERT_EQ(data, std::vector<uint8_t>(entry->GetData(), entry->GetData() + entry->GetLength()));
+}
+
+TEST_F(ObjectCacheTests, Read_Missing_ReturnsNull)
+{
+    ASSERT_EQ(nullptr, ObjectCache::Read(12));
+}
+
+TEST_F(ObjectCacheTests, Read_Corrupt_ReturnsNull)
+{
+    auto data = CreateData(1000, 3);
+    ObjectCache::Write(12, data.data(), data.size());
+
+    auto entrySize = File::ReadAllBytes(GetEntryPath(12)).size();
+    ModifyEntry(12, entrySize - 1, data.back() ^ 0xFF);
+    ASSERT_EQ(nullptr, ObjectCache::Read(12));
+}
+
+TEST_F(ObjectCacheTests, Read_Truncated_ReturnsNull)
+{
+    auto data = CreateData(1000, 3);
+    ObjectCache::Write(12, data.data(), data.size());
+
+    auto path = GetEntryPath(12);
+    auto entry = File::ReadAllBytes(path);
+    File::WriteAllBytes(path, entry.data(), entry.size() / 2);
+    ASSERT_EQ(nullptr, ObjectCache::Read(12));
+
+    File::WriteAllBytes(path, entry.data(), 4);
+    ASSERT_EQ(nullptr, ObjectCache::Read(12));
+}
+
+TEST_F(ObjectCacheTests, Read_DifferentVersion_ReturnsNull)
+{
+    auto data = CreateData(1000, 3);
+    ObjectCache::Write(12, data.data(), data.size());
+
+    // The version follows the 32-bit magic number
+    auto version = File::ReadAllBytes(GetEntryPath(12))[4];
+    ModifyEntry(12, 4, version + 1);
+    ASSERT_EQ(nullptr, ObjectCache::Read(12));
+}
+
+TEST_F(ObjectCacheTests, Prune_OverSize_DeletesLeastRecentlyUsedEntries)
+{
+    auto data = CreateData(1000, 3);
+    auto now = fs::file_time_type::clock::now();
+    for (uint64_t key = 1; key <= 4; key++)
+    {
+        ObjectCache::Write(key, data.data(), data.size());
+        fs::last_write_time(GetEntryPath(key), now - std::chrono::hours(10 - key));
+    }
+    auto entrySize = File::ReadAllBytes(GetEntryPath(1)).size();
+
+    ObjectCache::Prune(entrySize * 4);
+    for (uint64_t key = 1; key <= 4; key++)
+    {
+        ASSERT_TRUE(File::Exists(GetEntryPath(key)));
+    }
+
+    // Reading the oldest entry makes it the most recently used one
+    ASSERT_NE(nullptr, ObjectCache::Read(1));
+    ObjectCache::Prune(entrySize * 2 + 1);
+    ASSERT_TRUE(File::Exists(GetEntryPath(1)));
+    ASSERT_FALSE(File::Exists(GetEntryPath(2)));
+    ASSERT_FALSE(File::Exists(GetEntryPath(3)));
+    ASSERT_TRUE(File::Exists(GetEntryPath(4)));
+}
@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TemporaryEnvironment.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/Path.hpp>
+#include <openrct2/object/ObjectRepository.h>
+#include <string>
+
+using namespace OpenRCT2;
+
+class ObjectRepositoryTests : public TemporaryEnvironmentTest
+{
+protected:
+    ObjectRepositoryTests()
+        : TemporaryEnvironmentTest("openrct2_objectrepository_test")
+    {
+    }
+
+    void WriteObject(const std::string& id, const std::string& originalName)
+    {
+        auto path = Path::Combine(_env->GetDirectoryPath(DIRBASE::USER, DIRID::OBJECT), id + ".json");
+        auto json = "{\"id\": \"" + id + "\", \"originalId\": \"00000009|" + originalName + "|00000000\", "
+            + "\"objectType\": \"water\", \"sourceGame\": \"custom\", \"strings\": {\"name\": {\"en-GB\": \"" + id
+            + "\"}}}";
+        File::WriteAllBytes(path, json.data(), json.size());
+    }
+
+    // A directory where the index is written to first makes every write of the index fail
+    void MakeIndexUnwritable()
+    {
+        Path::CreateDirectory(_env->GetFilePath(PATHID::CACHE_OBJECTS) + ".tmp");
+    }
+};
+
+TEST_F(ObjectRepositoryTests, LoadOrConstruct_IndexUnwritable_FindsNewObjects)
+{
+    WriteObject("test.water.a", "TSTWATA ");
+    auto repository = CreateObjectRepository(_env);
+    repository->Construct(0);
+    ASSERT_EQ(1u, repository->GetNumObjects());
+
+    WriteObject("test.water.b", "TSTWATB ");
+    MakeIndexUnwritable();
+    repository->LoadOrConstruct(0);
+    ASSERT_EQ(2u, repository->GetNumObjects());
+    ASSERT_NE(nullptr, repository->FindObject("TSTWATA "));
+    ASSERT_NE(nullptr, repository->FindObject("TSTWATB "));
+}
+
+TEST_F(ObjectRepositoryTests, Construct_IndexUnwritable_FindsNewObjects)
+{
+    WriteObject("test.water.a", "TSTWATA ");
+    auto repository = CreateObjectRepository(_env);
+    repository->Construct(0);
+    ASSERT_EQ(1u, repository->GetNumObjects());
+
+    WriteObject("test.water.b", "TSTWATB ");
+    MakeIndexUnwritable();
+    repository->Construct(0);
+    ASSERT_EQ(2u, repository->GetNumObjects());
+    ASSERT_NE(nullptr, repository->FindObject("TSTWATA "));
+    ASSERT_NE(nullptr, repository->FindObject("TSTWATB "));
+}
+
+TEST_F(ObjectRepositoryTests, LoadOrConstruct_IndexMapped_FindsObjectsByName)
+{
+    WriteObject("test.water.a", "TSTWATA ");
+    WriteObject("test.water.b", "TSTWATB ");
+    CreateObjectRepository(_env)->Construct(0);
+
+    // The index is up to date now, so it is mapped rather than scanned
+    auto repository = CreateObjectRepository(_env);
+    repository->LoadOrConstruct(0);
+    ASSERT_EQ(2u, repository->GetNumObjects());
+    auto object = repository->FindObject("TSTWATB ");
+    ASSERT_NE(nullptr, object);
+    ASSERT_EQ("test.water.b", object->Name);
+    ASSERT_EQ(nullptr, repository->FindObject("TSTWATC "));
+}
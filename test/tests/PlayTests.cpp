@@ -193,3 +193,39 @@ TEST_F(PlayTests, CarRideWithOneCarOnlyAcceptsTwoGuests)
         gs->UpdateLogic();
     }
 }
+
+TEST_F(PlayTests, ParkStatisticsMatchFullRecalculation)
+{
+    // This test verifies that the incrementally maintained park statistics stay in sync with a full recount
+    // while guests walk around, litter is dropped and the park changes state.
+    std::string initStateFile = TestData::GetParkPath("small_park_with_ferris_wheel.sv6");
+
+    auto context = localStartGame(initStateFile);
+    ASSERT_NE(context.get(), nullptr);
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    execute<ParkSetParameterAction>(ParkParameter::Open);
+
+    for (int i = 0; i < 25; i++)
+    {
+        gs->GetPark().GenerateGuest();
+    }
+
+    for (int i = 0; i < 2000; i++)
+    {
+        gs->UpdateLogic();
+        if (i % 100 == 0)
+        {
+            ASSERT_TRUE(park_statistics_verify());
+        }
+    }
+
+    execute<ParkSetParameterAction>(ParkParameter::Close);
+    for (int i = 0; i < 500; i++)
+    {
+        gs->UpdateLogic();
+    }
+    ASSERT_TRUE(park_statistics_verify());
+}
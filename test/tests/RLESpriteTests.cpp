@@ -0,0 +1,203 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/core/JobPool.hpp>
+#include <openrct2/drawing/Drawing.h>
+#include <vector>
+
+class RLESpriteTests : public testing::Test
+{
+protected:
+    // Wide enough for opaque runs that have to be split at the maximum run length
+    static constexpr int32_t WIDTH = 200;
+    static constexpr int32_t HEIGHT = 45;
+    static constexpr uint16_t TRANSPARENT = 0x100;
+
+    std::vector<uint16_t> _pixels;
+    std::vector<uint8_t> _data;
+    rct_g1_element _g1{};
+
+    void SetUp() override
+    {
+        _pixels = CreatePixels(0);
+        _data = Encode(_pixels);
+        _g1.offset = _data.data();
+        _g1.width = WIDTH;
+        _g1.height = HEIGHT;
+        _g1.flags = G1_FLAG_RLE_COMPRESSION;
+    }
+
+    void TearDown() override
+    {
+        // The data of the next image may be allocated at the same address
+        gfx_rle_mip_cache_invalidate(_data.data());
+    }
+
+    static std::vector<uint16_t> CreatePixels(uint8_t seed)
+    {
+        std::vector<uint16_t> pixels(WIDTH * HEIGHT);
+        for (int32_t y = 0; y < HEIGHT; y++)
+        {
+            for (int32_t x = 0; x < WIDTH; x++)
+            {
+                // Every fifth line is opaque, the others have gaps of varying length
+                bool transparent = y % 5 != 0 && (x * 7 + y * 3) % 23 < 2 + y % 4;
+                pixels[y * WIDTH + x] = transparent ? TRANSPARENT : static_cast<uint8_t>(1 + (x * 31 + y * 17 + seed) % 250);
+            }
+        }
+        return pixels;
+    }
+
+    static std::vector<uint8_t> Encode(const std::vector<uint16_t>& pixels)
+    {
+        std::vector<uint8_t> data(HEIGHT * 2);
+        for (int32_t y = 0; y < HEIGHT; y++)
+        {
+            data[y * 2] = static_cast<uint8_t>(data.size());
+            data[y * 2 + 1] = static_cast<uint8_t>(data.size() >> 8);
+
+            size_t lastRunHeader = SIZE_MAX;
+            int32_t x = 0;
+            while (x < WIDTH)
+            {
+                if (pixels[y * WIDTH + x] == TRANSPARENT)
+                {
+                    x++;
+                    continue;
+                }
+
+                lastRunHeader = data.size();
+                data.push_back(0);
+                data.push_back(static_cast<uint8_t>(x));
+                while (x < WIDTH && data[lastRunHeader] < 0x7F && pixels[y * WIDTH + x] != TRANSPARENT)
+                {
+                    data.push_back(static_cast<uint8_t>(pixels[y * WIDTH + x]));
+                    data[lastRunHeader]++;
+                    x++;
+                }
+            }
+
+            if (lastRunHeader == SIZE_MAX)
+            {
+                data.push_back(0x80);
+                data.push_back(0);
+            }
+            else
+            {
+                data[lastRunHeader] |= 0x80;
+            }
+        }
+        return data;
+    }
+
+    /**
+     * Changes the colours of the image without moving its data, like an image that is replaced in place.
+     */
+    void ChangeColours(uint8_t seed)
+    {
+        _pixels = CreatePixels(seed);
+        auto data = Encode(_pixels);
+        ASSERT_EQ(data.size(), _data.size());
+        std::copy(data.begin(), data.end(), _data.begin());
+    }
+
+    /**
+     * Draws the given part of the image at the zoom level, leaving 0 where nothing is drawn.
+     */
+    std::vector<uint8_t> Draw(int32_t zoom, int32_t srcX, int32_t srcY, int32_t width, int32_t height) const
+    {
+        const int32_t zoomAmount = 1 << zoom;
+        const int32_t drawnWidth = (width + zoomAmount - 1) >> zoom;
+        const int32_t drawnHeight = (height + zoomAmount - 1) >> zoom;
+        std::vector<uint8_t> bits(drawnWidth * drawnHeight);
+
+        rct_drawpixelinfo dpi{};
+        dpi.bits = bits.data();
+        dpi.width = drawnWidth << zoom;
+        dpi.height = drawnHeight << zoom;
+        dpi.zoom_level = zoom;
+        DrawSpriteArgs args(&dpi, ImageId(0), PaletteMap::GetDefault(), _g1, srcX, srcY, width, height, bits.data());
+        gfx_rle_sprite_to_buffer(args);
+        return bits;
+    }
+
+    /**
+     * Samples every (2^zoom)th column and line of the given part of the image, which is what drawing it at the zoom
+     * level has to produce.
+     */
+    std::vector<uint8_t> Sample(int32_t zoom, int32_t srcX, int32_t srcY, int32_t width, int32_t height) const
+    {
+        const int32_t zoomAmount = 1 << zoom;
+        const int32_t drawnWidth = (width + zoomAmount - 1) >> zoom;
+        const int32_t drawnHeight = (height + zoomAmount - 1) >> zoom;
+        std::vector<uint8_t> bits(drawnWidth * drawnHeight);
+        for (int32_t y = 0; y < drawnHeight; y++)
+        {
+            for (int32_t x = 0; x < drawnWidth; x++)
+            {
+                auto pixel = _pixels[(srcY + (y << zoom)) * WIDTH + srcX + (x << zoom)];
+                if (pixel != TRANSPARENT)
+                {
+                    bits[y * drawnWidth + x] = static_cast<uint8_t>(pixel);
+                }
+            }
+        }
+        return bits;
+    }
+};
+
+TEST_F(RLESpriteTests, Draw_Zoomed_MatchesSampledImage)
+{
+    for (int32_t zoom = 1; zoom <= 3; zoom++)
+    {
+        for (int32_t srcX : { 0, 1, 2, 3, 5, 130 })
+        {
+            for (int32_t srcY : { 0, 1, 3, 6 })
+            {
+                for (int32_t width : { WIDTH - srcX, 37 })
+                {
+                    SCOPED_TRACE(testing::Message() << "zoom " << zoom << ", x " << srcX << ", y " << srcY << ", w " << width);
+                    ASSERT_EQ(Sample(zoom, srcX, srcY, width, HEIGHT - srcY), Draw(zoom, srcX, srcY, width, HEIGHT - srcY));
+                }
+            }
+        }
+    }
+}
+
+TEST_F(RLESpriteTests, Draw_AfterInvalidate_MatchesChangedImage)
+{
+    ASSERT_EQ(Sample(2, 1, 0, WIDTH - 1, HEIGHT), Draw(2, 1, 0, WIDTH - 1, HEIGHT));
+
+    ChangeColours(5);
+    gfx_rle_mip_cache_invalidate(_data.data());
+    ASSERT_EQ(Sample(2, 1, 0, WIDTH - 1, HEIGHT), Draw(2, 1, 0, WIDTH - 1, HEIGHT));
+}
+
+TEST_F(RLESpriteTests, Draw_OnOtherThreadAfterInvalidate_MatchesChangedImage)
+{
+    // Every drawing thread keeps its own copies, the invalidation has to reach the worker
+    JobPool jobs(1);
+    std::vector<uint8_t> drawn;
+    auto draw = [this, &jobs, &drawn]() {
+        jobs.AddTask([this, &drawn]() { drawn = Draw(3, 2, 1, WIDTH - 2, HEIGHT - 1); });
+        jobs.Join();
+        return drawn;
+    };
+    ASSERT_EQ(Sample(3, 2, 1, WIDTH - 2, HEIGHT - 1), draw());
+
+    ChangeColours(9);
+    gfx_rle_mip_cache_invalidate(_data.data());
+    ASSERT_EQ(Sample(3, 2, 1, WIDTH - 2, HEIGHT - 1), draw());
+
+    ChangeColours(13);
+    gfx_rle_mip_cache_clear();
+    ASSERT_EQ(Sample(3, 2, 1, WIDTH - 2, HEIGHT - 1), draw());
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TemporaryEnvironment.h"
+
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/audio/AudioContext.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/core/Path.hpp>
+#include <openrct2/ui/UiContext.h>
+
+using namespace OpenRCT2;
+
+TemporaryEnvironmentTest::TemporaryEnvironmentTest(std::string name)
+    : _name(std::move(name))
+{
+}
+
+void TemporaryEnvironmentTest::SetUp()
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    _basePath = (fs::temp_directory_path() / _name).string();
+    fs::remove_all(_basePath);
+
+    DIRBASE_VALUES basePaths;
+    for (auto& basePath : basePaths)
+    {
+        basePath = _basePath;
+    }
+    basePaths[static_cast<size_t>(DIRBASE::OPENRCT2)] = Path::Combine(_basePath, "data");
+    basePaths[static_cast<size_t>(DIRBASE::CACHE)] = Path::Combine(_basePath, "cache");
+    _env = CreatePlatformEnvironment(basePaths);
+    Path::CreateDirectory(_env->GetDirectoryPath(DIRBASE::USER, DIRID::OBJECT));
+    Path::CreateDirectory(_env->GetDirectoryPath(DIRBASE::CACHE));
+
+    _context = CreateContext(_env, Audio::CreateDummyAudioContext(), Ui::CreateDummyUiContext());
+}
+
+void TemporaryEnvironmentTest::TearDown()
+{
+    _context = nullptr;
+    fs::remove_all(_basePath);
+}
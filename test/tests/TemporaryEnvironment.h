@@ -0,0 +1,40 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/PlatformEnvironment.h>
+#include <string>
+
+/**
+ * Test fixture that gives every test a headless context whose directories all lie in a new temporary directory, which
+ * is deleted again after the test.
+ */
+class TemporaryEnvironmentTest : public testing::Test
+{
+private:
+    std::string const _name;
+    std::string _basePath;
+
+protected:
+    std::shared_ptr<OpenRCT2::IPlatformEnvironment> _env;
+    std::unique_ptr<OpenRCT2::IContext> _context;
+
+    /**
+     * @param name Name of the temporary directory, unique to the test executable so that executables can run at the
+     *             same time.
+     */
+    explicit TemporaryEnvironmentTest(std::string name);
+
+    void SetUp() override;
+    void TearDown() override;
+};
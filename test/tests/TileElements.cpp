@@ -14,9 +14,12 @@
 #include <openrct2/Game.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
+#include <openrct2/config/Config.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
 
+#include <vector>
+
 using namespace OpenRCT2;
 
 class TileElementWantsFootpathConnection : public testing::Test
@@ -140,3 +143,59 @@ TEST_F(TileElementWantsFootpathConnection, DifferentHeight)
     EXPECT_FALSE(tile_element_wants_path_connection_towards({ 18, 10, 24, 1 }, nullptr));
     SUCCEED();
 }
+
+static std::vector<TileElement*> GetAllPathElements()
+{
+    std::vector<TileElement*> result;
+    tile_element_iterator it;
+    tile_element_iterator_begin(&it);
+    do
+    {
+        if (it.element->GetType() == TILE_ELEMENT_TYPE_PATH)
+        {
+            result.push_back(it.element);
+        }
+    } while (tile_element_iterator_next(&it));
+    return result;
+}
+
+static std::vector<bool> GetWideFlags(const std::vector<TileElement*>& paths)
+{
+    std::vector<bool> result;
+    for (auto path : paths)
+    {
+        result.push_back(path->AsPath()->IsWide());
+    }
+    return result;
+}
+
+static void SetWideFlags(const std::vector<TileElement*>& paths, const std::vector<bool>& flags)
+{
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        paths[i]->AsPath()->SetWide(flags[i]);
+    }
+}
+
+TEST_F(TileElementWantsFootpathConnection, PathWideFlagsRangeUpdateMatchesSequentialUpdate)
+{
+    // Recomputing the wide flags on worker threads must give the same result as visiting the tiles in order
+    auto paths = GetAllPathElements();
+    ASSERT_FALSE(paths.empty());
+    auto initialFlags = GetWideFlags(paths);
+    auto wholeMap = MapRange(0, 0, MAXIMUM_TILE_START_XY, MAXIMUM_TILE_START_XY);
+    bool multithreading = gConfigGeneral.multithreading;
+
+    gConfigGeneral.multithreading = false;
+    footpath_update_path_wide_flags_range(wholeMap);
+    auto sequentialFlags = GetWideFlags(paths);
+
+    SetWideFlags(paths, initialFlags);
+    gConfigGeneral.multithreading = true;
+    footpath_update_path_wide_flags_range(wholeMap);
+    auto parallelFlags = GetWideFlags(paths);
+
+    gConfigGeneral.multithreading = multithreading;
+    SetWideFlags(paths, initialFlags);
+    EXPECT_EQ(sequentialFlags, parallelFlags);
+}
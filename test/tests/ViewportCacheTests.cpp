@@ -0,0 +1,104 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <array>
+#include <gtest/gtest.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/interface/ViewportCache.h>
+#include <openrct2/world/SpriteBase.h>
+#include <vector>
+
+using Area = std::array<int32_t, 4>;
+
+class ViewportCacheTests : public testing::Test
+{
+protected:
+    rct_viewport* _viewport = &g_viewport_list[0];
+    ViewportCache* _cache = nullptr;
+
+    void SetUp() override
+    {
+        // 4 by 3 blocks, each covering 256 by 256 map pixels at this zoom
+        *_viewport = {};
+        _viewport->width = 256;
+        _viewport->height = 192;
+        _viewport->view_width = 256 * 4;
+        _viewport->view_height = 192 * 4;
+        _viewport->zoom = 2;
+        _viewport->visibility = VC_COVERED;
+
+        _cache = viewport_cache_get(_viewport);
+        ASSERT_NE(nullptr, _cache);
+        _cache->Reset(_viewport, { 0, 0 });
+        ASSERT_EQ(std::vector<Area>({ { 0, 0, 256, 192 } }), CollectInvalid());
+        ASSERT_TRUE(CollectInvalid().empty());
+    }
+
+    void TearDown() override
+    {
+        *_cache = {};
+        *_viewport = {};
+    }
+
+    /**
+     * Gets the areas of the whole cache that would be painted, which marks them valid.
+     */
+    std::vector<Area> CollectInvalid()
+    {
+        std::vector<ScreenRect> rects;
+        _cache->CollectInvalid(0, 0, _cache->Width, _cache->Height, rects);
+
+        std::vector<Area> areas;
+        for (const auto& rect : rects)
+        {
+            areas.push_back({ rect.GetLeft(), rect.GetTop(), rect.GetRight(), rect.GetBottom() });
+        }
+        return areas;
+    }
+};
+
+TEST_F(ViewportCacheTests, Invalidate_InsideBlock_InvalidatesBlock)
+{
+    _cache->Invalidate(300, 300, 310, 310);
+    ASSERT_EQ(std::vector<Area>({ { 64, 64, 128, 128 } }), CollectInvalid());
+}
+
+TEST_F(ViewportCacheTests, Invalidate_AcrossBlocks_InvalidatesEveryTouchedBlock)
+{
+    _cache->Invalidate(250, 10, 260, 20);
+    ASSERT_EQ(std::vector<Area>({ { 0, 0, 128, 64 } }), CollectInvalid());
+}
+
+TEST_F(ViewportCacheTests, Invalidate_OutsideView_InvalidatesNothing)
+{
+    _cache->Invalidate(2000, 300, 2100, 400);
+    ASSERT_TRUE(CollectInvalid().empty());
+}
+
+TEST_F(ViewportCacheTests, Scroll_ByBlock_InvalidatesUncoveredBlocks)
+{
+    _cache->Scroll({ 256, 0 });
+    ASSERT_EQ(std::vector<Area>({ { 192, 0, 256, 192 } }), CollectInvalid());
+}
+
+TEST_F(ViewportCacheTests, SpriteInvalidate_ZoomedOut_InvalidatesCache)
+{
+    // Sprites that only invalidate the screen at lower zoom levels must still invalidate the cache
+    SpriteBase sprite{};
+    sprite.sprite_left = 300;
+    sprite.sprite_top = 300;
+    sprite.sprite_right = 310;
+    sprite.sprite_bottom = 310;
+
+    sprite.Invalidate0();
+    ASSERT_EQ(std::vector<Area>({ { 64, 64, 128, 128 } }), CollectInvalid());
+
+    sprite.Invalidate1();
+    ASSERT_EQ(std::vector<Area>({ { 64, 64, 128, 128 } }), CollectInvalid());
+}
@@ -8,12 +8,18 @@
  *****************************************************************************/
 
 #include <gtest/gtest.h>
+#include <openrct2/core/FileStream.hpp>
+#include <openrct2/core/FileSystem.hpp>
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/rct12/SawyerChunkReader.h>
 #include <openrct2/util/SawyerCoding.h>
+#include <vector>
 
 constexpr size_t BUFFER_SIZE = 0x600000;
 
+// The size of the blocks in which chunks are read from streams that are not held in memory
+constexpr size_t STREAM_BLOCK_SIZE = 64 * 1024;
+
 class SawyerCodingTest : public testing::Test
 {
 protected:
@@ -59,6 +65,28 @@ protected:
         auto result = memcmp(chunk->GetData(), randomdata, sizeof(randomdata));
         ASSERT_EQ(result, 0);
     }
+
+    void test_decode_into(const uint8_t* data, size_t size, size_t length)
+    {
+        // Guard the end of the destination to check nothing is written past it
+        std::vector<uint8_t> buffer(length + 16, 0xCD);
+
+        MemoryStream ms(data, size);
+        SawyerChunkReader reader(&ms);
+        reader.ReadChunk(buffer.data(), length);
+        ASSERT_EQ(ms.GetPosition(), size);
+
+        auto copiedLength = std::min(length, sizeof(randomdata));
+        ASSERT_EQ(memcmp(buffer.data(), randomdata, copiedLength), 0);
+        for (size_t i = copiedLength; i < length; i++)
+        {
+            ASSERT_EQ(buffer[i], 0x00);
+        }
+        for (size_t i = length; i < buffer.size(); i++)
+        {
+            ASSERT_EQ(buffer[i], 0xCD);
+        }
+    }
 };
 
 TEST_F(SawyerCodingTest, write_read_chunk_none)
@@ -106,6 +134,131 @@ TEST_F(SawyerCodingTest, decode_chunk_rotate)
     test_decode(rotatedata, sizeof(rotatedata));
 }
 
+TEST_F(SawyerCodingTest, decode_chunk_into_destination)
+{
+    test_decode_into(rlecompresseddata, sizeof(rlecompresseddata), sizeof(randomdata));
+    test_decode_into(rledata, sizeof(rledata), sizeof(randomdata));
+    test_decode_into(rotatedata, sizeof(rotatedata), sizeof(randomdata));
+}
+
+TEST_F(SawyerCodingTest, decode_chunk_into_larger_destination)
+{
+    test_decode_into(rlecompresseddata, sizeof(rlecompresseddata), sizeof(randomdata) + 100);
+    test_decode_into(rledata, sizeof(rledata), sizeof(randomdata) + 100);
+}
+
+TEST_F(SawyerCodingTest, decode_chunk_into_smaller_destination)
+{
+    test_decode_into(rlecompresseddata, sizeof(rlecompresseddata), 500);
+    test_decode_into(rledata, sizeof(rledata), 500);
+    test_decode_into(nonedata, sizeof(nonedata), 1);
+}
+
+TEST_F(SawyerCodingTest, write_read_chunk_rle_compressed_runs)
+{
+    // Long runs and repeats, which the chunk buffer has to grow for
+    std::vector<uint8_t> data(300000);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>((i / 1000) % 3 == 0 ? i % 7 : i / 1000);
+    }
+
+    sawyercoding_chunk_header chdr_in;
+    chdr_in.encoding = CHUNK_ENCODING_RLECOMPRESSED;
+    chdr_in.length = static_cast<uint32_t>(data.size());
+    std::vector<uint8_t> encodedData(BUFFER_SIZE);
+    size_t encodedDataSize = sawyercoding_write_chunk_buffer(encodedData.data(), data.data(), chdr_in);
+    ASSERT_LT(encodedDataSize, data.size());
+
+    MemoryStream ms(encodedData.data(), encodedDataSize);
+    SawyerChunkReader reader(&ms);
+    auto chunk = reader.ReadChunk();
+    ASSERT_EQ(chunk->GetLength(), data.size());
+    ASSERT_EQ(memcmp(chunk->GetData(), data.data(), data.size()), 0);
+
+    std::vector<uint8_t> buffer(data.size());
+    ms.SetPosition(0);
+    reader.ReadChunk(buffer.data(), buffer.size());
+    ASSERT_EQ(buffer, data);
+}
+
+TEST_F(SawyerCodingTest, read_chunk_rle_file_stream_across_blocks)
+{
+    // Encodes by hand, so that codes and literal runs can be placed across the ends of the blocks
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> expected;
+    auto addLiteral = [&](size_t length) {
+        encoded.push_back(static_cast<uint8_t>(length - 1));
+        for (size_t i = 0; i < length; i++)
+        {
+            auto value = static_cast<uint8_t>(encoded.size() * 13);
+            encoded.push_back(value);
+            expected.push_back(value);
+        }
+    };
+    auto addRepeat = [&](uint8_t value, size_t count) {
+        encoded.push_back(static_cast<uint8_t>(257 - count));
+        encoded.push_back(value);
+        expected.insert(expected.end(), count, value);
+    };
+    auto padTo = [&](size_t offset) {
+        // Each literal takes its length and one more byte, never leave a gap of a single byte
+        while (encoded.size() < offset)
+        {
+            auto length = std::min<size_t>(offset - encoded.size(), 129);
+            if (offset - encoded.size() - length == 1)
+            {
+                length--;
+            }
+            addLiteral(length - 1);
+        }
+        ASSERT_EQ(encoded.size(), offset);
+    };
+
+    // A repeat code that ends one block and has its value in the next one
+    padTo(STREAM_BLOCK_SIZE - 1);
+    addRepeat(0x5A, 100);
+    // A literal run that continues in the next block
+    padTo(STREAM_BLOCK_SIZE * 2 - 10);
+    addLiteral(100);
+    // A literal code that ends one block and has all of its run in the next one
+    padTo(STREAM_BLOCK_SIZE * 3 - 1);
+    addLiteral(5);
+    addRepeat(0xA5, 3);
+    ASSERT_GT(encoded.size(), STREAM_BLOCK_SIZE * 3);
+
+    auto path = (fs::temp_directory_path() / "openrct2_sawyercoding_test.dat").u8string();
+    {
+        sawyercoding_chunk_header header{ CHUNK_ENCODING_RLE, static_cast<uint32_t>(encoded.size()) };
+        FileStream fs(path, FILE_MODE_WRITE);
+        fs.WriteValue(header);
+        fs.Write(encoded.data(), encoded.size());
+    }
+
+    {
+        FileStream fs(path, FILE_MODE_OPEN);
+        SawyerChunkReader reader(&fs);
+        auto chunk = reader.ReadChunk();
+        ASSERT_EQ(fs.GetPosition(), fs.GetLength());
+        ASSERT_EQ(chunk->GetLength(), expected.size());
+        ASSERT_EQ(memcmp(chunk->GetData(), expected.data(), expected.size()), 0);
+
+        std::vector<uint8_t> buffer(expected.size());
+        fs.SetPosition(0);
+        reader.ReadChunk(buffer.data(), buffer.size());
+        ASSERT_EQ(buffer, expected);
+    }
+    fs::remove(fs::u8path(path));
+}
+
+TEST_F(SawyerCodingTest, decode_chunk_truncated)
+{
+    MemoryStream ms(rlecompresseddata, sizeof(rlecompresseddata) - 1);
+    SawyerChunkReader reader(&ms);
+    ASSERT_THROW(reader.ReadChunk(), IOException);
+    ASSERT_EQ(ms.GetPosition(), 0);
+}
+
 // 1024 bytes of random data
 // use `dd if=/dev/urandom bs=1024 count=1 | xxd -i` to get your own
 const uint8_t SawyerCodingTest::randomdata[] = {